@@ -151,6 +151,15 @@ u32 interrupts_getPrivateTimerTicksPerSecond();
 void interrupts_enableTimerGlobalInts();
 void interrupts_disableTimerGlobalInts();
 
+// Reads the (simulated) private counter on the Arm core.
+u32 interrupts_getPrivateTimerCounterValue(void);
+
+// Used to determine the input mode for the ADC.
+bool interrupts_getAdcInputMode();
+
+// Use this to read the latest ADC conversion.
+uint32_t interrupts_getAdcData();
+
 void isr_function();
 
 extern volatile int interrupts_isrFlagGlobal;
@@ -3,20 +3,23 @@
 
 #include <stdbool.h>
 
-// The auto-reload timer is always looking at the remaining shot-count from the
-// trigger state-machine. When it goes to 0, it starts a configurable delay and
-// after the delay expires, it sets the remaining shots to a specific value.
+// The trigger state-machine starts the auto-reload timer when the remaining
+// shot-count goes to 0. The timer then locks out the trigger for a
+// configurable delay and, after the delay expires, sets the remaining shots to
+// a specific value.
 
 // Default, Defined in terms of 100 kHz ticks.
 #define AUTO_RELOAD_EXPIRE_VALUE 300000
 
 #define AUTO_RELOAD_SHOT_VALUE 10 // Default
 
-// Need to init things.
+// Need to init things. Registers the timer with the timer service (see
+// timerService.h), which reloads the gun from the ISR.
 void autoReloadTimer_init();
 
-// Standard tick function.
-void autoReloadTimer_tick();
+// Disables the trigger and starts the reload delay. The trigger calls this
+// when the last shot is fired.
+void autoReloadTimer_start();
 
 // Calling this starts the timer.
 void autoReloadTimer_quick();
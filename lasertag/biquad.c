@@ -0,0 +1,246 @@
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include "biquad.h"
+
+#define BIQUAD_MAX_ORDER 32
+#define ROOT_MAX_ITERATIONS 200
+#define ROOT_CONVERGED_STEP 1.0E-14 // Relative size of the last Aberth step.
+// Clustered roots can only be found to roughly sqrt(machine epsilon); once the
+// steps stall they are as good as double precision allows.
+#define ROOT_ACCEPTED_STEP 1.0E-6
+#define REAL_ROOT_TOLERANCE 1.0E-9  // Roots with |imag| below this are real.
+#define UNIT_ROOT_TOLERANCE 1.0E-9  // Relative remainder when deflating +/-1.
+#define SCALING_GRID_POINT_COUNT 1024
+#define PI 3.14159265358979323846
+
+// Evaluates the monic polynomial z^degree + coeff[1]*z^(degree-1) + ... and
+// its derivative at z using Horner's rule.
+static void evaluate(const double coeff[], uint32_t degree, double complex z,
+                     double complex *value, double complex *derivative) {
+    double complex p = coeff[0];
+    double complex dp = 0.0;
+    for (uint32_t i = 1; i <= degree; i++) {
+        dp = dp * z + p;
+        p = p * z + coeff[i];
+    }
+    *value = p;
+    *derivative = dp;
+}
+
+// Finds all roots of a monic polynomial with the Aberth-Ehrlich method, which
+// finds every root at once and copes well with the clustered poles of
+// narrow bandpass filters.
+static bool findRoots(const double coeff[], uint32_t degree,
+                      double complex roots[]) {
+    // Start on a circle with the geometric-mean radius of the roots.
+    double radius = pow(fabs(coeff[degree]), 1.0 / degree);
+    if (radius == 0.0)
+        radius = 1.0;
+    for (uint32_t k = 0; k < degree; k++)
+        roots[k] = radius * cexp(I * (2.0 * PI * k + 0.5) / degree);
+
+    double maxStep = 0.0;
+    for (uint32_t iteration = 0; iteration < ROOT_MAX_ITERATIONS; iteration++) {
+        maxStep = 0.0;
+        for (uint32_t k = 0; k < degree; k++) {
+            double complex value, derivative;
+            evaluate(coeff, degree, roots[k], &value, &derivative);
+            if (value == 0.0)
+                continue;
+            double complex ratio = value / derivative;
+            double complex repulsion = 0.0;
+            for (uint32_t j = 0; j < degree; j++) {
+                if (j != k)
+                    repulsion += 1.0 / (roots[k] - roots[j]);
+            }
+            double complex step = ratio / (1.0 - ratio * repulsion);
+            roots[k] -= step;
+            double stepSize = cabs(step) / fmax(cabs(roots[k]), 1.0);
+            if (stepSize > maxStep)
+                maxStep = stepSize;
+        }
+        if (maxStep < ROOT_CONVERGED_STEP)
+            break;
+    }
+    return maxStep < ROOT_ACCEPTED_STEP;
+}
+
+// Divides the monic polynomial by (z - root) if root is one of its roots.
+static bool deflate(double coeff[], uint32_t *degree, double root) {
+    double scale = 0.0;
+    for (uint32_t i = 0; i <= *degree; i++)
+        scale += fabs(coeff[i]);
+    double quotient[BIQUAD_MAX_ORDER + 1];
+    quotient[0] = coeff[0];
+    for (uint32_t i = 1; i <= *degree; i++)
+        quotient[i] = coeff[i] + root * quotient[i - 1];
+    if (fabs(quotient[*degree]) > UNIT_ROOT_TOLERANCE * scale)
+        return false;
+    for (uint32_t i = 0; i < *degree; i++)
+        coeff[i] = quotient[i];
+    (*degree)--;
+    return true;
+}
+
+// Groups roots into real quadratic factors: complex roots with their
+// conjugates, real roots with their neighbor after sorting. Returns the number
+// of factors written.
+static uint32_t pairRoots(const double complex roots[], uint32_t count,
+                          biquad_factor_t factors[]) {
+    double realRoots[BIQUAD_MAX_ORDER];
+    uint32_t realCount = 0;
+    uint32_t factorCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (fabs(cimag(roots[i])) < REAL_ROOT_TOLERANCE) {
+            realRoots[realCount++] = creal(roots[i]);
+        } else if (cimag(roots[i]) > 0.0) {
+            // The conjugate (negative imaginary part) is covered here.
+            factors[factorCount].c1 = -2.0 * creal(roots[i]);
+            factors[factorCount].c2 = creal(roots[i] * conj(roots[i]));
+            factorCount++;
+        }
+    }
+    // Insertion sort of the real roots.
+    for (uint32_t i = 1; i < realCount; i++) {
+        double value = realRoots[i];
+        int32_t j = i - 1;
+        for (; j >= 0 && realRoots[j] > value; j--)
+            realRoots[j + 1] = realRoots[j];
+        realRoots[j + 1] = value;
+    }
+    for (uint32_t i = 0; i < realCount; i += 2) {
+        double r1 = realRoots[i];
+        double r2 = (i + 1 < realCount) ? realRoots[i + 1] : 0.0;
+        factors[factorCount].c1 = -(r1 + r2);
+        factors[factorCount].c2 = r1 * r2;
+        factorCount++;
+    }
+    return factorCount;
+}
+
+// Returns |H(e^jw)| for a single section.
+static double sectionMagnitude(const biquad_section_t *s, double w) {
+    double complex z1 = cexp(-I * w);
+    double complex z2 = z1 * z1;
+    return cabs((s->b0 + s->b1 * z1 + s->b2 * z2) /
+                (1.0 + s->a1 * z1 + s->a2 * z2));
+}
+
+// Factors a direct-form filter into biquads. See biquad.h.
+bool biquad_fromDirectForm(const double b[], const double a[], uint32_t order,
+                           biquad_section_t sections[]) {
+    if (order == 0 || order > BIQUAD_MAX_ORDER || b[0] == 0.0)
+        return false;
+    uint32_t sectionCount = (order + 1) / 2;
+
+    // Poles: roots of z^order + a[0]*z^(order-1) + ... + a[order-1].
+    double denominator[BIQUAD_MAX_ORDER + 1];
+    denominator[0] = 1.0;
+    for (uint32_t i = 0; i < order; i++)
+        denominator[i + 1] = a[i];
+    double complex poles[BIQUAD_MAX_ORDER];
+    if (!findRoots(denominator, order, poles))
+        return false;
+    biquad_factor_t poleFactors[BIQUAD_MAX_ORDER];
+    uint32_t poleFactorCount = pairRoots(poles, order, poleFactors);
+
+    // Zeros: normalize by the gain b[0]. Bilinear-transform designs put all of
+    // their zeros exactly at z = 1 and z = -1 with high multiplicity, which
+    // root finders resolve poorly, so divide those out exactly first.
+    double numerator[BIQUAD_MAX_ORDER + 1];
+    for (uint32_t i = 0; i <= order; i++)
+        numerator[i] = b[i] / b[0];
+    uint32_t degree = order;
+    uint32_t plusOneCount = 0;
+    uint32_t minusOneCount = 0;
+    while (degree > 0 && deflate(numerator, &degree, 1.0))
+        plusOneCount++;
+    while (degree > 0 && deflate(numerator, &degree, -1.0))
+        minusOneCount++;
+    double complex zeros[BIQUAD_MAX_ORDER];
+    if (degree > 0 && !findRoots(numerator, degree, zeros))
+        return false;
+    biquad_factor_t zeroFactors[BIQUAD_MAX_ORDER];
+    uint32_t zeroFactorCount = 0;
+    // Pair +1 with -1 first: (1 - z^-2) is the natural bandpass section.
+    for (; plusOneCount > 0 && minusOneCount > 0; plusOneCount--, minusOneCount--)
+        zeroFactors[zeroFactorCount++] = (biquad_factor_t){0.0, -1.0};
+    for (; plusOneCount > 0; plusOneCount -= (plusOneCount > 1) ? 2 : 1)
+        zeroFactors[zeroFactorCount++] = (plusOneCount > 1)
+            ? (biquad_factor_t){-2.0, 1.0} : (biquad_factor_t){-1.0, 0.0};
+    for (; minusOneCount > 0; minusOneCount -= (minusOneCount > 1) ? 2 : 1)
+        zeroFactors[zeroFactorCount++] = (minusOneCount > 1)
+            ? (biquad_factor_t){2.0, 1.0} : (biquad_factor_t){1.0, 0.0};
+    zeroFactorCount += pairRoots(zeros, degree, &zeroFactors[zeroFactorCount]);
+    if (poleFactorCount > sectionCount || zeroFactorCount > sectionCount)
+        return false;
+
+    for (uint32_t i = poleFactorCount; i < sectionCount; i++)
+        poleFactors[i] = (biquad_factor_t){0.0, 0.0};
+    for (uint32_t i = zeroFactorCount; i < sectionCount; i++)
+        zeroFactors[i] = (biquad_factor_t){0.0, 0.0};
+    biquad_fromFactors(b[0], poleFactors, zeroFactors, sectionCount, sections);
+    return true;
+}
+
+// Returns the largest root magnitude of 1 + c1*z^-1 + c2*z^-2, or infinity for
+// the trivial factor {0, 0} so that padding sorts after the real factors.
+static double factorRadius(biquad_factor_t factor) {
+    if (factor.c1 == 0.0 && factor.c2 == 0.0)
+        return INFINITY;
+    double discriminant = factor.c1 * factor.c1 - 4.0 * factor.c2;
+    if (discriminant < 0.0)
+        return sqrt(factor.c2);
+    double root = sqrt(discriminant);
+    return fmax(fabs(-factor.c1 + root), fabs(-factor.c1 - root)) / 2.0;
+}
+
+// Builds biquads from known factors. See biquad.h.
+void biquad_fromFactors(double gain, const biquad_factor_t poles[],
+                        const biquad_factor_t zeros[], uint32_t sectionCount,
+                        biquad_section_t sections[]) {
+    // Order the pole pairs by increasing radius (sharpest resonance last),
+    // padding last.
+    biquad_factor_t poleFactors[BIQUAD_MAX_ORDER];
+    double radius[BIQUAD_MAX_ORDER];
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        biquad_factor_t factor = poles[i];
+        double factorRadiusValue = factorRadius(factor);
+        int32_t j = i - 1;
+        for (; j >= 0 && radius[j] > factorRadiusValue; j--) {
+            poleFactors[j + 1] = poleFactors[j];
+            radius[j + 1] = radius[j];
+        }
+        poleFactors[j + 1] = factor;
+        radius[j + 1] = factorRadiusValue;
+    }
+    for (uint32_t i = 0; i < sectionCount; i++)
+        sections[i] = (biquad_section_t){1.0, zeros[i].c1, zeros[i].c2,
+                                         poleFactors[i].c1, poleFactors[i].c2};
+
+    // Scale so that every partial cascade peaks at a gain of 1.
+    double magnitude[SCALING_GRID_POINT_COUNT];
+    for (uint32_t k = 0; k < SCALING_GRID_POINT_COUNT; k++)
+        magnitude[k] = 1.0;
+    double remainingGain = gain;
+    for (uint32_t i = 0; i + 1 < sectionCount; i++) {
+        double peak = 0.0;
+        for (uint32_t k = 0; k < SCALING_GRID_POINT_COUNT; k++) {
+            double w = PI * k / (SCALING_GRID_POINT_COUNT - 1);
+            magnitude[k] *= sectionMagnitude(&sections[i], w);
+            peak = fmax(peak, magnitude[k]);
+        }
+        double gain = (peak > 0.0) ? 1.0 / peak : 1.0;
+        for (uint32_t k = 0; k < SCALING_GRID_POINT_COUNT; k++)
+            magnitude[k] *= gain;
+        sections[i].b0 *= gain;
+        sections[i].b1 *= gain;
+        sections[i].b2 *= gain;
+        remainingGain /= gain;
+    }
+    biquad_section_t *last = &sections[sectionCount - 1];
+    last->b0 *= remainingGain;
+    last->b1 *= remainingGain;
+    last->b2 *= remainingGain;
+}
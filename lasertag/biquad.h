@@ -0,0 +1,75 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef BIQUAD_H_
+#define BIQUAD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Converts a direct-form IIR filter into a cascade of second-order sections
+// (biquads). High-order direct-form filters are very sensitive to coefficient
+// rounding, so anything that runs with less precision than double (fixed
+// point, single precision) must run the IIR filters as biquads.
+
+// One second-order section:
+// H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
+typedef struct {
+  double b0;
+  double b1;
+  double b2;
+  double a1;
+  double a2;
+} biquad_section_t;
+
+// Factors the filter
+// H(z) = (b[0] + b[1]*z^-1 + ... + b[order]*z^-order) /
+//        (1 + a[0]*z^-1 + ... + a[order-1]*z^-order)
+// into sectionCount = (order + 1) / 2 biquads. a[] does not include the
+// leading 1, which is how the coefficient tables in filter.c are stored.
+// Sections are ordered by increasing pole radius and scaled so that the peak
+// gain of every partial cascade is 1 (the last section carries whatever gain
+// is left over). This keeps intermediate values in range for fixed point.
+// Returns false if the polynomial roots could not be found or b[0] is zero.
+bool biquad_fromDirectForm(const double b[], const double a[], uint32_t order,
+                           biquad_section_t sections[]);
+
+// One second-order factor 1 + c1*z^-1 + c2*z^-2 of a numerator or a
+// denominator.
+typedef struct {
+  double c1;
+  double c2;
+} biquad_factor_t;
+
+// Builds sectionCount biquads for the filter
+// H(z) = gain * prod(zeros[i]) / prod(poles[i])
+// when its factors are already known (a filter design gives the poles
+// directly, so there is nothing to find). Sections are ordered and scaled the
+// same way as biquad_fromDirectForm(); pad with {0, 0} factors for odd orders.
+void biquad_fromFactors(double gain, const biquad_factor_t poles[],
+                        const biquad_factor_t zeros[], uint32_t sectionCount,
+                        biquad_section_t sections[]);
+
+// Transposed direct-form II state of one section: two values instead of the
+// four inputs and outputs that direct form I keeps.
+typedef struct {
+  double s1;
+  double s2;
+} biquad_state_t;
+
+// Runs one input through a section and returns its output.
+static inline double biquad_filter(const biquad_section_t *section,
+                                   biquad_state_t *state, double x) {
+  double y = section->b0 * x + state->s1;
+  state->s1 = section->b1 * x - section->a1 * y + state->s2;
+  state->s2 = section->b2 * x - section->a2 * y;
+  return y;
+}
+
+#endif /* BIQUAD_H_ */
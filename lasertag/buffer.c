@@ -1,77 +1,178 @@
 #include "buffer.h"
+#include <stdatomic.h>
 #include <stdlib.h>
-#include <assert.h>
+#include <string.h>
 
 #define EMPTY 0
-#define BUFFER_SIZE 32768
+#define BUFFER_SIZE 32768 // Must be a power of two.
+#define BUFFER_INDEX_MASK (BUFFER_SIZE - 1)
 
 #define MALLOC_ERR "ERROR_INIT_DATA_MALLOC_FAILED"
 #define OVERFLOW_ERR "ERROR_OVERFLOW"
 #define UNDERFLOW_ERR "ERROR_UNDERFLOW"
 #define INDEX_OUT_OF_RANGE_ERR "ERROR_INDEX_OUT_OF_RANGE"
 
+// Element storage, see BUFFER_STORAGE_BITS in buffer.h.
+#if BUFFER_STORAGE_BITS == 32
+typedef buffer_data_t buffer_storage_t;
+#define STORAGE_ARRAY_SIZE BUFFER_SIZE
+#elif BUFFER_STORAGE_BITS == 16
+typedef uint16_t buffer_storage_t;
+#define STORAGE_ARRAY_SIZE BUFFER_SIZE
+#elif BUFFER_STORAGE_BITS == 12
+// Elements 2k and 2k+1 share bytes 3k..3k+2: the even element is the low 12
+// bits, the odd element the high 12 bits.
+typedef uint8_t buffer_storage_t;
+#define STORAGE_ARRAY_SIZE (BUFFER_SIZE / 2 * 3)
+#define PACKED_BYTES_PER_PAIR 3
+#else
+#error "BUFFER_STORAGE_BITS must be 32, 16 or 12"
+#endif
+
 // This implements a dedicated circular buffer for storing values
 // from the ADC until they are read and processed by the detector.
 // The function of the buffer is similar to a queue or FIFO.
-
-// Type of elements in the buffer.
-typedef uint32_t buffer_data_t;
+//
+// The buffer is a single-producer/single-consumer ring that needs no locks:
+// the producer (buffer_pushover() in the ISR) only writes head and claimed,
+// the consumer (buffer_pop() in the detector) only writes tail and
+// droppedCount. The indices count every value ever pushed or popped and wrap
+// at 2^32; only the low bits (BUFFER_INDEX_MASK) select the slot.
+//
+// When the buffer is full the producer keeps writing, over the oldest values.
+// It cannot move tail, so the consumer notices when it has been lapped and
+// skips ahead. claimed is advanced before a value is written and head after,
+// so after copying values out the consumer can tell whether any of them were
+// overwritten while it was copying (the same idea as a sequence lock).
 
 typedef struct {
-    uint32_t indexIn; // Points to the next open slot.
-    uint32_t indexOut; // Points to the next element to be removed.
-    uint32_t elementCount; // Number of elements in the buffer.
-    buffer_data_t data[BUFFER_SIZE]; // Values are stored here.
+    _Atomic uint32_t head;             // Values pushed and published.
+    _Atomic uint32_t claimed;          // Values pushed, including one in progress.
+    _Atomic uint32_t tail;             // Values popped or skipped.
+    _Atomic uint32_t droppedCount;     // Values overwritten before being popped.
+    buffer_storage_t data[STORAGE_ARRAY_SIZE]; // Values are stored here.
 } buffer_t;
 
-volatile static buffer_t buf; //Buffer variable
+static buffer_t buf; //Buffer variable
+
+// Writes the value into a slot. For packed storage only the producer writes,
+// and it never changes the other element's bits in a shared byte, so the
+// consumer always reads whole values.
+static inline void storeValue(uint32_t slot, buffer_data_t value){
+#if BUFFER_STORAGE_BITS == 12
+    buffer_storage_t *pair = &buf.data[(slot >> 1) * PACKED_BYTES_PER_PAIR];
+    if(slot & 1){
+        pair[1] = (pair[1] & 0x0F) | ((value & 0x0F) << 4);
+        pair[2] = (value >> 4) & 0xFF;
+    } else {
+        pair[0] = value & 0xFF;
+        pair[1] = (pair[1] & 0xF0) | ((value >> 8) & 0x0F);
+    }
+#else
+    buf.data[slot] = (buffer_storage_t)value;
+#endif
+}
+
+// Copies count values starting at a slot (without wrapping) into values[].
+static inline void loadValues(buffer_data_t values[], uint32_t slot, uint32_t count){
+#if BUFFER_STORAGE_BITS == 32
+    memcpy(values, &buf.data[slot], count * sizeof(buffer_data_t));
+#elif BUFFER_STORAGE_BITS == 16
+    for(uint32_t i = 0; i < count; i++){
+        values[i] = buf.data[slot + i];
+    }
+#else
+    for(uint32_t i = 0; i < count; i++, slot++){
+        const buffer_storage_t *pair = &buf.data[(slot >> 1) * PACKED_BYTES_PER_PAIR];
+        values[i] = (slot & 1) ? (pair[1] >> 4) | (pair[2] << 4)
+                               : pair[0] | ((pair[1] & 0x0F) << 8);
+    }
+#endif
+}
 
 // Initialize the buffer to empty.
 void buffer_init(void){
 
     //intializing all the variables that are 0
-    buf.indexIn = 0;
-    buf.indexOut = 0;
-
-    //adding last variables
-    buf.elementCount = EMPTY;
+    atomic_store(&buf.head, 0);
+    atomic_store(&buf.claimed, 0);
+    atomic_store(&buf.tail, 0);
+    atomic_store(&buf.droppedCount, 0);
 }
 
 // Add a value to the buffer. Overwrite the oldest value if full.
-void buffer_pushover(buffer_data_t value){
-
-    //If buffer full, overwrite buffer value
-    if(buf.elementCount == BUFFER_SIZE){
-        buf.elementCount--;
-        buf.indexOut = (buf.indexOut+1) % BUFFER_SIZE;
-    }
-
-
-    //Increment Element count, write value to indexIn, increment indexIn
-    buf.data[buf.indexIn] = value;
-    buf.elementCount++;
-    buf.indexIn = (buf.indexIn+1) % BUFFER_SIZE;
+bool buffer_pushover(buffer_data_t value){
+
+    //Claim the slot, then write the value, then publish it
+    uint32_t head = atomic_load_explicit(&buf.head, memory_order_relaxed);
+    atomic_store_explicit(&buf.claimed, head + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    storeValue(head & BUFFER_INDEX_MASK, value);
+    atomic_store_explicit(&buf.head, head + 1, memory_order_release);
+
+    //A lapped consumer only moves tail when it next pops, so every push until
+    //then lands on a value it has not read
+    return head - atomic_load_explicit(&buf.tail, memory_order_relaxed) >= BUFFER_SIZE;
 }
 
 // Remove a value from the buffer. Return zero if empty.
 buffer_data_t buffer_pop(void){
 
     // Return 0 if buffer empty
-    if(buf.elementCount == 0){
+    buffer_data_t value;
+    if(buffer_popBlock(&value, 1) == 0){
         return EMPTY;
     }
+    return value;
+}
+
+// Remove up to maxCount values from the buffer into samples[].
+uint32_t buffer_popBlock(buffer_data_t samples[], uint32_t maxCount){
+    uint32_t head = atomic_load_explicit(&buf.head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&buf.tail, memory_order_relaxed);
+    uint32_t dropped = 0;
+
+    //If the producer has lapped us, skip to the oldest value still there
+    if(head - tail > BUFFER_SIZE){
+        dropped = head - tail - BUFFER_SIZE;
+        tail = head - BUFFER_SIZE;
+    }
+
+    //Copy in at most two pieces: up to the end of the array, then from the start
+    uint32_t count = head - tail < maxCount ? head - tail : maxCount;
+    uint32_t firstCount = BUFFER_SIZE - (tail & BUFFER_INDEX_MASK);
+    if(firstCount > count){
+        firstCount = count;
+    }
+    loadValues(samples, tail & BUFFER_INDEX_MASK, firstCount);
+    loadValues(&samples[firstCount], 0, count - firstCount);
+
+    //Values that the producer claimed a slot over during the copy may be torn,
+    //so throw them away (the oldest ones, at the start of samples[])
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t claimed = atomic_load_explicit(&buf.claimed, memory_order_relaxed);
+    uint32_t overwritten = claimed - tail > BUFFER_SIZE ? claimed - tail - BUFFER_SIZE : 0;
+    if(overwritten > count){
+        overwritten = count;
+    }
+    if(overwritten > 0){
+        memmove(samples, &samples[overwritten], (count - overwritten) * sizeof(buffer_data_t));
+        dropped += overwritten;
+    }
 
-    // Changing things that are done only when the buffer is empty
-    buffer_data_t temp_data = buf.data[buf.indexOut];
-    buf.elementCount--;
-    buf.indexOut = (buf.indexOut+1) % BUFFER_SIZE;
-    // Return buffer_data_t type
-    return temp_data;
+    if(dropped > 0){
+        atomic_fetch_add_explicit(&buf.droppedCount, dropped, memory_order_relaxed);
+    }
+    atomic_store_explicit(&buf.tail, tail + count, memory_order_relaxed);
+    return count - overwritten;
 }
 
 // Return the number of elements in the buffer.
 uint32_t buffer_elements(void) {
-    return buf.elementCount;
+    //Read tail first: it can only grow towards head
+    uint32_t tail = atomic_load_explicit(&buf.tail, memory_order_relaxed);
+    uint32_t count = atomic_load_explicit(&buf.head, memory_order_acquire) - tail;
+    return count > BUFFER_SIZE ? BUFFER_SIZE : count;
 }
 
 // Return the capacity of the buffer in elements.
@@ -79,3 +180,12 @@ uint32_t buffer_size(void) {
     return BUFFER_SIZE;
 }
 
+// Return the memory used to store the elements, in bytes.
+uint32_t buffer_storageBytes(void) {
+    return sizeof(buf.data);
+}
+
+// Return the number of values that were overwritten before they were popped.
+uint32_t buffer_getDroppedSampleCount(void) {
+    return atomic_load_explicit(&buf.droppedCount, memory_order_relaxed);
+}
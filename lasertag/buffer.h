@@ -10,28 +10,55 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #ifndef BUFFER_H_
 #define BUFFER_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 // This implements a dedicated circular buffer for storing values
 // from the ADC until they are read and processed by the detector.
 // The function of the buffer is similar to a queue or FIFO.
+//
+// The buffer is lock-free for one producer and one consumer: buffer_pushover()
+// may interrupt (or run concurrently with) buffer_pop()/buffer_popBlock()
+// without disabling interrupts. Values overwritten while full are counted by
+// buffer_getDroppedSampleCount().
 
 // Type of elements in the buffer.
 typedef uint32_t buffer_data_t;
 
+// Bits stored per element: 32, 16 or 12 (packed, two elements in three
+// bytes). The ADC delivers 12 bits, so 16 halves the memory without losing
+// anything. Pushed values are truncated to BUFFER_DATA_MASK.
+#ifndef BUFFER_STORAGE_BITS
+#define BUFFER_STORAGE_BITS 16
+#endif
+#define BUFFER_DATA_MASK ((buffer_data_t)((1ULL << BUFFER_STORAGE_BITS) - 1))
+
 // Initialize the buffer to empty.
 void buffer_init(void);
 
-// Add a value to the buffer. Overwrite the oldest value if full.
-void buffer_pushover(buffer_data_t value);
+// Add a value to the buffer. Overwrite the oldest value if full. Returns true
+// if a value that had not been popped yet was overwritten.
+bool buffer_pushover(buffer_data_t value);
 
 // Remove a value from the buffer. Return zero if empty.
 buffer_data_t buffer_pop(void);
 
+// Remove up to maxCount values from the buffer, oldest first, into samples[].
+// Returns the number of values removed.
+uint32_t buffer_popBlock(buffer_data_t samples[], uint32_t maxCount);
+
 // Return the number of elements in the buffer.
 uint32_t buffer_elements(void);
 
 // Return the capacity of the buffer in elements.
 uint32_t buffer_size(void);
 
+// Return the memory used to store the elements, in bytes.
+uint32_t buffer_storageBytes(void);
+
+// Return the number of values that were overwritten because the buffer was
+// full, since buffer_init(). Values are counted when the consumer finds they
+// are gone, so the count is exact for the values popped so far.
+uint32_t buffer_getDroppedSampleCount(void);
+
 #endif /* BUFFER_H_ */
@@ -0,0 +1,32 @@
+#include "cic.h"
+
+// Clears the state and computes the gain of the decimator.
+void cic_init(cic_t *cic, uint32_t decimationFactor) {
+    cic->gain = 1;
+    for (uint32_t s = 0; s < CIC_STAGE_COUNT; s++) {
+        cic->integrators[s] = 0;
+        cic->combDelays[s] = 0;
+        cic->gain *= decimationFactor;
+    }
+}
+
+// Runs the integrators on a block of samples in [-1.0, 1.0]. The stage loops
+// are unrolled (the pragma needs a literal of at least CIC_STAGE_COUNT) so
+// that the integrators stay in registers across the block.
+void cic_pushBlock(cic_t *cic, const double x[], uint32_t count) {
+    uint32_t integrators[CIC_STAGE_COUNT];
+#pragma GCC unroll 8
+    for (uint32_t s = 0; s < CIC_STAGE_COUNT; s++)
+        integrators[s] = cic->integrators[s];
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t value = (uint32_t)cic_fromDouble(x[i]);
+#pragma GCC unroll 8
+        for (uint32_t s = 0; s < CIC_STAGE_COUNT; s++) {
+            integrators[s] += value;
+            value = integrators[s];
+        }
+    }
+#pragma GCC unroll 8
+    for (uint32_t s = 0; s < CIC_STAGE_COUNT; s++)
+        cic->integrators[s] = integrators[s];
+}
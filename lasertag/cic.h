@@ -0,0 +1,72 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef CIC_H_
+#define CIC_H_
+
+#include <stdint.h>
+
+// A cascaded-integrator-comb (CIC) decimator: CIC_STAGE_COUNT integrators run
+// at the input rate and CIC_STAGE_COUNT combs (differential delay 1) run at
+// the output rate. It needs no multiplies, only one add per stage per input
+// and one subtract per stage per output. Its response is
+// |sin(pi*f*R/fs) / (R*sin(pi*f/fs))|^CIC_STAGE_COUNT for decimation factor
+// R, with a null on every multiple of the output rate, so it is followed by a
+// short compensation FIR that flattens the droop across the passband (see
+// FILTER_FIR_KERNEL_CIC in filter.h).
+//
+// The arithmetic is modulo 2^32: the integrators wrap around, but the output
+// is still exact as long as it fits in 32 bits. Inputs are Q15 (at most
+// 2^15 in magnitude), which grows by R^CIC_STAGE_COUNT = 10^4 for R = 10, so
+// the output needs 29 bits.
+
+#define CIC_STAGE_COUNT 4
+#define CIC_INPUT_ONE (1 << 15) // Inputs are Q15.
+
+typedef struct {
+  uint32_t integrators[CIC_STAGE_COUNT];
+  uint32_t combDelays[CIC_STAGE_COUNT]; // Previous input of each comb.
+  uint32_t gain;                        // R^CIC_STAGE_COUNT.
+} cic_t;
+
+// Clears the state of a decimator that is read (with cic_decimate()) once
+// every decimationFactor inputs.
+void cic_init(cic_t *cic, uint32_t decimationFactor);
+
+// Converts a sample in [-1.0, 1.0] to the Q15 input format.
+static inline int32_t cic_fromDouble(double x) {
+  return (int32_t)(x * CIC_INPUT_ONE);
+}
+
+// Runs the integrators on a new input.
+static inline void cic_push(cic_t *cic, int32_t x) {
+  uint32_t value = (uint32_t)x;
+  for (uint32_t s = 0; s < CIC_STAGE_COUNT; s++) {
+    cic->integrators[s] += value;
+    value = cic->integrators[s];
+  }
+}
+
+// Same as cic_push(cic_fromDouble(x[i])) for each of the count samples, with
+// the integrators kept in registers.
+void cic_pushBlock(cic_t *cic, const double x[], uint32_t count);
+
+// Runs the combs on the integrators and returns the decimated output, which
+// is the input scaled by cic->gain (in the passband).
+static inline int32_t cic_decimate(cic_t *cic) {
+  uint32_t value = cic->integrators[CIC_STAGE_COUNT - 1];
+  for (uint32_t s = 0; s < CIC_STAGE_COUNT; s++) {
+    uint32_t previous = cic->combDelays[s];
+    cic->combDelays[s] = value;
+    value -= previous;
+  }
+  return (int32_t)value;
+}
+
+#endif /* CIC_H_ */
@@ -0,0 +1,15 @@
+#include <string.h>
+#include "delayLine.h"
+
+// Sets up line over storage[] (2 * length elements) and fills it with zeros.
+void delayLine_init(delayLine_t *line, sample_t storage[], uint32_t length) {
+    line->data = storage;
+    line->length = length;
+    delayLine_clear(line);
+}
+
+// Sets all of the samples to zero.
+void delayLine_clear(delayLine_t *line) {
+    memset(line->data, 0, 2 * line->length * sizeof(line->data[0]));
+    line->index = 0;
+}
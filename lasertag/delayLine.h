@@ -0,0 +1,48 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef DELAYLINE_H_
+#define DELAYLINE_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+// A mirrored delay line holding the last length samples. Every sample is
+// written twice, at index and at index + length, into a storage array of
+// 2 * length elements, so the last length samples are always one contiguous
+// run of memory: a filter over the line is a straight dot product, with no
+// wrap-around or modulo addressing. The storage is provided by the caller.
+
+typedef struct {
+  sample_t *data;  // 2 * length elements.
+  uint32_t length;
+  uint32_t index;  // Where the next sample is written.
+} delayLine_t;
+
+// Sets up line over storage[] (2 * length elements) and fills it with zeros.
+void delayLine_init(delayLine_t *line, sample_t storage[], uint32_t length);
+
+// Sets all of the samples to zero.
+void delayLine_clear(delayLine_t *line);
+
+// Shifts a new sample into the line, dropping the oldest one.
+static inline void delayLine_push(delayLine_t *line, sample_t value) {
+  line->data[line->index] = value;
+  line->data[line->index + line->length] = value;
+  if (++line->index == line->length)
+    line->index = 0;
+}
+
+// Returns the last length samples, oldest first: window[length - 1] is the
+// newest sample. Valid until the next push.
+static inline const sample_t *delayLine_getWindow(const delayLine_t *line) {
+  return &line->data[line->index];
+}
+
+#endif /* DELAYLINE_H_ */
@@ -1,163 +1,294 @@
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "buffer.h"
+#include "detector.h"
 #include "filter.h"
 #include "lockoutTimer.h"
 #include "hitLedTimer.h"
 #include "interrupts.h"
 #include "invincibilityTimer.h"
+#include "powerSelect.h"
 
 
-#define FREQUENCY_COUNT 10
 #define COUNT_BEFORE_FILTER 10
 #define ADC_SCALAR 4.8840048E-4
 #define FUDGE_FACTOR 190
-#define MEDIAN_INDEX 4
 #define NO_HIT_DETECTED -1
+#define POWER_WINDOW_LENGTH 2000 //Decimated samples in the filter power window
+
+//Multi-resolution detection: the power over the newest 25, 50 and 100 ms is
+//tracked next to the full 200 ms window. A short window has fewer samples of
+//noise to average, so it must clear a stricter fudge factor (times
+//shortWindowStrictness), and the full window must agree on the frequency with
+//the part of the fudge factor that the shot can have built up in it so far
+#define SHORT_WINDOW_COUNT 3
+static const uint32_t shortWindowLengths[SHORT_WINDOW_COUNT] = {250, 500, 1000};
+static const double shortWindowStrictness[SHORT_WINDOW_COUNT] = {4, 2, 1.5};
+static bool multiResolution;
+
+//Detection profiles, selected with detector_setFudgeFactorIndex(). Profile 0
+//is the original detector: FUDGE_FACTOR times the median power. The others
+//are constant-false-alarm-rate (CFAR) detectors: each channel keeps its own
+//exponentially-smoothed noise floor and is compared against it, so a channel
+//with a strong interferer (fluorescent lights) does not raise or lower the
+//threshold of the others. The threshold factor comes from the false-alarm
+//target with the cell-averaging CFAR model, K * (Pfa^(-1/K) - 1) for a floor
+//worth CFAR_REFERENCE_CELL_COUNT independent noise samples. The power is an
+//average over 200 ms, so the actual false-alarm rate is lower still
+typedef struct {
+    double falseAlarmProbability; //Zero selects the median detector
+    uint32_t floorTimeConstant;   //Decimated samples (10000 per second)
+} detector_profile_t;
+static const detector_profile_t detectorProfiles[] = {
+    {0.0, 0},          //FUDGE_FACTOR times the median power
+    {1.0E-9, 20000},   //CFAR for general use: 2 s noise floor
+    {1.0E-6, 50000},   //CFAR indoors: steady lighting, slow floor, low threshold
+    {1.0E-12, 5000},   //CFAR outdoors: sunlight changes fast, fast floor, strict
+};
+#define DETECTOR_PROFILE_COUNT (sizeof(detectorProfiles) / sizeof(detectorProfiles[0]))
+#define CFAR_REFERENCE_CELL_COUNT 16
+//The floor drops with the power at once and rises with the floor time
+//constant. Power above CFAR_UPDATE_GATE times the floor (a shot building up,
+//long before it reaches the threshold) is clipped to that and followed
+//CFAR_CENSORED_SLOWDOWN times more slowly, so a shot barely moves the floor but
+//a lasting rise in the noise (the lights are switched on) is still followed
+#define CFAR_UPDATE_GATE 2.0
+#define CFAR_CENSORED_SLOWDOWN 16
+static const detector_profile_t *profile = &detectorProfiles[0];
+static double cfarThresholdFactor;
+static double noiseFloor[FILTER_MAX_FREQUENCY_COUNT];
+//The floor follows the power exactly until the power window has filled once
+static uint32_t cfarWarmupCount;
 
 #define TEST_POWER_VALUE_SET_1 1.1,2.2,4.1,100000,3.5,2.6,2,5,1.2,.04
 #define TEST_POWER_VALUE_SET_2 100.2,50.4,4.1,402.5,3.5,20.5,2,5,2.53,204.3
+//Noise floors with an interferer on filter 2, then a burst on filter 2 that is
+//within its own noise and a shot on filter 7 that is well above its own
+#define TEST_CFAR_NOISE_VALUES 3.1,2.2,1000,4.1,3.5,2.6,2,5,1.2,2.4
+#define TEST_CFAR_VALUE_SET_1 3.1,2.2,20000,4.1,3.5,2.6,2,5,1.2,2.4
+#define TEST_CFAR_VALUE_SET_2 3.1,2.2,1000,4.1,3.5,2.6,2,500,1.2,2.4
+#define TEST_CFAR_PROFILE 1
 
 
 typedef uint16_t detector_hitCount_t;
-bool ignoredFreq[FREQUENCY_COUNT];
+//Number of player frequencies in the frequency plan, see frequencyPlan.h
+static uint16_t frequencyCount;
+bool ignoredFreq[FILTER_MAX_FREQUENCY_COUNT];
 uint16_t adcValuesAdded;
 volatile bool detector_hitDetectedFlag;
-uint32_t detector_hitArray[FREQUENCY_COUNT];
+uint32_t detector_hitArray[FILTER_MAX_FREQUENCY_COUNT];
 uint16_t lastHit;
 uint64_t invocationCount;
 bool first_run;
 
 
+//Updates the noise floor of every channel from the current power values
+static void update_noise_floors(){
+    double powerValues[FILTER_MAX_FREQUENCY_COUNT];
+    filter_getCurrentPowerValues(powerValues);
+    if (cfarWarmupCount < POWER_WINDOW_LENGTH){
+        cfarWarmupCount++;
+        for (uint16_t i = 0; i < frequencyCount; i++)
+            noiseFloor[i] = powerValues[i];
+        return;
+    }
+    for (uint16_t i = 0; i < frequencyCount; i++){
+        double gate = CFAR_UPDATE_GATE * noiseFloor[i];
+        if (powerValues[i] < noiseFloor[i])
+            noiseFloor[i] = powerValues[i];
+        else if (powerValues[i] < gate)
+            noiseFloor[i] += (powerValues[i] - noiseFloor[i]) / profile->floorTimeConstant;
+        else
+            noiseFloor[i] += (gate - noiseFloor[i]) / (profile->floorTimeConstant * CFAR_CENSORED_SLOWDOWN);
+    }
+}
+
+//Returns the channel whose power is furthest above its own noise floor (scaled
+//by windowShare, the length of the power window over the full window) by at
+//least thresholdFactor, or NO_HIT_DETECTED
+static int16_t find_cfar_hit(const double powerValues[], double windowShare, double thresholdFactor){
+    int16_t hit = NO_HIT_DETECTED;
+    double hitRatio = thresholdFactor;
+    if (cfarWarmupCount < POWER_WINDOW_LENGTH)
+        return NO_HIT_DETECTED;
+    for (uint16_t i = 0; i < frequencyCount; i++){
+        double reference = noiseFloor[i] * windowShare;
+        if (!ignoredFreq[i] && reference > 0 && powerValues[i] >= hitRatio * reference){
+            hitRatio = powerValues[i] / reference;
+            hit = i;
+        }
+    }
+    return hit;
+}
+
+//Returns the filter whose power is at least fudgeFactor times the median
+//power, or NO_HIT_DETECTED if there is none (or it is ignored). With a CFAR
+//profile, the reference is the noise floor instead of the median
+static int16_t find_hit(const double powerValues[], double windowShare, double fudgeFactor){
+    if (profile->falseAlarmProbability > 0)
+        return find_cfar_hit(powerValues, windowShare, fudgeFactor);
+
+    //Only the largest power and the median are needed, not a full sort. The
+    //median network reorders its input, so it runs on a copy
+    double medianValues[FILTER_MAX_FREQUENCY_COUNT];
+    memcpy(medianValues, powerValues, frequencyCount * sizeof(medianValues[0]));
+    uint16_t maxFilter = powerSelect_maxIndex(powerValues, frequencyCount);
+    double medianPower = powerSelect_median(medianValues, frequencyCount);
+
+    //A median power of zero means there is no noise floor to compare against yet
+    //(silence, or the fixed-point filters rounding tiny start-up values to zero)
+    if(!ignoredFreq[maxFilter] && (medianPower > 0) && (powerValues[maxFilter] >= fudgeFactor*medianPower)){
+        return maxFilter;
+    }
+    return NO_HIT_DETECTED;
+}
+
 //hit_detect function that determins if there has been a registered
 //hit, and if there has been, set the hitDetected flag to true
 //lastHit to the filter the hit wsa registered on.
 void hit_detect(){
-
-    //Create Arrays to Hold 1) Power Values, 2) sorted list of powerValues indexes
-    uint16_t filterSorted[FREQUENCY_COUNT];
-    double powerValues[FREQUENCY_COUNT];
+    double powerValues[FILTER_MAX_FREQUENCY_COUNT];
 
     //Copy current power values from filter
     filter_getCurrentPowerValues(powerValues);
-
-    filterSorted[0] = 0;
-
-    //Nested for loops to do insertion sort
-    for (uint16_t insert_filter = 1; insert_filter < FREQUENCY_COUNT; insert_filter++){
-        filterSorted[insert_filter] = insert_filter;
-
-        //Inner loop to put filter number into sorted place
-        for(uint16_t compare_filter = insert_filter-1; compare_filter >= 0; compare_filter--){
-
-            //If the value is greater or equal to the one before it, do not switch it
-            if(powerValues[insert_filter] >= powerValues[filterSorted[compare_filter]]){
-                break;   
-            }
-
-            //Else switch the compare filter and the insert_filter
-            filterSorted[compare_filter+1] = filterSorted[compare_filter];
-            filterSorted[compare_filter] = insert_filter;
-        }
+    double fudgeFactor = profile->falseAlarmProbability > 0 ? cfarThresholdFactor : FUDGE_FACTOR;
+    int16_t hit = find_hit(powerValues, 1.0, fudgeFactor);
+
+    //Try the short windows, shortest first, each confirmed by the full window
+    for (uint16_t window = 0; multiResolution && hit == NO_HIT_DETECTED && window < SHORT_WINDOW_COUNT; window++){
+        double shortPowerValues[FILTER_MAX_FREQUENCY_COUNT];
+        double windowShare = shortWindowLengths[window] / (double)POWER_WINDOW_LENGTH;
+        filter_getShortWindowPowerValues(window, shortPowerValues);
+        int16_t shortHit = find_hit(shortPowerValues, windowShare, fudgeFactor * shortWindowStrictness[window]);
+        if (shortHit != NO_HIT_DETECTED && find_hit(powerValues, 1.0, fudgeFactor * windowShare) == shortHit)
+            hit = shortHit;
     }
 
     //If there is a shot detected, set the hitDetectedFlag to true and register the cordinating filter to the lastHit
-    if(!ignoredFreq[filterSorted[FREQUENCY_COUNT-1]] && (powerValues[filterSorted[FREQUENCY_COUNT - 1]] >= FUDGE_FACTOR*powerValues[filterSorted[MEDIAN_INDEX]])){
+    if (hit != NO_HIT_DETECTED){
         detector_hitDetectedFlag = TRUE; //Set hitDetectedFlag to true
-        lastHit = filterSorted[FREQUENCY_COUNT-1]; //Set lastHit to the registered hit filter
+        lastHit = hit; //Set lastHit to the registered hit filter
     }
 
 }
 
 
-// Initialize the detector module.
-// By default, all frequencies are considered for hits.
-// Assumes the filter module is initialized previously.
-void detector_init(void) {
+// Same as detector_init() but selects how the per-frequency power is computed.
+void detector_initWithIirStructure(filter_iirStructure_t structure) {
 
     //Iterate through ignored frequencies setting all to false
-    for (uint16_t i = 0; i < FREQUENCY_COUNT; i++){
+    for (uint16_t i = 0; i < FILTER_MAX_FREQUENCY_COUNT; i++){
         ignoredFreq[i] = FALSE;
     }
-    filter_init();
+    filter_initWithFirKernel(FILTER_FIR_KERNEL_BEST); //Fastest FIR the CPU supports
+    frequencyCount = filter_getFrequencyCount(); //One filter per frequency in the plan
+    filter_setIirStructure(structure);
+    filter_setPowerMethod(FILTER_POWER_TRACKER); //Power that does not drift over a long game
+    filter_setShortPowerWindows(shortWindowLengths, SHORT_WINDOW_COUNT);
+    multiResolution = false;
+    detector_setFudgeFactorIndex(0);
     //Assert asvValuesAdded to 0 and detector_hitDetectedFlag to false
     adcValuesAdded = 0;
     detector_hitDetectedFlag = FALSE;
     first_run = true;
 }
 
+// Initialize the detector module.
+// By default, all frequencies are considered for hits.
+// Assumes the filter module is initialized previously.
+void detector_init(void) {
+    detector_initWithIirStructure(FILTER_IIR_BIQUAD);
+}
+
 // freqArray is indexed by frequency number. If an element is set to true,
 // the frequency will be ignored. Multiple frequencies can be ignored.
 // Your shot frequency (based on the switches) is a good choice to ignore.
 void detector_setIgnoredFrequencies(bool freqArray[]) {
     //Iterate through ignored frequencies copying new data in
-    for (uint16_t i = 0; i < FREQUENCY_COUNT; i++){
+    for (uint16_t i = 0; i < frequencyCount; i++){
         ignoredFreq[i] = freqArray[i];
     }
 }
 
+// Enables multi-resolution detection.
+void detector_setMultiResolution(bool enable) {
+    multiResolution = enable;
+}
+
 // Returns true if a hit was detected.
 bool detector_hitDetected(void) {
     return detector_hitDetectedFlag;
 }
 
 // Runs the entire detector: decimating FIR-filter, IIR-filters,
-// power-computation, hit-detection. If interruptsCurrentlyEnabled = true,
-// interrupts are running. If interruptsCurrentlyEnabled = false you can pop
-// values from the ADC buffer without disabling interrupts. If
-// interruptsCurrentlyEnabled = true, do the following:
-// 1. disable interrupts.
-// 2. pop the value from the ADC buffer.
-// 3. re-enable interrupts.
+// power-computation, hit-detection. interruptsCurrentlyEnabled tells whether
+// interrupts are running; the ADC buffer is lock-free (see buffer.h), so
+// values are popped without disabling interrupts either way.
 // Ignore hits on frequencies specified with detector_setIgnoredFrequencies().
 // Assumption: draining the ADC buffer occurs faster than it can fill.
-void detector(bool interruptsCurrentlyEnabled) {
+void detector(__attribute__((unused)) bool interruptsCurrentlyEnabled) {
     invocationCount++; //Increment filter invocation count
     uint32_t bufferElements = buffer_elements(); //read in bufferelement count
+    buffer_data_t block[DETECTOR_BLOCK_SIZE];
+
+    //Pop the elements that are in the buffer now a block at a time and run the
+    //detector on each block. The buffer is lock-free, so the ISR can keep
+    //pushing while we pop and interrupts stay enabled
+    while (bufferElements > 0) {
+        uint32_t blockSize = bufferElements < DETECTOR_BLOCK_SIZE ? bufferElements : DETECTOR_BLOCK_SIZE;
+        blockSize = buffer_popBlock(block, blockSize);
+        if (blockSize == 0)
+            break;
+        detector_processBlock(block, blockSize);
+        bufferElements -= blockSize;
+    }
+}
+
+// Runs all filters and power calculations for a decimated sample, then
+// determines if a hit has been registered and if so increments that hit count.
+static void filter_and_detect() {
+    //Run Filters
+    filter_firFilter();
+
+    //Run all of the iir filters and power calculations together
+    filter_iirFilterBank(first_run);
+    first_run = false;
+    if (profile->falseAlarmProbability > 0)
+        update_noise_floors();
+
+    //Run if lockout Timer or invincibilityTimer is Not Running
+    if (!lockoutTimer_running() && !invincibilityTimer_running()){
+        hit_detect(); //Run hit_detect() algorithm
+        if(detector_hitDetected()){
+            lockoutTimer_start(); //Start the lockout timer
+            hitLedTimer_start(); //Start the hit LED timer
+            detector_hitArray[lastHit]++; //Increment the count of the filter that registered the hit
+        }
+    }
+}
+
+// Runs the detector on a block of raw ADC samples.
+void detector_processBlock(const buffer_data_t *samples, size_t n) {
+    double scaledAdcValues[COUNT_BEFORE_FILTER];
+
+    //Hand the filters the samples up to the next decimation point at once,
+    //then run the decimated part of the detector
+    while (n > 0) {
+        size_t count = COUNT_BEFORE_FILTER - adcValuesAdded;
+        if (count > n)
+            count = n;
+        for (size_t i = 0; i < count; i++)
+            scaledAdcValues[i] = (samples[i] * ADC_SCALAR) - 1; //Change the ADC value to a number between -1 and 1
+        filter_addNewInputs(scaledAdcValues, count); //Add the values to the filters
+        adcValuesAdded += count; //Increment the number of values added
+        samples += count;
+        n -= count;
 
-    //For each buffer element
-        //read the raw value
-        //create a scaled value
-        //if it is the 10th element
-            //run all filters and power calculations
-            //determine if a hit has been registered
-            //if a hit has been registered, increment that hit count
-    for(uint32_t i = bufferElements; i > 0; --i){
-        
-        if(interruptsCurrentlyEnabled) // If interruptsCurrentlyEnabled, disable the arm interrupts while reading values 
-            interrupts_disableArmInts();
-        
-        buffer_data_t rawAdcValue = buffer_pop();
-
-        if(interruptsCurrentlyEnabled)// If interruptsCurrentlyEnabled, enable the arm interrupts after reading values 
-            interrupts_enableArmInts();
-
-        double scaledAdcValue = (rawAdcValue * (ADC_SCALAR - 1)); //Change the ADC value to a number between -1 and 1
-
-        filter_addNewInput(scaledAdcValue);  //Add the value to the filters
-        adcValuesAdded++; //Increment the number of values added
-        
         if (adcValuesAdded == COUNT_BEFORE_FILTER) {
-            //Run Filters
-            filter_firFilter();
-
-            //For each filter 0-9, run iir_filter and power calulation
-            for (uint16_t filter = 0; filter < FILTER_FREQUENCY_COUNT; ++filter){
-                filter_iirFilter(filter);
-                filter_computePower(filter, first_run, FALSE);
-                first_run = false;
-            }
-
-            //Run if lockout Timer or invincibilityTimer is Not Running
-            if (!lockoutTimer_running() && !invincibilityTimer_running()){
-                hit_detect(); //Run hit_detect() algorithm
-                if(detector_hitDetected()){
-                    lockoutTimer_start(); //Start the lockout timer
-                    hitLedTimer_start(); //Start the hit LED timer
-                    detector_hitArray[lastHit]++; //Increment the count of the filter that registered the hit
-                }
-            }
+            filter_and_detect();
             adcValuesAdded = 0; //Reset the adc added counter
         }
     }
@@ -187,7 +318,7 @@ void detector_ignoreAllHits(bool flagValue) {
 void detector_getHitCounts(detector_hitCount_t hitArray[]) {
 
     //For each element in the filter array, return the registered hits
-    for (uint32_t i = 0; i < FREQUENCY_COUNT; i++) {
+    for (uint32_t i = 0; i < frequencyCount; i++) {
        hitArray[i] = detector_hitArray[i];
     }
 }
@@ -195,7 +326,13 @@ void detector_getHitCounts(detector_hitCount_t hitArray[]) {
 // Allows the fudge-factor index to be set externally from the detector.
 // The actual values for fudge-factors is stored in an array found in detector.c
 void detector_setFudgeFactorIndex(uint32_t factorIdx) {
-    return;
+    if (factorIdx >= DETECTOR_PROFILE_COUNT)
+        factorIdx = 0;
+    profile = &detectorProfiles[factorIdx];
+    double k = CFAR_REFERENCE_CELL_COUNT;
+    if (profile->falseAlarmProbability > 0)
+        cfarThresholdFactor = k * (pow(profile->falseAlarmProbability, -1.0 / k) - 1.0);
+    cfarWarmupCount = 0;
 }
 
 // Returns the detector invocation count.
@@ -264,5 +401,39 @@ void detector_runTest(void) {
     else{
         printf("No Hit Detected\n");
     }
+
+    detector_clearHit(); //Clear hit
+
+    //Let the CFAR detector learn the noise floors, then try both sets
+    double cfarNoiseValues[FILTER_FREQUENCY_COUNT] = {TEST_CFAR_NOISE_VALUES};
+    double cfarValues[2][FILTER_FREQUENCY_COUNT] = {{TEST_CFAR_VALUE_SET_1}, {TEST_CFAR_VALUE_SET_2}};
+    detector_setFudgeFactorIndex(TEST_CFAR_PROFILE);
+    printf("Testing CFAR profile %d (threshold %.1f times the noise floor)\n", TEST_CFAR_PROFILE, cfarThresholdFactor);
+    for(uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; ++i){
+        filter_setCurrentPowerValue(i,cfarNoiseValues[i]);
+    }
+    for(uint32_t n = 0; n < 2 * POWER_WINDOW_LENGTH; n++){
+        update_noise_floors();
+    }
+    for(uint16_t set = 0; set < 2; set++){
+        printf("CFAR %s\nTesting Values: ", set ? "Expected hit on filter 7" : "No Expected Hit (noisy filter 2)");
+        for(uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; ++i){
+            filter_setCurrentPowerValue(i,cfarValues[set][i]);
+            printf("%f ",cfarValues[set][i]);
+        }
+        printf("\n"); //Print new line
+
+        hit_detect(); //Run the hit detection algorithm
+
+        //Print either hit dectected or not
+        if (detector_hitDetected()){
+            printf("CFAR Hit Detected on %d\n",lastHit);
+        }
+        else{
+            printf("CFAR No Hit Detected\n");
+        }
+        detector_clearHit(); //Clear hit
+    }
+    detector_setFudgeFactorIndex(0);
 }
 
@@ -12,32 +12,57 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #define DETECTOR_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "buffer.h"
+#include "filter.h"
+
 typedef uint16_t detector_hitCount_t;
 
+// Most samples that detector() pops from the ADC buffer at once.
+#define DETECTOR_BLOCK_SIZE 256
+
 // Initialize the detector module.
 // By default, all frequencies are considered for hits.
 // Assumes the filter module is initialized previously.
 void detector_init(void);
 
+// Same as detector_init() but selects how the per-frequency power is computed
+// (see filter_setIirStructure()). detector_init() uses FILTER_IIR_BIQUAD.
+// Both initialize the filters for the current frequency plan (see
+// frequencyPlan.h) and watch every frequency in it; the arrays passed to
+// detector_setIgnoredFrequencies() and detector_getHitCounts() have one
+// element per frequency, filter_getFrequencyCount() in all.
+void detector_initWithIirStructure(filter_iirStructure_t structure);
+
 // freqArray is indexed by frequency number. If an element is set to true,
 // the frequency will be ignored. Multiple frequencies can be ignored.
 // Your shot frequency (based on the switches) is a good choice to ignore.
 void detector_setIgnoredFrequencies(bool freqArray[]);
 
 // Runs the entire detector: decimating FIR-filter, IIR-filters,
-// power-computation, hit-detection. If interruptsCurrentlyEnabled = true,
-// interrupts are running. If interruptsCurrentlyEnabled = false you can pop
-// values from the ADC buffer without disabling interrupts. If
-// interruptsCurrentlyEnabled = true, do the following:
-// 1. disable interrupts.
-// 2. pop the value from the ADC buffer.
-// 3. re-enable interrupts.
+// power-computation, hit-detection. interruptsCurrentlyEnabled tells whether
+// interrupts are running; the ADC buffer is lock-free (see buffer.h), so
+// values are popped without disabling interrupts either way.
 // Ignore hits on frequencies specified with detector_setIgnoredFrequencies().
 // Assumption: draining the ADC buffer occurs faster than it can fill.
 void detector(bool interruptsCurrentlyEnabled);
 
+// Runs the detector on a block of raw ADC samples (what detector() does with
+// each sample it pops). detector() pops blocks of up to DETECTOR_BLOCK_SIZE
+// samples with buffer_popBlock() and hands them to this function. Can also be
+// called directly with samples from another source.
+void detector_processBlock(const buffer_data_t *samples, size_t n);
+
+// Enables multi-resolution detection, which cuts the latency of a hit. Next to
+// the 200 ms power window, the power over the newest 25, 50 and 100 ms is
+// tracked, and a hit is declared as soon as a short window clears a stricter
+// threshold and the 200 ms window agrees on the frequency. Off after
+// detector_init(). Has no effect with FILTER_IIR_SLIDING_DFT or the
+// fixed-point filters, which do not keep the short windows.
+void detector_setMultiResolution(bool enable);
+
 // Returns true if a hit was detected.
 bool detector_hitDetected(void);
 
@@ -59,6 +84,11 @@ void detector_getHitCounts(detector_hitCount_t hitArray[]);
 
 // Allows the fudge-factor index to be set externally from the detector.
 // The actual values for fudge-factors is stored in an array found in detector.c
+// Index 0 (selected by detector_init()) compares the strongest frequency with
+// a fixed factor times the median power. Indexes 1 (general), 2 (indoors) and
+// 3 (outdoors) select constant-false-alarm-rate profiles, which compare each
+// frequency with its own adaptive noise floor; they take 200 ms to learn the
+// floor after being selected. Out-of-range indexes select 0.
 void detector_setFudgeFactorIndex(uint32_t factorIdx);
 
 // Returns the detector invocation count.
@@ -1,12 +1,33 @@
+#include <assert.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "biquad.h"
+#include "cic.h"
+#include "delayLine.h"
 #include "filter.h"
+#include "filterFixed.h"
+#include "filterTables.h"
+#include "firKernel.h"
+#include "powerTracker.h"
+#include "sample.h"
+#include "slidingDft.h"
+
+// Build with -DFILTER_FIXED_POINT=ON to run the main filter functions on the
+// fixed-point engine in filterFixed.c. The queues below are still allocated so
+// that the verification-assisting functions keep working, but only the
+// double-precision engine uses them.
+//
+// Build with -DFILTER_SINGLE_PRECISION=ON to store the samples, the FIR taps
+// and the biquads as float (see sample.h). The power values stay double. The
+// 10th-order direct forms do not survive float outputs in their feedback, so
+// that build runs the IIR filters as biquads whichever structure is selected.
 
 //define values
-#define FILTER_IIR_FILTER_COUNT 10
-#define FIR_FILTER_COEFFICIENT_COUNT 81
-#define IIR_A_COEFFICIENT_COUNT 10
-#define IIR_B_COEFFICIENT_COUNT 11
+#define FIR_FILTER_COEFFICIENT_COUNT FILTER_TABLES_FIR_TAP_COUNT
+#define IIR_A_COEFFICIENT_COUNT FILTER_TABLES_IIR_ORDER
+#define IIR_B_COEFFICIENT_COUNT (FILTER_TABLES_IIR_ORDER + 1)
 #define QUEUE_INIT_VALUE 0.0
 #define DECIMATION_VALUE 10
 
@@ -16,167 +37,188 @@
 #define X_QUEUE_SIZE FIR_FILTER_COEFFICIENT_COUNT
 #define OUTPUT_QUEUE_SIZE 2000
 #define FIR_FILTER_TAP_COUNT FIR_FILTER_COEFFICIENT_COUNT
-
-//fir Coefficients array
-const static double firCoefficients[FIR_FILTER_TAP_COUNT] = {
-5.3751585173668532e-04, 
-4.1057821244099187e-04, 
-2.3029811615433415e-04, 
--1.0022421255268634e-05, 
--3.1239220025873498e-04, 
--6.6675539469892989e-04, 
--1.0447674325821804e-03, 
--1.3967861519587053e-03, 
--1.6537303925483089e-03, 
--1.7346382015025667e-03, 
--1.5596484449522630e-03, 
--1.0669170920384048e-03, 
--2.3088291222664008e-04, 
-9.2146384892950099e-04, 
-2.2999023467067978e-03, 
-3.7491095163012366e-03, 
-5.0578112742500408e-03, 
-5.9796411037508039e-03, 
-6.2645305736409576e-03, 
-5.6975395969924630e-03, 
-4.1403678436423832e-03, 
-1.5696670848600943e-03, 
--1.8940691237627923e-03, 
--5.9726960144609528e-03, 
--1.0235869785695425e-02, 
--1.4127694707478473e-02, 
--1.7013744396319821e-02, 
--1.8244737113263923e-02, 
--1.7230507462687290e-02, 
--1.3515937014932726e-02, 
--6.8495092580338254e-03, 
-2.7646568253820039e-03, 
-1.5039019355364032e-02, 
-2.9404269200373489e-02, 
-4.5042275861018187e-02, 
-6.0948410493762414e-02, 
-7.6017645500231018e-02, 
-8.9145705550443280e-02, 
-9.9334411853457705e-02, 
-1.0578952596388017e-01, 
-1.0800000000000000e-01, 
-1.0578952596388017e-01, 
-9.9334411853457705e-02, 
-8.9145705550443280e-02, 
-7.6017645500231018e-02, 
-6.0948410493762414e-02, 
-4.5042275861018187e-02, 
-2.9404269200373489e-02, 
-1.5039019355364032e-02, 
-2.7646568253820039e-03, 
--6.8495092580338254e-03, 
--1.3515937014932726e-02, 
--1.7230507462687290e-02, 
--1.8244737113263923e-02, 
--1.7013744396319821e-02, 
--1.4127694707478473e-02, 
--1.0235869785695425e-02, 
--5.9726960144609528e-03, 
--1.8940691237627923e-03, 
-1.5696670848600943e-03, 
-4.1403678436423832e-03, 
-5.6975395969924630e-03, 
-6.2645305736409576e-03, 
-5.9796411037508039e-03, 
-5.0578112742500408e-03, 
-3.7491095163012366e-03, 
-2.2999023467067978e-03, 
-9.2146384892950099e-04, 
--2.3088291222664008e-04, 
--1.0669170920384048e-03, 
--1.5596484449522630e-03, 
--1.7346382015025667e-03, 
--1.6537303925483089e-03, 
--1.3967861519587053e-03, 
--1.0447674325821804e-03, 
--6.6675539469892989e-04, 
--3.1239220025873498e-04, 
--1.0022421255268634e-05, 
-2.3029811615433415e-04, 
-4.1057821244099187e-04, 
-5.3751585173668532e-04};
-
-//iir A Coefficients array
-const static double iirACoefficientConstants[FILTER_FREQUENCY_COUNT][IIR_A_COEFFICIENT_COUNT] = {
-{-5.9637727070164059e+00, 1.9125339333078287e+01, -4.0341474540744301e+01, 6.1537466875369077e+01, -7.0019717951472558e+01, 6.0298814235239249e+01, -3.8733792862566574e+01, 1.7993533279581207e+01, -5.4979061224868158e+00, 9.0332828533800469e-01},
-{-4.6377947119071408e+00, 1.3502215749461552e+01, -2.6155952405269698e+01, 3.8589668330738235e+01, -4.3038990303252490e+01, 3.7812927599536991e+01, -2.5113598088113683e+01, 1.2703182701888030e+01, -4.2755083391143280e+00, 9.0332828533799747e-01},
-{-3.0591317915750937e+00, 8.6417489609637492e+00, -1.4278790253808838e+01, 2.1302268283304294e+01, -2.2193853972079211e+01, 2.0873499791105424e+01, -1.3709764520609379e+01, 8.1303553577931567e+00, -2.8201643879900473e+00, 9.0332828533799880e-01},
-{-1.4071749185996751e+00, 5.6904141470697542e+00, -5.7374718273676306e+00, 1.1958028362868905e+01, -8.5435280598354630e+00, 1.1717345583835968e+01, -5.5088290876998647e+00, 5.3536787286077674e+00, -1.2972519209655595e+00, 9.0332828533800047e-01},
-{8.2010906117760318e-01, 5.1673756579268604e+00, 3.2580350909220925e+00, 1.0392903763919193e+01, 4.8101776408669084e+00, 1.0183724507092508e+01, 3.1282000712126754e+00, 4.8615933365571991e+00, 7.5604535083144919e-01, 9.0332828533800047e-01},
-{2.7080869856154530e+00, 7.8319071217995795e+00, 1.2201607990980769e+01, 1.8651500443681677e+01, 1.8758157568004620e+01, 1.8276088095999114e+01, 1.1715361303018966e+01, 7.3684394621254015e+00, 2.4965418284512091e+00, 9.0332828533801224e-01},
-{4.9479835250075892e+00, 1.4691607003177602e+01, 2.9082414772101060e+01, 4.3179839108869331e+01, 4.8440791644688879e+01, 4.2310703962394342e+01, 2.7923434247706432e+01, 1.3822186510471010e+01, 4.5614664160654357e+00, 9.0332828533799958e-01},
-{6.1701893352279864e+00, 2.0127225876810336e+01, 4.2974193398071691e+01, 6.5958045321253465e+01, 7.5230437667866624e+01, 6.4630411355739881e+01, 4.1261591079244141e+01, 1.8936128791950541e+01, 5.6881982915180327e+00, 9.0332828533799836e-01},
-{7.4092912870072398e+00, 2.6857944460290135e+01, 6.1578787811202247e+01, 9.8258255839887340e+01, 1.1359460153696304e+02, 9.6280452143026153e+01, 5.9124742025776442e+01, 2.5268527576524235e+01, 6.8305064480743178e+00, 9.0332828533800158e-01},
-{8.5743055776347692e+00, 3.4306584753117903e+01, 8.4035290411037124e+01, 1.3928510844056831e+02, 1.6305115418161643e+02, 1.3648147221895812e+02, 8.0686288623299902e+01, 3.2276361903872186e+01, 7.9045143816244918e+00, 9.0332828533799903e-01}
-};
-
-//iir B Coefficients array
-const static double iirBCoefficientConstants[FILTER_FREQUENCY_COUNT][IIR_B_COEFFICIENT_COUNT] = {
-{9.0928661148176830e-10, 0.0000000000000000e+00, -4.5464330574088414e-09, 0.0000000000000000e+00, 9.0928661148176828e-09, 0.0000000000000000e+00, -9.0928661148176828e-09, 0.0000000000000000e+00, 4.5464330574088414e-09, 0.0000000000000000e+00, -9.0928661148176830e-10},
-{9.0928661148203093e-10, 0.0000000000000000e+00, -4.5464330574101550e-09, 0.0000000000000000e+00, 9.0928661148203099e-09, 0.0000000000000000e+00, -9.0928661148203099e-09, 0.0000000000000000e+00, 4.5464330574101550e-09, 0.0000000000000000e+00, -9.0928661148203093e-10},
-{9.0928661148196858e-10, 0.0000000000000000e+00, -4.5464330574098431e-09, 0.0000000000000000e+00, 9.0928661148196862e-09, 0.0000000000000000e+00, -9.0928661148196862e-09, 0.0000000000000000e+00, 4.5464330574098431e-09, 0.0000000000000000e+00, -9.0928661148196858e-10},
-{9.0928661148203424e-10, 0.0000000000000000e+00, -4.5464330574101715e-09, 0.0000000000000000e+00, 9.0928661148203430e-09, 0.0000000000000000e+00, -9.0928661148203430e-09, 0.0000000000000000e+00, 4.5464330574101715e-09, 0.0000000000000000e+00, -9.0928661148203424e-10},
-{9.0928661148203041e-10, 0.0000000000000000e+00, -4.5464330574101516e-09, 0.0000000000000000e+00, 9.0928661148203033e-09, 0.0000000000000000e+00, -9.0928661148203033e-09, 0.0000000000000000e+00, 4.5464330574101516e-09, 0.0000000000000000e+00, -9.0928661148203041e-10},
-{9.0928661148164309e-10, 0.0000000000000000e+00, -4.5464330574082152e-09, 0.0000000000000000e+00, 9.0928661148164304e-09, 0.0000000000000000e+00, -9.0928661148164304e-09, 0.0000000000000000e+00, 4.5464330574082152e-09, 0.0000000000000000e+00, -9.0928661148164309e-10},
-{9.0928661148193684e-10, 0.0000000000000000e+00, -4.5464330574096843e-09, 0.0000000000000000e+00, 9.0928661148193686e-09, 0.0000000000000000e+00, -9.0928661148193686e-09, 0.0000000000000000e+00, 4.5464330574096843e-09, 0.0000000000000000e+00, -9.0928661148193684e-10},
-{9.0928661148192133e-10, 0.0000000000000000e+00, -4.5464330574096065e-09, 0.0000000000000000e+00, 9.0928661148192131e-09, 0.0000000000000000e+00, -9.0928661148192131e-09, 0.0000000000000000e+00, 4.5464330574096065e-09, 0.0000000000000000e+00, -9.0928661148192133e-10},
-{9.0928661148181700e-10, 0.0000000000000000e+00, -4.5464330574090846e-09, 0.0000000000000000e+00, 9.0928661148181692e-09, 0.0000000000000000e+00, -9.0928661148181692e-09, 0.0000000000000000e+00, 4.5464330574090846e-09, 0.0000000000000000e+00, -9.0928661148181700e-10},
-{9.0928661148189248e-10, 0.0000000000000000e+00, -4.5464330574094626e-09, 0.0000000000000000e+00, 9.0928661148189252e-09, 0.0000000000000000e+00, -9.0928661148189252e-09, 0.0000000000000000e+00, 4.5464330574094626e-09, 0.0000000000000000e+00, -9.0928661148189248e-10}
-};
-
+// Inputs for the window-based FIR kernels. When the window fills up, the
+// newest FIR_FILTER_TAP_COUNT - 1 inputs are moved back to the start, so the
+// copy happens once every FIR_WINDOW_SIZE - FIR_FILTER_TAP_COUNT inputs.
+#define FIR_WINDOW_SIZE 1024
+#define FIR_WINDOW_ALIGNMENT 32
+#define IIR_SECTION_COUNT ((IIR_A_COEFFICIENT_COUNT + 1) / 2)
+
+//fir Coefficients array, designed at build time together with the iir
+//coefficients of the default frequency plan (see generateFilterTables.py)
+static const double *const firCoefficients = filterTables_firCoefficients;
+//the same taps as samples, for the queue and delay-line kernels; the table is
+//symmetric (linear phase), so those kernels run folded, see foldedFir()
+static sample_t firTaps[FIR_FILTER_TAP_COUNT];
+static bool firFolded;
+
+//iir coefficient arrays: the generated tables for the default frequency plan,
+//otherwise synthesized from the frequency plan by filter_init()
+static const double (*iirACoefficients)[IIR_A_COEFFICIENT_COUNT];
+static const double (*iirBCoefficients)[IIR_B_COEFFICIENT_COUNT];
+static double synthesizedIirACoefficients[FILTER_MAX_FREQUENCY_COUNT][IIR_A_COEFFICIENT_COUNT];
+static double synthesizedIirBCoefficients[FILTER_MAX_FREQUENCY_COUNT][IIR_B_COEFFICIENT_COUNT];
+static uint16_t filterCount;
+static uint16_t filterTickPeriods[FILTER_MAX_FREQUENCY_COUNT];
 
 //creating queues
-static queue_t zQueue[FILTER_IIR_FILTER_COUNT];	
+static queue_t zQueue[FILTER_MAX_FREQUENCY_COUNT];	
 static queue_t xQueue;	
 static queue_t yQueue;	
-static queue_t outputQueue[FILTER_IIR_FILTER_COUNT];
-static double computePowerValue[FILTER_IIR_FILTER_COUNT];
-static double oldestValue[FILTER_IIR_FILTER_COUNT];
+static queue_t outputQueue[FILTER_MAX_FREQUENCY_COUNT];
+static double computePowerValue[FILTER_MAX_FREQUENCY_COUNT];
+static double oldestValue[FILTER_MAX_FREQUENCY_COUNT];
+
+//power state for FILTER_POWER_TRACKER: the trackers replace the output queues,
+//so only one of the two is allocated. powerTrackerStorage holds the squares of
+//powerTrackerStorageCount filters, OUTPUT_QUEUE_SIZE apiece
+static filter_powerMethod_t powerMethod;
+static powerTracker_t powerTrackers[FILTER_MAX_FREQUENCY_COUNT];
+static float *powerTrackerStorage;
+static uint16_t powerTrackerStorageCount;
+
+//mirrored delay lines for FILTER_FIR_KERNEL_DELAY_LINE (xLine) and
+//FILTER_IIR_DELAY_LINE (yLine, zLine), see delayLine.h
+static delayLine_t xLine;
+static delayLine_t yLine;
+static delayLine_t zLine[FILTER_MAX_FREQUENCY_COUNT];
+static sample_t xLineStorage[2 * X_QUEUE_SIZE];
+static sample_t yLineStorage[2 * Y_QUEUE_SIZE];
+static sample_t zLineStorage[FILTER_MAX_FREQUENCY_COUNT][2 * Z_QUEUE_SIZE];
+
+//state for FILTER_FIR_KERNEL_CIC: the decimator and a delay line of its
+//outputs for the compensation FIR, which scales them back to the input range
+static cic_t cic;
+static delayLine_t cicLine;
+static sample_t cicLineStorage[2 * FILTER_TABLES_CIC_COMPENSATION_TAP_COUNT];
+static double cicOutputScale;
+
+//FIR kernel state: firWindow[firWindowEnd - 1] is the newest input and
+//firKernelFir holds firCoefficients[] installed for the kernel (folded, as
+//the table is symmetric)
+static filter_firKernel_t firKernel;
+static firKernel_fir_t firKernelFir;
+static float firWindow[FIR_WINDOW_SIZE] __attribute__((aligned(FIR_WINDOW_ALIGNMENT)));
+static uint32_t firWindowEnd;
+
+//IIR state for FILTER_IIR_BIQUAD: the latest FIR output is the input of every
+//cascade, so the biquads never read yQueue. Coefficients and transposed
+//direct-form II state (see biquad.h) are stored channel-interleaved, one array
+//per field indexed by filter number, so that filter_iirFilterBank() can run
+//all of the filters through a section in one loop that vectorizes
+typedef struct {
+    sample_t b0[FILTER_MAX_FREQUENCY_COUNT];
+    sample_t b1[FILTER_MAX_FREQUENCY_COUNT];
+    sample_t b2[FILTER_MAX_FREQUENCY_COUNT];
+    sample_t a1[FILTER_MAX_FREQUENCY_COUNT];
+    sample_t a2[FILTER_MAX_FREQUENCY_COUNT];
+    sample_t s1[FILTER_MAX_FREQUENCY_COUNT];
+    sample_t s2[FILTER_MAX_FREQUENCY_COUNT];
+} iirBankSection_t;
+static filter_iirStructure_t iirStructure;
+static bool iirSectionsConverted;
+static iirBankSection_t iirBank[IIR_SECTION_COUNT];
+static sample_t firOutput;
+
+//state for FILTER_IIR_SLIDING_DFT: one window of FIR outputs shared by all of
+//the bins; dftOldest is the output that the newest one replaced
+static slidingDft_bin_t dftBins[FILTER_MAX_FREQUENCY_COUNT];
+static double dftHistory[OUTPUT_QUEUE_SIZE];
+static uint32_t dftNewest;
+static double dftOldest;
 
 
  
+//empties a queue and fills it with zeros, keeping its storage
+static void zeroQueue(queue_t *q) {
+    queue_clear(q);
+    for (uint32_t j = 0; j < queue_size(q); j++)
+        queue_overwritePush(q, QUEUE_INIT_VALUE); //filling with zeros
+}
+
+//fills a queue with zeros; its storage is allocated the first time only, so
+//that filter_init() can be called again without leaking it
+static void initZeroedQueue(queue_t *q, queue_size_t size, const char *name) {
+    if (q->data == NULL)
+        queue_init(q, size, name);
+    zeroQueue(q);
+}
+
 //intializing zQueues to be filled with zeros
 static void initZQueues() {
-  for (uint32_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
-    queue_init(&(zQueue[i]), Z_QUEUE_SIZE, "zQueue");
-    for (uint32_t j = 0; j < Z_QUEUE_SIZE; j++)
-     queue_overwritePush(&(zQueue[i]), QUEUE_INIT_VALUE); //filling with zeros
-  }
+  for (uint32_t i = 0; i < filterCount; i++)
+    initZeroedQueue(&(zQueue[i]), Z_QUEUE_SIZE, "zQueue");
+}
+
+//refilling the zQueues that initZQueues() allocated with zeros
+static void clearZQueues() {
+  for (uint32_t i = 0; i < filterCount; i++)
+    zeroQueue(&(zQueue[i]));
 }
 
 //intializing xQueues to be filled with zeros
 static void initXQueues() {
-    queue_init(&(xQueue), X_QUEUE_SIZE, "xQueue");
-    for (uint32_t j = 0; j < X_QUEUE_SIZE; j++)
-     queue_overwritePush(&(xQueue), QUEUE_INIT_VALUE); //filling with zeros
-  
+    initZeroedQueue(&(xQueue), X_QUEUE_SIZE, "xQueue");
 }
 
 //intializing yQueues to be filled with zeros
 static void initYQueues() {
-    queue_init(&(yQueue), Y_QUEUE_SIZE, "yQueue");
-    for (uint32_t j = 0; j < Y_QUEUE_SIZE; j++)
-     queue_overwritePush(&(yQueue), QUEUE_INIT_VALUE); //filling with zeros
-  
+    initZeroedQueue(&(yQueue), Y_QUEUE_SIZE, "yQueue");
 }
 
 //intializing outputQueues to be filled with zeros
 void initOutputQueues() {
-  for (uint32_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
-    queue_init(&(outputQueue[i]), OUTPUT_QUEUE_SIZE, "outputQueue");
-    for (uint32_t j = 0; j < OUTPUT_QUEUE_SIZE; j++)
-     queue_overwritePush(&(outputQueue[i]), QUEUE_INIT_VALUE); //filling with zeros
-  }
+  for (uint32_t i = 0; i < filterCount; i++)
+    initZeroedQueue(&(outputQueue[i]), OUTPUT_QUEUE_SIZE, "outputQueue");
+}
+
+//freeing the outputQueues, which FILTER_POWER_TRACKER does not use; all of
+//them, in case an earlier frequency plan had more filters
+static void freeOutputQueues() {
+  for (uint32_t i = 0; i < FILTER_MAX_FREQUENCY_COUNT; i++)
+    if (outputQueue[i].data != NULL)
+      queue_garbageCollect(&(outputQueue[i]));
+}
+
+//intializing the power trackers to windows of zeros; their storage is
+//allocated for filterCount filters the first time only (or again if the
+//frequency plan grew), so that filter_init() can be called again without
+//leaking it
+static void initPowerTrackers() {
+    if (powerTrackerStorageCount < filterCount) {
+        free(powerTrackerStorage);
+        powerTrackerStorage = malloc((size_t)filterCount * OUTPUT_QUEUE_SIZE *
+                                     sizeof(powerTrackerStorage[0]));
+        if (powerTrackerStorage == NULL) {
+            printf("initPowerTrackers(): malloc failed\n");
+            assert(false);
+        }
+        powerTrackerStorageCount = filterCount;
+    }
+    for (uint16_t i = 0; i < filterCount; i++)
+        powerTracker_init(&powerTrackers[i],
+                          &powerTrackerStorage[(size_t)i * OUTPUT_QUEUE_SIZE],
+                          OUTPUT_QUEUE_SIZE);
+}
+
+//freeing the power tracker storage, which the other power methods do not use
+static void freePowerTrackers() {
+    free(powerTrackerStorage);
+    powerTrackerStorage = NULL;
+    powerTrackerStorageCount = 0;
+}
+
+//intializing the delay lines to be filled with zeros
+static void initDelayLines() {
+    delayLine_init(&xLine, xLineStorage, X_QUEUE_SIZE);
+    delayLine_init(&yLine, yLineStorage, Y_QUEUE_SIZE);
+    for (uint32_t i = 0; i < filterCount; i++)
+        delayLine_init(&zLine[i], zLineStorage[i], Z_QUEUE_SIZE);
 }
 
 //intializing outputQueues to be filled with zeros
 void initComputePowerQueues() {
-    for (uint32_t j = 0; j < FILTER_IIR_FILTER_COUNT; j++) {
+    for (uint32_t j = 0; j < filterCount; j++) {
         computePowerValue[j] = QUEUE_INIT_VALUE; //filling with zeros
         oldestValue[j] = QUEUE_INIT_VALUE; //filling with zeros
     }
@@ -184,54 +226,383 @@ void initComputePowerQueues() {
 }
 
 
+//selecting the bandpass filters for the frequency plan: the default plan uses
+//the generated tables, any other plan is synthesized; the biquads are
+//installed again the next time they are selected
+static void synthesizeIirCoefficients() {
+    filterCount = frequencyPlan_getChannelCount();
+    for (uint16_t i = 0; i < filterCount; i++)
+        filterTickPeriods[i] = frequencyPlan_getTickPeriod(i);
+    if (frequencyPlan_isDefault()) {
+        iirACoefficients = filterTables_iirACoefficients;
+        iirBCoefficients = filterTables_iirBCoefficients;
+    } else {
+        for (uint16_t i = 0; i < filterCount; i++)
+            frequencyPlan_synthesizeBandpass(filterTickPeriods[i],
+                                             synthesizedIirBCoefficients[i],
+                                             synthesizedIirACoefficients[i]);
+        iirACoefficients = (const double (*)[IIR_A_COEFFICIENT_COUNT])synthesizedIirACoefficients;
+        iirBCoefficients = (const double (*)[IIR_B_COEFFICIENT_COUNT])synthesizedIirBCoefficients;
+    }
+    iirSectionsConverted = false;
+}
+
+//selecting the FIR kernel and clearing its input window
+static void initFirKernel(filter_firKernel_t kernel) {
+    if (kernel == FILTER_FIR_KERNEL_BEST)
+        kernel = firKernel_getBest();
+    else if (kernel != FILTER_FIR_KERNEL_QUEUE && kernel != FILTER_FIR_KERNEL_DELAY_LINE &&
+             kernel != FILTER_FIR_KERNEL_CIC && !firKernel_isSupported(kernel))
+        kernel = FILTER_FIR_KERNEL_SCALAR;
+    firKernel = kernel;
+    for (uint16_t i = 0; i < FIR_FILTER_TAP_COUNT; i++)
+        firTaps[i] = firCoefficients[i];
+    firFolded = firKernel_isSymmetric(firCoefficients, FIR_FILTER_TAP_COUNT);
+    cic_init(&cic, FILTER_FIR_DECIMATION_FACTOR);
+    delayLine_init(&cicLine, cicLineStorage, FILTER_TABLES_CIC_COMPENSATION_TAP_COUNT);
+    cicOutputScale = 1.0 / ((double)cic.gain * CIC_INPUT_ONE);
+    if (firKernel_isSupported(kernel))
+        firKernel_install(&firKernelFir, kernel, firCoefficients,
+                          FIR_FILTER_TAP_COUNT, true);
+    memset(firWindow, 0, sizeof(firWindow));
+    firWindowEnd = FIR_FILTER_TAP_COUNT; //start with a full history of zeros
+}
+
 /******************************************************************************
 ***** Main Filter Functions
 ******************************************************************************/
 
 // Must call this prior to using any filter functions.
 void filter_init() {
+    filter_initWithFirKernel(FILTER_FIR_KERNEL_QUEUE);
+}
+
+// Same as filter_init() but selects the FIR implementation.
+filter_firKernel_t filter_initWithFirKernel(filter_firKernel_t kernel) {
+    synthesizeIirCoefficients();
+
     //initialize the x, y, z queues for filtering
     initXQueues();
     initYQueues();
     initZQueues();
+    initDelayLines();
     
     //initialize our double queues for the filtering
     initComputePowerQueues();
-    initOutputQueues();
+    initFirKernel(kernel);
+#ifdef FILTER_SINGLE_PRECISION
+    filter_setIirStructure(FILTER_IIR_BIQUAD);
+#else
+    iirStructure = FILTER_IIR_DIRECT_FORM;
+#endif
+    filter_setPowerMethod(FILTER_POWER_INCREMENTAL);
+    firOutput = QUEUE_INIT_VALUE;
+#ifdef FILTER_FIXED_POINT
+    filterFixed_init();
+#endif
+    return firKernel;
+}
+
+//records the latest FIR output as the input of the IIR filters; only the
+//direct form reads yQueue
+static void setFirOutput(double output) {
+    firOutput = output;
+    if (iirStructure == FILTER_IIR_DIRECT_FORM)
+        queue_overwritePushUnchecked(&(yQueue), output);
+    if (iirStructure == FILTER_IIR_DELAY_LINE)
+        delayLine_push(&yLine, output);
+    if (iirStructure == FILTER_IIR_SLIDING_DFT) {
+        if (++dftNewest == OUTPUT_QUEUE_SIZE)
+            dftNewest = 0;
+        dftOldest = dftHistory[dftNewest];
+        dftHistory[dftNewest] = output;
+    }
+}
+
+// Selects the IIR implementation and clears the IIR state.
+filter_iirStructure_t filter_setIirStructure(filter_iirStructure_t structure) {
+#ifdef FILTER_SINGLE_PRECISION
+    if (structure == FILTER_IIR_DIRECT_FORM || structure == FILTER_IIR_DELAY_LINE)
+        structure = FILTER_IIR_BIQUAD;
+#endif
+    if (structure == FILTER_IIR_BIQUAD && !iirSectionsConverted) {
+        iirSectionsConverted = true;
+        for (uint16_t i = 0; i < filterCount; i++) {
+            biquad_section_t synthesized[IIR_SECTION_COUNT];
+            const biquad_section_t *sections = filterTables_iirSections[i];
+            if (!frequencyPlan_isDefault()) {
+                frequencyPlan_synthesizeBiquads(filterTickPeriods[i], synthesized);
+                sections = synthesized;
+            }
+            for (uint16_t s = 0; s < IIR_SECTION_COUNT; s++) {
+                iirBank[s].b0[i] = sections[s].b0;
+                iirBank[s].b1[i] = sections[s].b1;
+                iirBank[s].b2[i] = sections[s].b2;
+                iirBank[s].a1[i] = sections[s].a1;
+                iirBank[s].a2[i] = sections[s].a2;
+            }
+        }
+    }
+    clearZQueues();
+    zeroQueue(&yQueue);
+    delayLine_clear(&yLine);
+    for (uint16_t i = 0; i < filterCount; i++)
+        delayLine_clear(&zLine[i]);
+    for (uint16_t s = 0; s < IIR_SECTION_COUNT; s++) {
+        memset(iirBank[s].s1, 0, sizeof(iirBank[s].s1));
+        memset(iirBank[s].s2, 0, sizeof(iirBank[s].s2));
+    }
+    for (uint16_t i = 0; i < filterCount; i++)
+        slidingDft_initBin(&dftBins[i],
+                           (double)DECIMATION_VALUE / filterTickPeriods[i],
+                           OUTPUT_QUEUE_SIZE);
+    memset(dftHistory, 0, sizeof(dftHistory));
+    dftNewest = 0;
+    dftOldest = QUEUE_INIT_VALUE;
+    iirStructure = structure;
+    return iirStructure;
+}
+
+//slides the newest inputs back to the start once the FIR window is full
+static void slideFullFirWindow() {
+    if (firWindowEnd == FIR_WINDOW_SIZE) {
+        memmove(firWindow, &firWindow[FIR_WINDOW_SIZE - (FIR_FILTER_TAP_COUNT - 1)],
+                (FIR_FILTER_TAP_COUNT - 1) * sizeof(firWindow[0]));
+        firWindowEnd = FIR_FILTER_TAP_COUNT - 1;
+    }
 }
 
 // Use this to copy an input into the input queue of the FIR-filter (xQueue).
 void filter_addNewInput(double x) {
-    queue_overwritePush(&(xQueue), x);
+#ifdef FILTER_FIXED_POINT
+    filterFixed_addNewInput(filterFixed_fromDouble(x));
+    return;
+#endif
+    if (firKernel == FILTER_FIR_KERNEL_QUEUE) {
+        queue_overwritePushUnchecked(&(xQueue), x);
+        return;
+    }
+    if (firKernel == FILTER_FIR_KERNEL_DELAY_LINE) {
+        delayLine_push(&xLine, x);
+        return;
+    }
+    if (firKernel == FILTER_FIR_KERNEL_CIC) {
+        cic_push(&cic, cic_fromDouble(x));
+        return;
+    }
+    slideFullFirWindow();
+    firWindow[firWindowEnd++] = x;
+}
+
+// Same as calling filter_addNewInput() on each input.
+void filter_addNewInputs(const double x[], uint32_t count) {
+#ifdef FILTER_FIXED_POINT
+    for (uint32_t i = 0; i < count; i++)
+        filterFixed_addNewInput(filterFixed_fromDouble(x[i]));
+    return;
+#endif
+    if (firKernel == FILTER_FIR_KERNEL_QUEUE) {
+        for (uint32_t i = 0; i < count; i++)
+            queue_overwritePushUnchecked(&(xQueue), x[i]);
+        return;
+    }
+    if (firKernel == FILTER_FIR_KERNEL_DELAY_LINE) {
+        for (uint32_t i = 0; i < count; i++)
+            delayLine_push(&xLine, x[i]);
+        return;
+    }
+    if (firKernel == FILTER_FIR_KERNEL_CIC) {
+        cic_pushBlock(&cic, x, count);
+        return;
+    }
+    while (count > 0) {
+        slideFullFirWindow();
+        //copy as much as fits before the window is full again
+        uint32_t copyCount = FIR_WINDOW_SIZE - firWindowEnd;
+        if (copyCount > count)
+            copyCount = count;
+        for (uint32_t i = 0; i < copyCount; i++)
+            firWindow[firWindowEnd + i] = x[i];
+        firWindowEnd += copyCount;
+        x += copyCount;
+        count -= copyCount;
+    }
+}
+
+//folded FIR over a window of inputs, x[0] oldest: the table is symmetric, so
+//tap i applies to x[last - i] and x[i] alike; the pair is added first and
+//each unique tap is multiplied once
+static inline sample_t foldedWindowFir(const sample_t *x) {
+    const uint16_t last = FIR_FILTER_TAP_COUNT - 1;
+    sample_t sum = 0.0;
+    for (uint16_t i = 0; i < FIR_FILTER_TAP_COUNT / 2; i++)
+        sum += (x[last - i] + x[i]) * firTaps[i];
+    if (FIR_FILTER_TAP_COUNT & 1)
+        sum += x[last / 2] * firTaps[last / 2];
+    return sum;
+}
+
+//the same over the (full) xQueue, where the window wraps around the array
+static inline sample_t foldedQueueFir(const queue_t *q) {
+    const uint16_t last = FIR_FILTER_TAP_COUNT - 1;
+    sample_t sum = 0.0;
+    for (uint16_t i = 0; i < FIR_FILTER_TAP_COUNT / 2; i++)
+        sum += (queue_readElementAtUnchecked(q, last - i) +
+                queue_readElementAtUnchecked(q, i)) * firTaps[i];
+    if (FIR_FILTER_TAP_COUNT & 1)
+        sum += queue_readElementAtUnchecked(q, last / 2) * firTaps[last / 2];
+    return sum;
 }
 
 // Invokes the FIR-filter. Input is contents of xQueue.
-// Output is returned and is also pushed on to yQueue.
+// Output is returned and, with FILTER_IIR_DIRECT_FORM, pushed on to yQueue.
 double filter_firFilter() {
-    queue_data_t newData;
+#ifdef FILTER_FIXED_POINT
+    return filterFixed_q15ToDouble(filterFixed_firFilter());
+#endif
     double total = 0.0;
-    for (uint16_t i = 0; i < FIR_FILTER_TAP_COUNT; i++) {
-        total +=  (queue_readElementAt(&(xQueue), (FIR_FILTER_TAP_COUNT - i - 1)) * firCoefficients[i]); //iterate through the xQueue and apply FIR filter
+    if (firKernel == FILTER_FIR_KERNEL_DELAY_LINE) {
+        if (firFolded) {
+            total = foldedWindowFir(delayLine_getWindow(&xLine));
+            setFirOutput(total);
+            return total;
+        }
+        //same order as the queue below: newest input times firCoefficients[0]
+        const sample_t *x = delayLine_getWindow(&xLine) + FIR_FILTER_TAP_COUNT - 1;
+        sample_t sum = 0.0;
+        for (uint16_t i = 0; i < FIR_FILTER_TAP_COUNT; i++)
+            sum += x[-i] * firTaps[i];
+        total = sum;
+        setFirOutput(total);
+        return total;
     }
-    newData = total;
-    queue_overwritePush(&(yQueue), newData);
+    if (firKernel == FILTER_FIR_KERNEL_CIC) {
+        //the CIC decimates, then the compensation FIR runs on its outputs; the
+        //compensation FIR is symmetric, so each coefficient is applied to a
+        //pair of outputs
+        delayLine_push(&cicLine, cic_decimate(&cic));
+        const sample_t *x = delayLine_getWindow(&cicLine);
+        const double *h = filterTables_cicCompensationCoefficients;
+        const uint16_t last = FILTER_TABLES_CIC_COMPENSATION_TAP_COUNT - 1;
+        for (uint16_t i = 0; i < last / 2; i++)
+            total += (x[i] + x[last - i]) * h[i];
+        total = (total + x[last / 2] * h[last / 2]) * cicOutputScale;
+        setFirOutput(total);
+        return total;
+    }
+    if (firKernel != FILTER_FIR_KERNEL_QUEUE) {
+        total = firKernel_run(&firKernelFir,
+                              &firWindow[firWindowEnd - FIR_FILTER_TAP_COUNT]);
+        setFirOutput(total);
+        return total;
+    }
+    if (firFolded) {
+        total = foldedQueueFir(&xQueue);
+        setFirOutput(total);
+        return total;
+    }
+    //Walk the (full) xQueue newest to oldest straight over its memory: the
+    //element k places from the newest is multiplied by firCoefficients[k]
+    queue_span_t spans[2];
+    queue_getSpans(&xQueue, spans);
+    const sample_t *h = firTaps;
+    sample_t sum = 0.0;
+    for (int32_t s = 1; s >= 0; s--) {
+        for (int32_t k = (int32_t)spans[s].count - 1; k >= 0; k--)
+            sum += spans[s].data[k] * *h++;
+    }
+    total = sum;
+    setFirOutput(total);
     return total;
 }
 
+// Selects how filter_computePower() works and clears the power state.
+// Only the storage of the selected method stays allocated.
+void filter_setPowerMethod(filter_powerMethod_t method) {
+    if (method == FILTER_POWER_TRACKER) {
+        freeOutputQueues();
+        initPowerTrackers();
+    } else {
+        freePowerTrackers();
+        initOutputQueues();
+    }
+    initComputePowerQueues();
+    powerMethod = method;
+}
+
+// Also tracks the power of every filter over short windows.
+void filter_setShortPowerWindows(const uint32_t lengths[], uint16_t count) {
+    if (powerMethod != FILTER_POWER_TRACKER)
+        return; //the trackers have no storage
+    for (uint16_t i = 0; i < filterCount; i++)
+        powerTracker_setShortWindows(&powerTrackers[i], lengths, count);
+}
+
+// Copies the power of every filter over short window [window].
+void filter_getShortWindowPowerValues(uint16_t window, double powerValues[]) {
+    for (uint16_t i = 0; i < filterCount; i++)
+        powerValues[i] = powerTracker_getShortWindowPower(&powerTrackers[i], window);
+}
+
+//records an output of IIR filter [filterNumber] for filter_computePower()
+static inline void addIirOutput(uint16_t filterNumber, double output) {
+    if (powerMethod == FILTER_POWER_TRACKER)
+        powerTracker_add(&powerTrackers[filterNumber], output);
+    else
+        queue_overwritePushUnchecked(&(outputQueue[filterNumber]), output);
+}
+
 // Use this to invoke a single iir filter. Input comes from yQueue.
 // Output is returned and is also pushed onto zQueue[filterNumber].
 double filter_iirFilter(uint16_t filterNumber) {
+#ifdef FILTER_FIXED_POINT
+    return filterFixed_q31ToDouble(filterFixed_iirFilter(filterNumber));
+#endif
     queue_data_t newData;
     double total = 0.0;
-    total += iirBCoefficientConstants[filterNumber][IIR_B_COEFFICIENT_COUNT-1] * queue_readElementAt(&(yQueue), 0);
+    if (iirStructure == FILTER_IIR_BIQUAD) {
+        sample_t y = firOutput;
+        for (uint16_t s = 0; s < IIR_SECTION_COUNT; s++) {
+            //biquad_filter() on the interleaved section, see filter_iirFilterBank()
+            iirBankSection_t *section = &iirBank[s];
+            sample_t x = y;
+            y = section->b0[filterNumber] * x + section->s1[filterNumber];
+            section->s1[filterNumber] = section->b1[filterNumber] * x -
+                section->a1[filterNumber] * y + section->s2[filterNumber];
+            section->s2[filterNumber] = section->b2[filterNumber] * x -
+                section->a2[filterNumber] * y;
+        }
+        total = y;
+        addIirOutput(filterNumber, total);
+        return total;
+    }
+    if (iirStructure == FILTER_IIR_SLIDING_DFT) {
+        slidingDft_update(&dftBins[filterNumber], firOutput, dftOldest);
+        return dftBins[filterNumber].real;
+    }
+    if (iirStructure == FILTER_IIR_DELAY_LINE) {
+        //same order as the queues below, oldest samples first in y[] and z[]
+        const sample_t *y = delayLine_getWindow(&yLine);
+        const sample_t *z = delayLine_getWindow(&zLine[filterNumber]);
+        const double *b = iirBCoefficients[filterNumber];
+        const double *a = iirACoefficients[filterNumber];
+        total = b[IIR_B_COEFFICIENT_COUNT - 1] * y[0];
+        for (uint16_t i = 0; i < IIR_A_COEFFICIENT_COUNT; i++)
+            total += (y[IIR_B_COEFFICIENT_COUNT - i - 1] * b[i]) -
+                     (z[IIR_A_COEFFICIENT_COUNT - i - 1] * a[i]);
+        delayLine_push(&zLine[filterNumber], total);
+        addIirOutput(filterNumber, total);
+        return total;
+    }
+    total += iirBCoefficients[filterNumber][IIR_B_COEFFICIENT_COUNT-1] * queue_readElementAtUnchecked(&(yQueue), 0);
     //iterate through the yQueue and apply iir filter
     for (uint16_t i = 0; i < IIR_A_COEFFICIENT_COUNT; i++) {
-        total +=  ((queue_readElementAt(&(yQueue), (IIR_B_COEFFICIENT_COUNT - i - 1)) * iirBCoefficientConstants[filterNumber][i]) - (queue_readElementAt(&(zQueue[filterNumber]), (IIR_A_COEFFICIENT_COUNT - i - 1)) * iirACoefficientConstants[filterNumber][i]));
+        total +=  ((queue_readElementAtUnchecked(&(yQueue), (IIR_B_COEFFICIENT_COUNT - i - 1)) * iirBCoefficients[filterNumber][i]) - (queue_readElementAtUnchecked(&(zQueue[filterNumber]), (IIR_A_COEFFICIENT_COUNT - i - 1)) * iirACoefficients[filterNumber][i]));
     }
     newData = total;
     //Overwrite the data for both zQueue and outputQueue
-    queue_overwritePush(&(zQueue[filterNumber]), newData);
-    queue_overwritePush(&(outputQueue[filterNumber]),newData);
+    queue_overwritePushUnchecked(&(zQueue[filterNumber]), newData);
+    addIirOutput(filterNumber, newData);
     return total;
 }
 
@@ -249,24 +620,98 @@ double filter_iirFilter(uint16_t filterNumber) {
 // (newest-value * newest-value). Note that this function will probably need an
 // array to keep track of these values for each of the 10 output queues.
 double filter_computePower(uint16_t filterNumber, bool forceComputeFromScratch, bool debugPrint) {
+#ifdef FILTER_FIXED_POINT
+    computePowerValue[filterNumber] = filterFixed_powerToDouble(
+        filterFixed_computePower(filterNumber, forceComputeFromScratch));
+    return computePowerValue[filterNumber];
+#endif
+    if (iirStructure == FILTER_IIR_SLIDING_DFT) {
+        //the oldest sample in the window is the one after the newest
+        if (forceComputeFromScratch)
+            slidingDft_recompute(&dftBins[filterNumber], dftHistory, OUTPUT_QUEUE_SIZE,
+                                 (dftNewest + 1) % OUTPUT_QUEUE_SIZE);
+        computePowerValue[filterNumber] =
+            slidingDft_getPower(&dftBins[filterNumber], OUTPUT_QUEUE_SIZE);
+        return computePowerValue[filterNumber];
+    }
+    if (powerMethod == FILTER_POWER_TRACKER) {
+        computePowerValue[filterNumber] = powerTracker_getPower(&powerTrackers[filterNumber]);
+        return computePowerValue[filterNumber];
+    }
     double total = 0.0;
     //If forceComputeFromScratch = true, compute from all values in outputQueue
     if (forceComputeFromScratch) {
-        for (uint16_t i = 0; i < OUTPUT_QUEUE_SIZE; i++) {
-            total += queue_readElementAt(&outputQueue[filterNumber], i) * queue_readElementAt(&outputQueue[filterNumber], i); //Adding up total when force == 1
+        queue_span_t spans[2];
+        queue_getSpans(&outputQueue[filterNumber], spans);
+        for (uint32_t s = 0; s < 2; s++) {
+            for (queue_size_t i = 0; i < spans[s].count; i++)
+                total += (double)spans[s].data[i] * spans[s].data[i]; //Adding up total when force == 1
         }
         //Adding our total into the filter
         computePowerValue[filterNumber] = total;
-        oldestValue[filterNumber] = queue_readElementAt(&outputQueue[filterNumber], 0);
+        oldestValue[filterNumber] = queue_readElementAtUnchecked(&outputQueue[filterNumber], 0);
         return total; //Skip the else statement
         }
     //Setting up total if force != 1
-    total = computePowerValue[filterNumber] - (oldestValue[filterNumber] * oldestValue[filterNumber]) + (queue_readElementAt(&outputQueue[filterNumber], OUTPUT_QUEUE_SIZE - 1) * queue_readElementAt(&outputQueue[filterNumber], OUTPUT_QUEUE_SIZE - 1));
-    oldestValue[filterNumber] = queue_readElementAt(&outputQueue[filterNumber], 0);
+    double newestValue = queue_readElementAtUnchecked(&outputQueue[filterNumber], OUTPUT_QUEUE_SIZE - 1);
+    total = computePowerValue[filterNumber] - (oldestValue[filterNumber] * oldestValue[filterNumber]) + (newestValue * newestValue);
+    oldestValue[filterNumber] = queue_readElementAtUnchecked(&outputQueue[filterNumber], 0);
     computePowerValue[filterNumber] = total; // Adding total to our array
     return total;
 }
 
+// Runs filter_iirFilter() and then filter_computePower() on every filter.
+void filter_iirFilterBank(bool forceComputeFromScratch) {
+#ifndef FILTER_FIXED_POINT
+    if (iirStructure == FILTER_IIR_BIQUAD) {
+        //every section of every filter in lockstep: each loop over the filters
+        //is the same biquad_filter() arithmetic on independent lanes
+        sample_t y[FILTER_MAX_FREQUENCY_COUNT];
+        for (uint16_t i = 0; i < filterCount; i++)
+            y[i] = firOutput;
+        for (uint16_t s = 0; s < IIR_SECTION_COUNT; s++) {
+            iirBankSection_t *section = &iirBank[s];
+            for (uint16_t i = 0; i < filterCount; i++) {
+                sample_t x = y[i];
+                y[i] = section->b0[i] * x + section->s1[i];
+                section->s1[i] = section->b1[i] * x - section->a1[i] * y[i] + section->s2[i];
+                section->s2[i] = section->b2[i] * x - section->a2[i] * y[i];
+            }
+        }
+        if (powerMethod == FILTER_POWER_TRACKER) {
+            for (uint16_t i = 0; i < filterCount; i++) {
+                powerTracker_add(&powerTrackers[i], y[i]);
+                computePowerValue[i] = powerTracker_getPower(&powerTrackers[i]);
+            }
+            return;
+        }
+        for (uint16_t i = 0; i < filterCount; i++)
+            queue_overwritePushUnchecked(&(outputQueue[i]), y[i]);
+        if (!forceComputeFromScratch) {
+            //the same update as filter_computePower(), fused across the filters
+            for (uint16_t i = 0; i < filterCount; i++)
+                computePowerValue[i] = computePowerValue[i] -
+                    (oldestValue[i] * oldestValue[i]) + ((double)y[i] * y[i]);
+            for (uint16_t i = 0; i < filterCount; i++)
+                oldestValue[i] = queue_readElementAtUnchecked(&outputQueue[i], 0);
+            return;
+        }
+        for (uint16_t i = 0; i < filterCount; i++)
+            filter_computePower(i, true, false);
+        return;
+    }
+#endif
+    for (uint16_t i = 0; i < filterCount; i++) {
+        filter_iirFilter(i);
+        filter_computePower(i, forceComputeFromScratch, false);
+    }
+}
+
+// Returns the number of player frequencies (filters).
+uint16_t filter_getFrequencyCount() {
+    return filterCount;
+}
+
 // Returns the last-computed output power value for the IIR filter
 // [filterNumber].
 double filter_getCurrentPowerValue(uint16_t filterNumber) {
@@ -285,7 +730,7 @@ void filter_setCurrentPowerValue(uint16_t filterNumber, double value) {
 // detector. Remember that when you pass an array into a C function, changes to
 // the array within that function are reflected in the returned array.
 void filter_getCurrentPowerValues(double powerValues[]) {
-    for (uint16_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
+    for (uint16_t i = 0; i < filterCount; i++) {
         powerValues[i] = computePowerValue[i];
     }
 }
@@ -300,14 +745,14 @@ void filter_getCurrentPowerValues(double powerValues[]) {
 void filter_getNormalizedPowerValues(double normalizedArray[], uint16_t *indexOfMaxValue) {
     uint16_t maxIndex = 0;
     //Iterate through power values and find max index
-    for (uint16_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
+    for (uint16_t i = 0; i < filterCount; i++) {
         if (computePowerValue[i] > computePowerValue[maxIndex]) {
             maxIndex = i;
         }
     }
 
     //Copy normalized power values into normalizedArray
-    for (uint16_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
+    for (uint16_t i = 0; i < filterCount; i++) {
         if (computePowerValue[maxIndex] != 0) {
             normalizedArray[i] = computePowerValue[i] / computePowerValue[maxIndex];
         }
@@ -338,7 +783,7 @@ uint32_t filter_getFirCoefficientCount() {
 
 // Returns the array of coefficients for a particular filter number.
 const double *filter_getIirACoefficientArray(uint16_t filterNumber) {
-    return iirACoefficientConstants[filterNumber];
+    return iirACoefficients[filterNumber];
 }
 
 // Returns the number of A coefficients.
@@ -348,7 +793,7 @@ uint32_t filter_getIirACoefficientCount() {
 
 // Returns the array of coefficients for a particular filter number.
 const double *filter_getIirBCoefficientArray(uint16_t filterNumber) {
-    return iirBCoefficientConstants[filterNumber];
+    return iirBCoefficients[filterNumber];
 }
 
 // Returns the number of B coefficients.
@@ -385,3 +830,9 @@ queue_t *filter_getZQueue(uint16_t filterNumber) {
 queue_t *filter_getIirOutputQueue(uint16_t filterNumber) {
     return &outputQueue[filterNumber];
 }
+
+// Runs the queue and delay-line FIR folded where the table allows.
+bool filter_setFirFolding(bool fold) {
+    firFolded = fold && firKernel_isSymmetric(firCoefficients, FIR_FILTER_TAP_COUNT);
+    return firFolded;
+}
@@ -12,17 +12,22 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 
 #include <stdint.h>
 
+#include "frequencyPlan.h"
 #include "queue.h"
 
 #define FILTER_SAMPLE_FREQUENCY_IN_KHZ 100
+// The default frequency plan, see frequencyPlan.h. filter_getFrequencyCount()
+// returns the number of frequencies in the plan that is actually in use.
 #define FILTER_FREQUENCY_COUNT 10
+#define FILTER_MAX_FREQUENCY_COUNT FREQUENCY_PLAN_MAX_CHANNEL_COUNT
 #define FILTER_FIR_DECIMATION_FACTOR                                           \
   10 // FIR-filter needs this many new inputs to compute a new output.
 #define FILTER_INPUT_PULSE_WIDTH                                               \
   2000 // This is the width of the pulse you are looking for, in terms of
        // decimated sample count.
 // These are the tick counts that are used to generate the user frequencies.
-// Not used in filter.h but are used to TEST the filter code.
+// The build designs the filter coefficients from them, so retuning a frequency
+// only takes an edit here.
 // Placed here for general access as they are essentially constant throughout
 // the code. The transmitter will also use these.
 static const uint16_t filter_frequencyTickTable[FILTER_FREQUENCY_COUNT] = {
@@ -33,21 +38,125 @@ static const uint16_t filter_frequencyTickTable[FILTER_FREQUENCY_COUNT] = {
 
 // 1. First filter is a decimating FIR filter with a configurable number of taps
 // and decimation factor.
-// 2. The output from the decimating FIR filter is passed through a bank of 10
-// IIR filters. The characteristics of the IIR filter are fixed.
+// 2. The output from the decimating FIR filter is passed through a bank of IIR
+// bandpass filters, one per player frequency in the frequency plan (see
+// frequencyPlan.h). The coefficients of the FIR filter and of the bandpass
+// filters for the default plan are designed at build time from the tick
+// table above (see generateFilterTables.py); filter_init() synthesizes the bandpass
+// filters of any other plan.
 
 /******************************************************************************
 ***** Main Filter Functions
 ******************************************************************************/
 
+// Implementations of the FIR filter, see filter_initWithFirKernel().
+typedef enum {
+  FILTER_FIR_KERNEL_QUEUE,      // Double precision over xQueue (the reference).
+  FILTER_FIR_KERNEL_DELAY_LINE, // Same, over a mirrored delay line.
+  FILTER_FIR_KERNEL_SCALAR,     // Single precision over a contiguous window.
+  FILTER_FIR_KERNEL_SSE,        // Same, vectorized for x86 hosts.
+  FILTER_FIR_KERNEL_AVX,        // Same, vectorized for x86 hosts with AVX.
+  FILTER_FIR_KERNEL_NEON,       // Same, vectorized for the Cortex-A9.
+  FILTER_FIR_KERNEL_CIC,        // CIC decimator and compensation FIR.
+  FILTER_FIR_KERNEL_BEST        // The fastest kernel supported by this build.
+} filter_firKernel_t;
+
 // Must call this prior to using any filter functions.
+// Uses FILTER_FIR_KERNEL_QUEUE, which is what the filter tests verify: they
+// read xQueue, which the faster kernels do not update. detector_init() selects
+// FILTER_FIR_KERNEL_BEST.
+// Synthesizes one IIR filter for every frequency in the current frequency plan.
 void filter_init();
 
+// Same as filter_init() but selects the FIR implementation. The window-based
+// kernels keep the inputs in a contiguous array instead of xQueue, so xQueue
+// is not updated. FILTER_FIR_KERNEL_DELAY_LINE keeps them in a mirrored delay
+// line (see delayLine.h) and gives the same results as the reference.
+// FILTER_FIR_KERNEL_CIC replaces the FIR with a different front end: a CIC
+// decimator (see cic.h) that only adds as the inputs come in, and a
+// FILTER_TABLES_CIC_COMPENSATION_TAP_COUNT-tap FIR at the decimated rate that
+// makes the pair match the FIR's passband (see generateFilterTables.py). On the
+// x86 host it costs about 2.5x less per output than FILTER_FIR_KERNEL_QUEUE,
+// the same as the AVX kernel: about half is the integrators (four dependent
+// adds per input), the rest the combs and the compensation FIR.
+// FILTER_FIR_KERNEL_BEST picks the fastest kernel of the FIR itself, never
+// FILTER_FIR_KERNEL_CIC. Unsupported kernels fall back to
+// FILTER_FIR_KERNEL_SCALAR.
+// All of the FIR kernels run folded, as the table is symmetric (see
+// firKernel.h and filter_setFirFolding()). On the x86 host, one FIR output
+// with its 10 inputs (filter_addNewInputs() and filter_firFilter(), as in the
+// detector) costs about 1.5x (scalar), 2.3x (SSE) and 2.4x (AVX) less than
+// with FILTER_FIR_KERNEL_QUEUE, see filterTest_runFirKernelBenchmark(). The
+// AVX kernel alone is about 4x cheaper than the queue loop; most of the rest
+// is copying the inputs into the window.
+// Returns the kernel that was selected.
+filter_firKernel_t filter_initWithFirKernel(filter_firKernel_t kernel);
+
+// Implementations of the IIR filters, see filter_setIirStructure().
+typedef enum {
+  FILTER_IIR_DIRECT_FORM, // 10th order over yQueue and zQueue (the reference).
+  FILTER_IIR_DELAY_LINE,  // Same, over mirrored delay lines.
+  FILTER_IIR_BIQUAD,      // Five biquads with transposed direct-form II state.
+  FILTER_IIR_SLIDING_DFT  // A sliding DFT bin at each player frequency.
+} filter_iirStructure_t;
+
+// Selects the IIR implementation and clears the IIR state. filter_init() and
+// filter_initWithFirKernel() select FILTER_IIR_DIRECT_FORM, so call this after
+// them. The biquad coefficients are synthesized from the poles of the
+// frequency plan's bandpass filters (see frequencyPlan.h) the first time they
+// are needed; the biquad filters do not update zQueue.
+// FILTER_IIR_DELAY_LINE computes the same direct-form filters over mirrored
+// delay lines (see delayLine.h) fed by filter_firFilter(), so it neither reads
+// yQueue nor updates zQueue.
+// FILTER_IIR_SLIDING_DFT replaces the bandpass filters with one DFT bin per
+// frequency over the 2000-sample power window (see slidingDft.h): there
+// is one shared window of FIR outputs instead of ten output queues, and
+// filter_computePower() returns the bin power, on the same scale as the power
+// of the bandpass filters. filter_iirFilter() then returns the real part of
+// the bin and updates neither zQueue nor the output queues.
+// The single-precision build (see sample.h) selects FILTER_IIR_BIQUAD in place
+// of both direct forms, including in filter_init().
+// Returns the structure that was selected.
+filter_iirStructure_t filter_setIirStructure(filter_iirStructure_t structure);
+
+// Ways to compute the output power, see filter_setPowerMethod().
+typedef enum {
+  FILTER_POWER_INCREMENTAL, // prev - oldest^2 + newest^2 over the output queues.
+  FILTER_POWER_TRACKER      // Exact integer sum of squares (see powerTracker.h).
+} filter_powerMethod_t;
+
+// Selects how filter_computePower() works and clears the power state.
+// filter_init() and filter_initWithFirKernel() select FILTER_POWER_INCREMENTAL.
+// With FILTER_POWER_TRACKER the IIR outputs go into a ring of fixed-point
+// squares instead of the output queues, the running sum cannot drift, and
+// forceComputeFromScratch is not needed (it is ignored). Does not apply to
+// FILTER_IIR_SLIDING_DFT, which computes power from the DFT bins.
+// Only the storage of the selected method is kept: FILTER_POWER_TRACKER frees
+// the output queues (see filter_getIirOutputQueue()) and allocates the
+// trackers for the filters of the frequency plan, the other methods do the
+// reverse.
+void filter_setPowerMethod(filter_powerMethod_t method);
+
+// With FILTER_POWER_TRACKER, also tracks the power of every filter over the
+// newest lengths[i] outputs, for count (at most
+// POWER_TRACKER_MAX_SHORT_WINDOWS, see powerTracker.h) windows shorter than the
+// 2000-output power window. Cleared by filter_setPowerMethod().
+void filter_setShortPowerWindows(const uint32_t lengths[], uint16_t count);
+
+// Copies the power of every filter over short window [window] into
+// powerValues[]. Only valid with FILTER_POWER_TRACKER and an IIR structure
+// other than FILTER_IIR_SLIDING_DFT.
+void filter_getShortWindowPowerValues(uint16_t window, double powerValues[]);
+
 // Use this to copy an input into the input queue of the FIR-filter (xQueue).
 void filter_addNewInput(double x);
 
+// Same as calling filter_addNewInput() on x[0] through x[count - 1]. The
+// window-based FIR kernels copy the whole block at once.
+void filter_addNewInputs(const double x[], uint32_t count);
+
 // Invokes the FIR-filter. Input is contents of xQueue.
-// Output is returned and is also pushed on to yQueue.
+// Output is returned and, with FILTER_IIR_DIRECT_FORM, pushed on to yQueue.
 double filter_firFilter();
 
 // Use this to invoke a single iir filter. Input comes from yQueue.
@@ -70,6 +179,16 @@ double filter_iirFilter(uint16_t filterNumber);
 double filter_computePower(uint16_t filterNumber, bool forceComputeFromScratch,
                            bool debugPrint);
 
+// Runs filter_iirFilter() and then filter_computePower() on every filter, with
+// the same results. With FILTER_IIR_BIQUAD the filters run in lockstep: one
+// pass through the five sections updates all of them, and the power update is
+// fused into the same call.
+void filter_iirFilterBank(bool forceComputeFromScratch);
+
+// Returns the number of player frequencies, and IIR filters, in the frequency
+// plan that was in effect at the last filter_init().
+uint16_t filter_getFrequencyCount();
+
 // Returns the last-computed output power value for the IIR filter
 // [filterNumber].
 double filter_getCurrentPowerValue(uint16_t filterNumber);
@@ -135,6 +254,12 @@ queue_t *filter_getYQueue();
 queue_t *filter_getZQueue(uint16_t filterNumber);
 
 // Returns the address of the IIR output-queue for a specific filter-number.
+// Its storage is not allocated with FILTER_POWER_TRACKER.
 queue_t *filter_getIirOutputQueue(uint16_t filterNumber);
 
+// Runs FILTER_FIR_KERNEL_QUEUE and FILTER_FIR_KERNEL_DELAY_LINE folded if fold
+// is true and the FIR table is symmetric, which filter_init() selects, or
+// with the general loops otherwise. Returns true if the FIR runs folded.
+bool filter_setFirFolding(bool fold);
+
 #endif /* FILTER_H_ */
\ No newline at end of file
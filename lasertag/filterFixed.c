@@ -0,0 +1,240 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "biquad.h"
+#include "filterFixed.h"
+#include "filterTables.h"
+
+#define FIR_TAP_COUNT FILTER_TABLES_FIR_TAP_COUNT
+#define OUTPUT_RING_SIZE 2000 // Same window as the double implementation.
+#define Q15_ONE (1 << 15)
+#define Q30_ONE (1 << 30)
+#define Q15_TO_Q31_SHIFT 16
+#define Q30_PRODUCT_SHIFT 30 // Q31 * Q30 -> Q61 -> Q31.
+#define POWER_SAMPLE_SHIFT 8 // IIR outputs are squared as Q23.
+#define POWER_SAMPLE_FRACTION_BITS (31 - POWER_SAMPLE_SHIFT)
+
+// Direct-form I state for one biquad.
+typedef struct {
+    filterFixed_q31_t x1, x2;
+    filterFixed_q31_t y1, y2;
+} biquadState_t;
+
+static filterFixed_q15_t firCoefficients[FIR_TAP_COUNT];
+static filterFixed_biquad_t iirSections[FILTER_MAX_FREQUENCY_COUNT]
+                                       [FILTER_FIXED_IIR_SECTION_COUNT];
+
+// FIR input history. xHistory[xNewest] is the most recent input.
+static filterFixed_q15_t xHistory[FIR_TAP_COUNT];
+static uint32_t xNewest;
+// Most recent FIR output, which is the input to all of the IIR filters.
+static filterFixed_q31_t firOutput;
+static biquadState_t iirState[FILTER_MAX_FREQUENCY_COUNT]
+                             [FILTER_FIXED_IIR_SECTION_COUNT];
+
+// Ring of recent IIR outputs (Q23) for each filter and the value that the
+// latest output replaced, for incremental power. The rings of
+// outputRingFilterCount filters, OUTPUT_RING_SIZE apiece, share one
+// allocation.
+static int32_t *outputRing;
+static uint16_t outputRingFilterCount;
+static uint32_t outputNewest[FILTER_MAX_FREQUENCY_COUNT];
+static int32_t replacedOutput[FILTER_MAX_FREQUENCY_COUNT];
+static filterFixed_power_t computePowerValue[FILTER_MAX_FREQUENCY_COUNT];
+
+// Rounds to the nearest integer and clamps to [min, max].
+static int64_t roundAndSaturate(double x, int64_t min, int64_t max) {
+    double rounded = round(x);
+    if (rounded < min)
+        return min;
+    if (rounded > max)
+        return max;
+    return (int64_t)rounded;
+}
+
+static filterFixed_q31_t saturateQ31(int64_t x) {
+    if (x > INT32_MAX)
+        return INT32_MAX;
+    if (x < INT32_MIN)
+        return INT32_MIN;
+    return (filterFixed_q31_t)x;
+}
+
+// Converts a double coefficient to Q30.
+static int32_t toQ30(double x) {
+    return roundAndSaturate(x * Q30_ONE, INT32_MIN, INT32_MAX);
+}
+
+// Copies the generated Q15 FIR coefficients and, for the default frequency
+// plan, the generated Q30 biquads; the biquads of any other plan are
+// synthesized and quantized here.
+static bool initCoefficients() {
+    for (uint32_t i = 0; i < FIR_TAP_COUNT; i++)
+        firCoefficients[i] = filterTables_firCoefficientsQ15[i];
+
+    for (uint16_t filter = 0; filter < filter_getFrequencyCount(); filter++) {
+        if (frequencyPlan_isDefault()) {
+            for (uint32_t s = 0; s < FILTER_FIXED_IIR_SECTION_COUNT; s++)
+                iirSections[filter][s] = filterTables_iirSectionsQ30[filter][s];
+            continue;
+        }
+        biquad_section_t sections[FILTER_FIXED_IIR_SECTION_COUNT];
+        frequencyPlan_synthesizeBiquads(frequencyPlan_getTickPeriod(filter), sections);
+        for (uint32_t s = 0; s < FILTER_FIXED_IIR_SECTION_COUNT; s++) {
+            filterFixed_biquad_t *q = &iirSections[filter][s];
+            q->b[0] = toQ30(sections[s].b0);
+            q->b[1] = toQ30(sections[s].b1);
+            q->b[2] = toQ30(sections[s].b2);
+            q->a[0] = toQ30(sections[s].a1);
+            q->a[1] = toQ30(sections[s].a2);
+        }
+    }
+    return true;
+}
+
+// Returns the output ring of a filter.
+static inline int32_t *getOutputRing(uint16_t filterNumber) {
+    return &outputRing[(size_t)filterNumber * OUTPUT_RING_SIZE];
+}
+
+// Allocates the output rings for the filters of the frequency plan the first
+// time only (or again if the plan grew), so that filterFixed_init() can be
+// called again without leaking them.
+static void allocateOutputRings() {
+    uint16_t filterCount = filter_getFrequencyCount();
+    if (outputRingFilterCount >= filterCount)
+        return;
+    free(outputRing);
+    outputRing = malloc((size_t)filterCount * OUTPUT_RING_SIZE * sizeof(outputRing[0]));
+    if (outputRing == NULL) {
+        printf("filterFixed_init(): malloc failed\n");
+        assert(false);
+    }
+    outputRingFilterCount = filterCount;
+}
+
+// Loads the coefficient tables and clears all filter state.
+bool filterFixed_init() {
+    allocateOutputRings();
+    for (uint32_t i = 0; i < FIR_TAP_COUNT; i++)
+        xHistory[i] = 0;
+    xNewest = 0;
+    firOutput = 0;
+    for (uint16_t filter = 0; filter < filter_getFrequencyCount(); filter++) {
+        for (uint32_t s = 0; s < FILTER_FIXED_IIR_SECTION_COUNT; s++)
+            iirState[filter][s] = (biquadState_t){0, 0, 0, 0};
+        for (uint32_t i = 0; i < OUTPUT_RING_SIZE; i++)
+            getOutputRing(filter)[i] = 0;
+        outputNewest[filter] = 0;
+        replacedOutput[filter] = 0;
+        computePowerValue[filter] = 0;
+    }
+    return initCoefficients();
+}
+
+// Converts x to Q15 with FILTER_FIXED_HEADROOM_BITS of headroom.
+filterFixed_q15_t filterFixed_fromDouble(double x) {
+    return roundAndSaturate(ldexp(x, 15 - FILTER_FIXED_HEADROOM_BITS), INT16_MIN,
+                            INT16_MAX);
+}
+
+double filterFixed_q15ToDouble(filterFixed_q15_t x) {
+    return ldexp(x, FILTER_FIXED_HEADROOM_BITS - 15);
+}
+
+double filterFixed_q31ToDouble(filterFixed_q31_t x) {
+    return ldexp(x, FILTER_FIXED_HEADROOM_BITS - 31);
+}
+
+double filterFixed_powerToDouble(filterFixed_power_t power) {
+    return ldexp((double)power,
+                 2 * (FILTER_FIXED_HEADROOM_BITS - POWER_SAMPLE_FRACTION_BITS));
+}
+
+// Use this to copy an input into the FIR history.
+void filterFixed_addNewInput(filterFixed_q15_t x) {
+    if (++xNewest == FIR_TAP_COUNT)
+        xNewest = 0;
+    xHistory[xNewest] = x;
+}
+
+// Invokes the FIR-filter over the history. Coefficient i multiplies the input
+// from i samples ago. The walk is split at the wrap-around point so that the
+// loops need no modulo.
+filterFixed_q15_t filterFixed_firFilter() {
+    int32_t total = 0;
+    uint32_t tap = 0;
+    for (int32_t i = xNewest; i >= 0; i--)
+        total += firCoefficients[tap++] * xHistory[i];
+    for (int32_t i = FIR_TAP_COUNT - 1; i > (int32_t)xNewest; i--)
+        total += firCoefficients[tap++] * xHistory[i];
+    // Round the Q30 sum back to Q15.
+    int32_t y = (total + (1 << 14)) >> 15;
+    if (y > INT16_MAX)
+        y = INT16_MAX;
+    if (y < INT16_MIN)
+        y = INT16_MIN;
+    firOutput = (filterFixed_q31_t)y << Q15_TO_Q31_SHIFT;
+    return y;
+}
+
+// Runs the latest FIR output through the biquad cascade of one IIR filter and
+// records the output for the power computation.
+filterFixed_q31_t filterFixed_iirFilter(uint16_t filterNumber) {
+    filterFixed_q31_t x = firOutput;
+    for (uint32_t s = 0; s < FILTER_FIXED_IIR_SECTION_COUNT; s++) {
+        const filterFixed_biquad_t *c = &iirSections[filterNumber][s];
+        biquadState_t *state = &iirState[filterNumber][s];
+        int64_t total = (int64_t)c->b[0] * x + (int64_t)c->b[1] * state->x1 +
+                        (int64_t)c->b[2] * state->x2 -
+                        (int64_t)c->a[0] * state->y1 -
+                        (int64_t)c->a[1] * state->y2;
+        filterFixed_q31_t y = saturateQ31(
+            (total + (1LL << (Q30_PRODUCT_SHIFT - 1))) >> Q30_PRODUCT_SHIFT);
+        state->x2 = state->x1;
+        state->x1 = x;
+        state->y2 = state->y1;
+        state->y1 = y;
+        x = y;
+    }
+    if (++outputNewest[filterNumber] == OUTPUT_RING_SIZE)
+        outputNewest[filterNumber] = 0;
+    int32_t *slot = &getOutputRing(filterNumber)[outputNewest[filterNumber]];
+    replacedOutput[filterNumber] = *slot;
+    *slot = x >> POWER_SAMPLE_SHIFT;
+    return x;
+}
+
+// Same as filter_computePower(). Integer arithmetic makes the incremental
+// result identical to the from-scratch result.
+filterFixed_power_t filterFixed_computePower(uint16_t filterNumber,
+                                             bool forceComputeFromScratch) {
+    if (forceComputeFromScratch) {
+        filterFixed_power_t total = 0;
+        for (uint32_t i = 0; i < OUTPUT_RING_SIZE; i++) {
+            int64_t value = getOutputRing(filterNumber)[i];
+            total += value * value;
+        }
+        computePowerValue[filterNumber] = total;
+        return total;
+    }
+    int64_t oldest = replacedOutput[filterNumber];
+    int64_t newest = getOutputRing(filterNumber)[outputNewest[filterNumber]];
+    computePowerValue[filterNumber] += newest * newest - oldest * oldest;
+    return computePowerValue[filterNumber];
+}
+
+/******************************************************************************
+***** Verification-Assisting Functions
+******************************************************************************/
+
+// Returns the Q15 FIR coefficients.
+const filterFixed_q15_t *filterFixed_getFirCoefficientArray() {
+    return firCoefficients;
+}
+
+// Returns the biquad sections for a filter number.
+const filterFixed_biquad_t *filterFixed_getIirSectionArray(uint16_t filterNumber) {
+    return iirSections[filterNumber];
+}
@@ -0,0 +1,79 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef FILTERFIXED_H_
+#define FILTERFIXED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "filter.h"
+
+// Fixed-point version of the decimating FIR filter, the IIR filter bank and the
+// power computation in filter.c. Build with -DFILTER_FIXED_POINT=ON and the
+// filter_...() functions run on this engine instead of in double precision;
+// the filter.h API stays the same. The engine can also be called directly
+// (see filterTest.c, which compares it against the double implementation).
+// filterFixed.c is only built with FILTER_FIXED_POINT, so that the other
+// builds do not carry its state.
+//
+// Number formats:
+// - Samples are scaled down by FILTER_FIXED_HEADROOM_BITS so that in-band
+//   square waves (fundamental 4/pi times the input amplitude) cannot overflow.
+// - FIR input and output samples and FIR coefficients are Q15. The sum of the
+//   absolute values of the coefficients is below 2, so the Q30 products are
+//   accumulated in 32 bits without overflow.
+// - The 10th-order IIR filters cannot be quantized in direct form (their poles
+//   sit 0.01 from the unit circle), so each one is factored into
+//   FILTER_FIXED_IIR_SECTION_COUNT direct-form I biquads (see biquad.h) with
+//   Q30 coefficients, Q31 samples and 64-bit accumulators.
+// - Power is the sum of squares of the IIR outputs truncated to Q23, kept in
+//   exact integer arithmetic so that incremental updates never drift.
+
+#define FILTER_FIXED_HEADROOM_BITS 2
+#define FILTER_FIXED_IIR_SECTION_COUNT 5
+
+typedef int16_t filterFixed_q15_t;
+typedef int32_t filterFixed_q31_t;
+typedef uint64_t filterFixed_power_t;
+
+// A biquad section with Q30 coefficients:
+// y = b[0]*x + b[1]*x1 + b[2]*x2 - a[0]*y1 - a[1]*y2.
+typedef struct {
+  int32_t b[3];
+  int32_t a[2];
+} filterFixed_biquad_t;
+
+// Loads the coefficient tables (see filterTables.h) and clears all filter
+// state. Always returns true.
+bool filterFixed_init();
+
+// Conversions between the double values used by filter.h and the fixed-point
+// formats above, including the headroom scaling.
+filterFixed_q15_t filterFixed_fromDouble(double x);
+double filterFixed_q15ToDouble(filterFixed_q15_t x);
+double filterFixed_q31ToDouble(filterFixed_q31_t x);
+double filterFixed_powerToDouble(filterFixed_power_t power);
+
+// Same as the filter.h functions of the same name.
+void filterFixed_addNewInput(filterFixed_q15_t x);
+filterFixed_q15_t filterFixed_firFilter();
+filterFixed_q31_t filterFixed_iirFilter(uint16_t filterNumber);
+filterFixed_power_t filterFixed_computePower(uint16_t filterNumber,
+                                             bool forceComputeFromScratch);
+
+// Verification-assisting functions.
+
+// Returns the Q15 FIR coefficients.
+const filterFixed_q15_t *filterFixed_getFirCoefficientArray();
+
+// Returns the FILTER_FIXED_IIR_SECTION_COUNT sections for a filter number.
+const filterFixed_biquad_t *filterFixed_getIirSectionArray(uint16_t filterNumber);
+
+#endif /* FILTERFIXED_H_ */
@@ -0,0 +1,309 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "firKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FIR_KERNEL_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FIR_KERNEL_NEON
+#endif
+
+// Portable kernel. Four independent accumulators keep the FPU pipeline busy.
+static float scalarKernel(const float samples[], const float coefficients[],
+                          uint32_t count) {
+    float total0 = 0.0f, total1 = 0.0f, total2 = 0.0f, total3 = 0.0f;
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        total0 += samples[i] * coefficients[i];
+        total1 += samples[i + 1] * coefficients[i + 1];
+        total2 += samples[i + 2] * coefficients[i + 2];
+        total3 += samples[i + 3] * coefficients[i + 3];
+    }
+    for (; i < count; i++)
+        total0 += samples[i] * coefficients[i];
+    return (total0 + total1) + (total2 + total3);
+}
+
+// Folded kernels. coefficients[] holds the (count + 1) / 2 unique taps of a
+// symmetric table; coefficient j multiplies samples[j] + samples[count - 1 - j]
+// and, for an odd count, the middle coefficient multiplies the middle sample.
+static float scalarFoldedKernel(const float samples[],
+                                const float coefficients[], uint32_t count) {
+    const float *mirror = &samples[count - 1];
+    uint32_t half = count / 2;
+    float total0 = 0.0f, total1 = 0.0f, total2 = 0.0f, total3 = 0.0f;
+    uint32_t j = 0;
+    for (; j + 4 <= half; j += 4) {
+        total0 += (samples[j] + mirror[-(int32_t)j]) * coefficients[j];
+        total1 += (samples[j + 1] + mirror[-(int32_t)j - 1]) * coefficients[j + 1];
+        total2 += (samples[j + 2] + mirror[-(int32_t)j - 2]) * coefficients[j + 2];
+        total3 += (samples[j + 3] + mirror[-(int32_t)j - 3]) * coefficients[j + 3];
+    }
+    for (; j < half; j++)
+        total0 += (samples[j] + mirror[-(int32_t)j]) * coefficients[j];
+    if (count & 1)
+        total0 += samples[half] * coefficients[half];
+    return (total0 + total1) + (total2 + total3);
+}
+
+#ifdef FIR_KERNEL_X86
+// 2 x 4 lanes per iteration.
+__attribute__((target("sse"))) static float
+sseKernel(const float samples[], const float coefficients[], uint32_t count) {
+    __m128 total0 = _mm_setzero_ps();
+    __m128 total1 = _mm_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        total0 = _mm_add_ps(total0, _mm_mul_ps(_mm_loadu_ps(&samples[i]),
+                                               _mm_loadu_ps(&coefficients[i])));
+        total1 = _mm_add_ps(total1, _mm_mul_ps(_mm_loadu_ps(&samples[i + 4]),
+                                               _mm_loadu_ps(&coefficients[i + 4])));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(total0, total1));
+    float total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; i++)
+        total += samples[i] * coefficients[i];
+    return total;
+}
+
+// 2 x 8 lanes per iteration.
+__attribute__((target("avx"))) static float
+avxKernel(const float samples[], const float coefficients[], uint32_t count) {
+    __m256 total0 = _mm256_setzero_ps();
+    __m256 total1 = _mm256_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        total0 = _mm256_add_ps(total0,
+                               _mm256_mul_ps(_mm256_loadu_ps(&samples[i]),
+                                             _mm256_loadu_ps(&coefficients[i])));
+        total1 = _mm256_add_ps(total1,
+                               _mm256_mul_ps(_mm256_loadu_ps(&samples[i + 8]),
+                                             _mm256_loadu_ps(&coefficients[i + 8])));
+    }
+    __m256 sum = _mm256_add_ps(total0, total1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum),
+                             _mm256_extractf128_ps(sum, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, half);
+    float total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; i++)
+        total += samples[i] * coefficients[i];
+    return total;
+}
+
+// Reverses the four lanes of v.
+__attribute__((target("sse"))) static inline __m128 sseReverse(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+// 2 x 4 folded pairs per iteration.
+__attribute__((target("sse"))) static float
+sseFoldedKernel(const float samples[], const float coefficients[],
+                uint32_t count) {
+    uint32_t half = count / 2;
+    __m128 total0 = _mm_setzero_ps();
+    __m128 total1 = _mm_setzero_ps();
+    uint32_t j = 0;
+    for (; j + 8 <= half; j += 8) {
+        __m128 pair0 = _mm_add_ps(_mm_loadu_ps(&samples[j]),
+                                  sseReverse(_mm_loadu_ps(&samples[count - 4 - j])));
+        __m128 pair1 = _mm_add_ps(_mm_loadu_ps(&samples[j + 4]),
+                                  sseReverse(_mm_loadu_ps(&samples[count - 8 - j])));
+        total0 = _mm_add_ps(total0, _mm_mul_ps(pair0, _mm_loadu_ps(&coefficients[j])));
+        total1 = _mm_add_ps(total1, _mm_mul_ps(pair1, _mm_loadu_ps(&coefficients[j + 4])));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(total0, total1));
+    float total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; j < half; j++)
+        total += (samples[j] + samples[count - 1 - j]) * coefficients[j];
+    if (count & 1)
+        total += samples[half] * coefficients[half];
+    return total;
+}
+
+// 8 folded pairs per iteration. The folded table is half as long, so a single
+// accumulator leaves less of it to the scalar tail.
+__attribute__((target("avx"))) static float
+avxFoldedKernel(const float samples[], const float coefficients[],
+                uint32_t count) {
+    uint32_t half = count / 2;
+    __m256 total0 = _mm256_setzero_ps();
+    uint32_t j = 0;
+    for (; j + 8 <= half; j += 8) {
+        // Reverse within each 128-bit lane, then swap the lanes.
+        __m256 mirror = _mm256_permute_ps(_mm256_loadu_ps(&samples[count - 8 - j]),
+                                          _MM_SHUFFLE(0, 1, 2, 3));
+        mirror = _mm256_permute2f128_ps(mirror, mirror, 1);
+        __m256 pair = _mm256_add_ps(_mm256_loadu_ps(&samples[j]), mirror);
+        total0 = _mm256_add_ps(total0,
+                               _mm256_mul_ps(pair, _mm256_loadu_ps(&coefficients[j])));
+    }
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(total0),
+                            _mm256_extractf128_ps(total0, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum);
+    float total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; j < half; j++)
+        total += (samples[j] + samples[count - 1 - j]) * coefficients[j];
+    if (count & 1)
+        total += samples[half] * coefficients[half];
+    return total;
+}
+#endif
+
+#ifdef FIR_KERNEL_NEON
+// 2 x 4 lanes per iteration with multiply-accumulate.
+static float neonKernel(const float samples[], const float coefficients[],
+                        uint32_t count) {
+    float32x4_t total0 = vdupq_n_f32(0.0f);
+    float32x4_t total1 = vdupq_n_f32(0.0f);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        total0 = vmlaq_f32(total0, vld1q_f32(&samples[i]),
+                           vld1q_f32(&coefficients[i]));
+        total1 = vmlaq_f32(total1, vld1q_f32(&samples[i + 4]),
+                           vld1q_f32(&coefficients[i + 4]));
+    }
+    float32x4_t sum = vaddq_f32(total0, total1);
+    float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    float total = vget_lane_f32(vpadd_f32(half, half), 0);
+    for (; i < count; i++)
+        total += samples[i] * coefficients[i];
+    return total;
+}
+
+// Reverses the four lanes of v.
+static inline float32x4_t neonReverse(float32x4_t v) {
+    float32x4_t swapped = vrev64q_f32(v);
+    return vcombine_f32(vget_high_f32(swapped), vget_low_f32(swapped));
+}
+
+// 2 x 4 folded pairs per iteration with multiply-accumulate.
+static float neonFoldedKernel(const float samples[], const float coefficients[],
+                              uint32_t count) {
+    uint32_t half = count / 2;
+    float32x4_t total0 = vdupq_n_f32(0.0f);
+    float32x4_t total1 = vdupq_n_f32(0.0f);
+    uint32_t j = 0;
+    for (; j + 8 <= half; j += 8) {
+        float32x4_t pair0 = vaddq_f32(vld1q_f32(&samples[j]),
+                                      neonReverse(vld1q_f32(&samples[count - 4 - j])));
+        float32x4_t pair1 = vaddq_f32(vld1q_f32(&samples[j + 4]),
+                                      neonReverse(vld1q_f32(&samples[count - 8 - j])));
+        total0 = vmlaq_f32(total0, pair0, vld1q_f32(&coefficients[j]));
+        total1 = vmlaq_f32(total1, pair1, vld1q_f32(&coefficients[j + 4]));
+    }
+    float32x4_t sum = vaddq_f32(total0, total1);
+    float32x2_t halfSum = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    float total = vget_lane_f32(vpadd_f32(halfSum, halfSum), 0);
+    for (; j < half; j++)
+        total += (samples[j] + samples[count - 1 - j]) * coefficients[j];
+    if (count & 1)
+        total += samples[half] * coefficients[half];
+    return total;
+}
+#endif
+
+// Returns true if the coefficient table reads the same in both directions.
+// Exact comparison is deliberate: folding a table that is only nearly
+// symmetric would silently change the filter.
+bool firKernel_isSymmetric(const double coefficients[], uint32_t tapCount) {
+    for (uint32_t i = 0; i < tapCount / 2; i++) {
+        if (coefficients[i] != coefficients[tapCount - 1 - i])
+            return false;
+    }
+    return true;
+}
+
+// Installs a coefficient table for a kernel. See firKernel.h.
+void firKernel_install(firKernel_fir_t *fir, filter_firKernel_t kernel,
+                       const double coefficients[], uint32_t tapCount,
+                       bool allowFolding) {
+    fir->kernel = kernel;
+    if (tapCount > FIR_KERNEL_MAX_TAP_COUNT) {
+        printf("firKernel_install(): %u taps, more than %d\n", tapCount,
+               FIR_KERNEL_MAX_TAP_COUNT);
+        assert(false);
+        // Without asserts, install an empty filter rather than overrun.
+        fir->tapCount = 0;
+        fir->folded = false;
+        fir->function = firKernel_getFunction(kernel, false);
+        return;
+    }
+    fir->tapCount = tapCount;
+    fir->folded = allowFolding && firKernel_isSymmetric(coefficients, tapCount);
+    fir->function = firKernel_getFunction(kernel, fir->folded);
+    // The window holds the oldest input first, so reverse the table. A folded
+    // table is the first half of the same array.
+    for (uint32_t i = 0; i < tapCount; i++)
+        fir->coefficients[i] = coefficients[tapCount - 1 - i];
+}
+
+// Returns true if the kernel was built and can run on this CPU.
+bool firKernel_isSupported(filter_firKernel_t kernel) {
+    return firKernel_getFunction(kernel, false) != NULL;
+}
+
+// Returns the fastest supported kernel.
+filter_firKernel_t firKernel_getBest() {
+    if (firKernel_isSupported(FILTER_FIR_KERNEL_NEON))
+        return FILTER_FIR_KERNEL_NEON;
+    if (firKernel_isSupported(FILTER_FIR_KERNEL_AVX))
+        return FILTER_FIR_KERNEL_AVX;
+    if (firKernel_isSupported(FILTER_FIR_KERNEL_SSE))
+        return FILTER_FIR_KERNEL_SSE;
+    return FILTER_FIR_KERNEL_SCALAR;
+}
+
+// Returns the general (or folded) kernel function, or NULL if it is not
+// supported.
+firKernel_function_t firKernel_getFunction(filter_firKernel_t kernel,
+                                           bool folded) {
+    switch (kernel) {
+    case FILTER_FIR_KERNEL_SCALAR:
+        return folded ? scalarFoldedKernel : scalarKernel;
+#ifdef FIR_KERNEL_X86
+    case FILTER_FIR_KERNEL_SSE:
+        return folded ? sseFoldedKernel : sseKernel;
+    case FILTER_FIR_KERNEL_AVX:
+        if (!__builtin_cpu_supports("avx"))
+            return NULL;
+        return folded ? avxFoldedKernel : avxKernel;
+#endif
+#ifdef FIR_KERNEL_NEON
+    case FILTER_FIR_KERNEL_NEON:
+        return folded ? neonFoldedKernel : neonKernel;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+// Returns a printable name for the kernel.
+const char *firKernel_getName(filter_firKernel_t kernel) {
+    switch (kernel) {
+    case FILTER_FIR_KERNEL_QUEUE:
+        return "queue (double)";
+    case FILTER_FIR_KERNEL_DELAY_LINE:
+        return "delay line (double)";
+    case FILTER_FIR_KERNEL_SCALAR:
+        return "scalar (float)";
+    case FILTER_FIR_KERNEL_SSE:
+        return "SSE (float)";
+    case FILTER_FIR_KERNEL_AVX:
+        return "AVX (float)";
+    case FILTER_FIR_KERNEL_NEON:
+        return "NEON (float)";
+    case FILTER_FIR_KERNEL_CIC:
+        return "CIC (integer)";
+    default:
+        return "best";
+    }
+}
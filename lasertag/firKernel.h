@@ -0,0 +1,87 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef FIRKERNEL_H_
+#define FIRKERNEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "filter.h"
+
+// Single-precision FIR kernels that run over a contiguous window of inputs.
+// The NEON kernels are built when the compiler targets NEON (the board build
+// compiles this file with -mfpu=neon-vfpv3); the SSE and AVX kernels are built
+// for x86 hosts and the AVX kernels are only used if the CPU supports it.
+//
+// Each kernel has a general and a folded form. Linear-phase (symmetric)
+// coefficient tables are detected when they are installed and can run folded:
+// mirrored inputs are added first so each unique coefficient is multiplied
+// once, which halves the multiplies and the length of the accumulator chains.
+// On the x86 host the folded form of the 81-tap table saves about 27% per
+// output with the scalar kernel and 2-10% with SSE and AVX, whose general
+// forms are already bound by loads (lasertagTest filter).
+
+#define FIR_KERNEL_MAX_TAP_COUNT 128
+#define FIR_KERNEL_ALIGNMENT 32
+
+// Computes the FIR output from count inputs (samples[count - 1] is the newest)
+// and the installed coefficients.
+typedef float (*firKernel_function_t)(const float samples[],
+                                      const float coefficients[],
+                                      uint32_t count);
+
+// An installed coefficient table. Use firKernel_install() to fill it in.
+typedef struct {
+  filter_firKernel_t kernel;
+  uint32_t tapCount;
+  bool folded;
+  firKernel_function_t function;
+  // Coefficients in window order (oldest input first). Only the first
+  // (tapCount + 1) / 2 are used when folded.
+  float coefficients[FIR_KERNEL_MAX_TAP_COUNT]
+      __attribute__((aligned(FIR_KERNEL_ALIGNMENT)));
+} firKernel_fir_t;
+
+// Installs a coefficient table, where coefficients[i] multiplies the input
+// from i samples ago, for the given kernel (which must be supported). If
+// allowFolding is true and the table is exactly symmetric, the folded form of
+// the kernel is used. tapCount must be at most FIR_KERNEL_MAX_TAP_COUNT.
+void firKernel_install(firKernel_fir_t *fir, filter_firKernel_t kernel,
+                       const double coefficients[], uint32_t tapCount,
+                       bool allowFolding);
+
+// Returns true if the table is exactly symmetric (linear phase), so that it
+// can run folded.
+bool firKernel_isSymmetric(const double coefficients[], uint32_t tapCount);
+
+// Runs the installed FIR over the tapCount inputs starting at window[0]
+// (oldest) and ending at window[tapCount - 1] (newest).
+static inline float firKernel_run(const firKernel_fir_t *fir,
+                                  const float window[]) {
+  return fir->function(window, fir->coefficients, fir->tapCount);
+}
+
+// Returns true if the kernel was built and can run on this CPU.
+// FILTER_FIR_KERNEL_QUEUE and FILTER_FIR_KERNEL_DELAY_LINE are not firKernels
+// and always return false.
+bool firKernel_isSupported(filter_firKernel_t kernel);
+
+// Returns the fastest supported kernel.
+filter_firKernel_t firKernel_getBest();
+
+// Returns the general (or folded) kernel function, or NULL if it is not
+// supported.
+firKernel_function_t firKernel_getFunction(filter_firKernel_t kernel,
+                                           bool folded);
+
+// Returns a printable name for the kernel.
+const char *firKernel_getName(filter_firKernel_t kernel);
+
+#endif /* FIRKERNEL_H_ */
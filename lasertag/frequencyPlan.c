@@ -0,0 +1,129 @@
+#include <complex.h>
+#include <math.h>
+#include "filter.h"
+#include "frequencyPlan.h"
+
+#define TICKS_PER_SECOND (FILTER_SAMPLE_FREQUENCY_IN_KHZ * 1000.0)
+#define PROTOTYPE_ORDER (FREQUENCY_PLAN_BANDPASS_ORDER / 2)
+
+//The plan starts out as the default ten player frequencies; a new plan is
+//copied into planStorage
+static uint16_t planStorage[FREQUENCY_PLAN_MAX_CHANNEL_COUNT];
+static const uint16_t *tickPeriods = filter_frequencyTickTable;
+static uint16_t channelCount = FILTER_FREQUENCY_COUNT;
+
+//Returns the center of the passband for a square wave of tickPeriod ticks
+static double centerFrequency(uint16_t tickPeriod) {
+    return round(TICKS_PER_SECOND / tickPeriod);
+}
+
+// Replaces the plan, if every passband fits below half the sample rate.
+bool frequencyPlan_set(const uint16_t periods[], uint16_t count) {
+    if (count == 0 || count > FREQUENCY_PLAN_MAX_CHANNEL_COUNT)
+        return false;
+    for (uint16_t i = 0; i < count; i++) {
+        if (periods[i] == 0 ||
+            centerFrequency(periods[i]) + FREQUENCY_PLAN_BANDWIDTH_IN_HZ / 2 >=
+                FREQUENCY_PLAN_SAMPLE_FREQUENCY_IN_HZ / 2)
+            return false;
+    }
+    for (uint16_t i = 0; i < count; i++)
+        planStorage[i] = periods[i];
+    tickPeriods = planStorage;
+    channelCount = count;
+    return true;
+}
+
+// Returns the number of player frequencies in the plan.
+uint16_t frequencyPlan_getChannelCount() {
+    return channelCount;
+}
+
+// Returns the square-wave period of player frequency [channel] in ISR ticks.
+uint16_t frequencyPlan_getTickPeriod(uint16_t channel) {
+    return tickPeriods[channel];
+}
+
+// Returns true if the plan is filter_frequencyTickTable.
+bool frequencyPlan_isDefault() {
+    if (channelCount != FILTER_FREQUENCY_COUNT)
+        return false;
+    for (uint16_t i = 0; i < channelCount; i++) {
+        if (tickPeriods[i] != filter_frequencyTickTable[i])
+            return false;
+    }
+    return true;
+}
+
+//Computes the poles of the bandpass filter for a square wave of tickPeriod
+//ISR ticks, one of each conjugate pair first and then its conjugate, and
+//returns the gain
+static double synthesizePoles(uint16_t tickPeriod, double complex poles[]) {
+    //Pre-warp the band edges for the bilinear transform, z = (2fs + s) / (2fs - s)
+    double twoFs = 2.0 * FREQUENCY_PLAN_SAMPLE_FREQUENCY_IN_HZ;
+    double center = centerFrequency(tickPeriod);
+    double low = twoFs * tan(M_PI * (center - FREQUENCY_PLAN_BANDWIDTH_IN_HZ / 2) /
+                             FREQUENCY_PLAN_SAMPLE_FREQUENCY_IN_HZ);
+    double high = twoFs * tan(M_PI * (center + FREQUENCY_PLAN_BANDWIDTH_IN_HZ / 2) /
+                              FREQUENCY_PLAN_SAMPLE_FREQUENCY_IN_HZ);
+    double bandwidth = high - low;
+    double centerSquared = low * high;
+
+    //Every pole p of the Butterworth lowpass prototype becomes the two roots of
+    //s^2 - p*bandwidth*s + center^2 in the bandpass, and each of those a
+    //digital pole. The zeros are at s = 0 and infinity, z = 1 and z = -1. The
+    //prototype poles in the upper half plane give the upper bandpass poles
+    double complex gainDenominator = 1.0;
+    for (uint16_t k = 0; k < PROTOTYPE_ORDER; k++) {
+        double complex p = cexp(I * M_PI * (2 * k + PROTOTYPE_ORDER + 1) / (2 * PROTOTYPE_ORDER));
+        double complex half = p * bandwidth / 2;
+        double complex root = csqrt(half * half - centerSquared);
+        double complex s = cimag(half + root) > 0 ? half + root : half - root;
+        poles[k] = (twoFs + s) / (twoFs - s);
+        poles[k + PROTOTYPE_ORDER] = conj(poles[k]);
+        gainDenominator *= (twoFs - s) * conj(twoFs - s);
+    }
+    //The gain that the bilinear transform gives the analog prototype's
+    //bandwidth^5 * s^5 numerator
+    return creal(pow(bandwidth * twoFs, PROTOTYPE_ORDER) / gainDenominator);
+}
+
+// Computes the bandpass filter for a square wave of tickPeriod ISR ticks.
+void frequencyPlan_synthesizeBandpass(uint16_t tickPeriod, double b[], double a[]) {
+    double complex poles[FREQUENCY_PLAN_BANDPASS_ORDER];
+    double gain = synthesizePoles(tickPeriod, poles);
+
+    //Multiply out the denominator, prod(1 - pole*z^-1); the poles come in
+    //conjugate pairs, so the imaginary parts cancel
+    double complex polynomial[FREQUENCY_PLAN_BANDPASS_ORDER + 1] = {1.0};
+    for (uint16_t k = 0; k < FREQUENCY_PLAN_BANDPASS_ORDER; k++) {
+        for (uint16_t i = k + 1; i > 0; i--)
+            polynomial[i] -= poles[k] * polynomial[i - 1];
+    }
+    for (uint16_t i = 0; i < FREQUENCY_PLAN_BANDPASS_ORDER; i++)
+        a[i] = creal(polynomial[i + 1]);
+
+    //The numerator is gain * (1 - z^-2)^5
+    double binomial = 1.0;
+    for (uint16_t k = 0; k <= PROTOTYPE_ORDER; k++) {
+        b[2 * k] = (k & 1) ? -gain * binomial : gain * binomial;
+        if (2 * k + 1 <= FREQUENCY_PLAN_BANDPASS_ORDER)
+            b[2 * k + 1] = 0.0;
+        binomial = binomial * (PROTOTYPE_ORDER - k) / (k + 1);
+    }
+}
+
+// Computes the same filter as biquads, straight from its poles.
+void frequencyPlan_synthesizeBiquads(uint16_t tickPeriod, biquad_section_t sections[]) {
+    double complex poles[FREQUENCY_PLAN_BANDPASS_ORDER];
+    double gain = synthesizePoles(tickPeriod, poles);
+    biquad_factor_t poleFactors[FREQUENCY_PLAN_SECTION_COUNT];
+    biquad_factor_t zeroFactors[FREQUENCY_PLAN_SECTION_COUNT];
+    for (uint16_t k = 0; k < FREQUENCY_PLAN_SECTION_COUNT; k++) {
+        poleFactors[k] = (biquad_factor_t){-2.0 * creal(poles[k]),
+                                           creal(poles[k] * conj(poles[k]))};
+        zeroFactors[k] = (biquad_factor_t){0.0, -1.0}; //(1 - z^-2)
+    }
+    biquad_fromFactors(gain, poleFactors, zeroFactors, FREQUENCY_PLAN_SECTION_COUNT,
+                       sections);
+}
@@ -0,0 +1,66 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef FREQUENCYPLAN_H_
+#define FREQUENCYPLAN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "biquad.h"
+
+// The frequency plan is the list of player frequencies, each given as the
+// period of its square wave in 100 kHz ISR ticks. The transmitter generates
+// them and the receiver has one bandpass filter per frequency. The plan starts
+// out as the ten frequencies in filter_frequencyTickTable (see filter.h).
+// A new plan takes effect at the next filter_init() or detector_init(); the
+// transmitter uses it right away.
+
+#define FREQUENCY_PLAN_MAX_CHANNEL_COUNT 32
+// The bandpass filters are 10th-order Butterworth filters (a 5th-order lowpass
+// prototype) with a 50 Hz passband centered on the player frequency, rounded
+// to the nearest Hz, and run at the decimated sample rate of 10 kHz.
+#define FREQUENCY_PLAN_BANDPASS_ORDER 10
+#define FREQUENCY_PLAN_SECTION_COUNT (FREQUENCY_PLAN_BANDPASS_ORDER / 2)
+#define FREQUENCY_PLAN_BANDWIDTH_IN_HZ 50.0
+#define FREQUENCY_PLAN_SAMPLE_FREQUENCY_IN_HZ 10000.0
+
+// Replaces the plan with count (1 to FREQUENCY_PLAN_MAX_CHANNEL_COUNT) tick
+// periods. Returns false and keeps the current plan if count is out of range
+// or a passband does not fit below half the decimated sample rate (periods
+// shorter than 21 ticks).
+bool frequencyPlan_set(const uint16_t tickPeriods[], uint16_t count);
+
+// Returns the number of player frequencies in the plan.
+uint16_t frequencyPlan_getChannelCount();
+
+// Returns the square-wave period of player frequency [channel] in ISR ticks.
+uint16_t frequencyPlan_getTickPeriod(uint16_t channel);
+
+// Returns true if the plan is filter_frequencyTickTable, which the filter
+// tables generated at build time are designed for (see filterTables.h). Other
+// plans are synthesized at run time.
+bool frequencyPlan_isDefault();
+
+// Computes the bandpass filter for a square wave of tickPeriod ISR ticks:
+// H(z) = (b[0] + b[1]*z^-1 + ... + b[10]*z^-10) /
+//        (1 + a[0]*z^-1 + ... + a[9]*z^-10)
+// This is the same design as MATLAB's butter(5, [f - 25, f + 25] / 5000), so
+// the default plan gives back the tables generated at build time.
+void frequencyPlan_synthesizeBandpass(uint16_t tickPeriod, double b[],
+                                      double a[]);
+
+// Computes the same filter as FREQUENCY_PLAN_SECTION_COUNT biquads, straight
+// from its poles (see biquad_fromFactors()). Near half the sample rate the
+// poles crowd together and the direct form loses most of its precision, so
+// the biquads are the way to run those filters.
+void frequencyPlan_synthesizeBiquads(uint16_t tickPeriod,
+                                     biquad_section_t sections[]);
+
+#endif /* FREQUENCYPLAN_H_ */
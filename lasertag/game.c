@@ -30,6 +30,8 @@ The code in runningModes.c can be an example for implementing the game here.
 #include "detector.h"
 #include "utils.h"
 #include "isr.h"
+#include "isrMonitor.h"
+#include "timerService.h"
 #include "display.h"
 #include "intervalTimer.h"
 
@@ -51,6 +53,7 @@ The code in runningModes.c can be an example for implementing the game here.
 #define CHAR_SPACES 10
 #define TEXT_SIZE 3
 #define GO_TEXT_SIZE 4
+#define ISR_EVENT_PRINT_TICKS 100000 //Drain the ISR events once per second
 
 uint16_t lives;
 uint16_t health;
@@ -103,8 +106,8 @@ void game_twoTeamTag(void) {
   //Run in Single Shooter Mode
 
   //Build ignored Frequencies array so that every frequency is ignored except for the enemy team
-  bool ignoredFrequencies[FILTER_FREQUENCY_COUNT];
-  for(int i = 0; i < FILTER_FREQUENCY_COUNT; i++){
+  bool ignoredFrequencies[FILTER_MAX_FREQUENCY_COUNT];
+  for(int i = 0; i < filter_getFrequencyCount(); i++){
     //Set ignored frequency to true for every frequency except for the frequency of the enemys team
     ignoredFrequencies[i] = (i != (team == TEAM_1? TEAM_2: TEAM_1));
   }
@@ -161,12 +164,19 @@ void game_twoTeamTag(void) {
 
   detector_clearHit();
 
-  
+  uint32_t lastEventPrintTick = timerService_getTickCount();
 
   // Checks for Shots, handles hits, keeps track of lives and health.
   while(true){
     //Run Detector Function
     detector(INTERRUPTS_CURRENTLY_ENABLED);
+    //Report ISR overruns and buffer overwrites, which degrade detection; not
+    //on every pass, as printing is main-loop load exactly when the ISR is
+    //overloaded (the log keeps the events, or counts them as lost, meanwhile)
+    if (timerService_getTickCount() - lastEventPrintTick >= ISR_EVENT_PRINT_TICKS){
+      lastEventPrintTick = timerService_getTickCount();
+      isrMonitor_printEvents();
+    }
     //If hit detected, handle lives and health
     if(detector_hitDetected()){
       printf("hit\n"); //Debug Print 
@@ -223,6 +233,7 @@ void game_twoTeamTag(void) {
     }
   // End game loop...
   interrupts_disableArmInts(); // Done with game loop, disable the interrupts.
+  isrMonitor_printStatistics();
 }
 
 
@@ -0,0 +1,362 @@
+#!/usr/bin/python3
+
+"""
+Designs the detector's filters at build time and writes them as C tables.
+
+The decimating lowpass FIR and one bandpass IIR per player frequency are
+designed from the tick table and sample rate in filter.h and the bandpass
+parameters in frequencyPlan.h, so retuning a player frequency only takes an
+edit to filter_frequencyTickTable. The designs are the same as the ones
+frequencyPlan.c computes at run time for other plans (and as MATLAB's
+fir1() and butter()), and every table is written in each precision that a
+filter engine runs in:
+
+- double FIR coefficients, aligned for the vector FIR kernels,
+- double direct-form IIR coefficients (see filter.h),
+- double biquad sections (see biquad.h),
+- Q15 FIR coefficients and Q30 biquad sections (see filterFixed.h),
+- double coefficients of the FIR that compensates the droop of the CIC
+  decimator (see cic.h), so that the CIC front end matches the FIR above.
+
+Usage: generateFilterTables.py filter.h frequencyPlan.h cic.h output.h
+"""
+
+import argparse
+import cmath
+import math
+import pathlib
+import re
+import sys
+
+# The decimating lowpass: a Hamming-windowed sinc (MATLAB's fir1() without
+# the DC normalization) that passes the decimated band and stops well before
+# the images of the player frequencies that fold onto it.
+FIR_TAP_COUNT = 81
+FIR_CUTOFF_IN_HZ = 5400.0
+
+# The compensation FIR after the CIC decimator runs at the decimated rate and
+# is fitted (least squares) to FIR / CIC up to the highest frequency that a
+# frequency plan can use.
+CIC_COMPENSATION_TAP_COUNT = 17
+CIC_COMPENSATION_PASSBAND_IN_HZ = 4800.0
+CIC_COMPENSATION_GRID_POINT_COUNT = 400
+
+# Same as SCALING_GRID_POINT_COUNT in biquad.c.
+SCALING_GRID_POINT_COUNT = 1024
+
+# Same as the fixed-point formats in filterFixed.c.
+Q15_ONE = 1 << 15
+Q30_ONE = 1 << 30
+
+TABLE_ALIGNMENT = 32
+
+
+def read_define(text, name):
+    """ Returns the numeric value of #define name in a header """
+    match = re.search(r"#define\s+" + name + r"[\s\\]+\(?([-0-9.eE]+)", text)
+    if not match:
+        sys.exit("generateFilterTables.py: no #define " + name)
+    return float(match.group(1))
+
+
+def read_tick_table(text):
+    """ Returns the periods in filter_frequencyTickTable """
+    match = re.search(r"filter_frequencyTickTable\[[^\]]*\]\s*=\s*\{([^}]*)\}", text)
+    if not match:
+        sys.exit("generateFilterTables.py: no filter_frequencyTickTable")
+    return [int(value) for value in match.group(1).split(",") if value.strip()]
+
+
+def design_fir(sample_frequency):
+    """ Hamming-windowed sinc lowpass with FIR_TAP_COUNT taps """
+    order = FIR_TAP_COUNT - 1
+    cutoff = 2.0 * FIR_CUTOFF_IN_HZ / sample_frequency
+    coefficients = []
+    for n in range(FIR_TAP_COUNT):
+        k = n - order / 2
+        if k == 0:
+            ideal = cutoff
+        else:
+            ideal = math.sin(math.pi * cutoff * k) / (math.pi * k)
+        window = 0.54 - 0.46 * math.cos(2.0 * math.pi * n / order)
+        coefficients.append(ideal * window)
+    # The two halves differ in the last bit from rounding. Mirror the first
+    # half so that the table is exactly symmetric and the FIR can run folded.
+    for n in range(FIR_TAP_COUNT // 2):
+        coefficients[order - n] = coefficients[n]
+    return coefficients
+
+
+def fir_magnitude(coefficients, frequency, sample_frequency):
+    """ Returns |H(f)| of an FIR filter """
+    w = 2.0 * math.pi * frequency / sample_frequency
+    return abs(sum(h * cmath.exp(-1j * w * n) for n, h in enumerate(coefficients)))
+
+
+def cic_magnitude(frequency, sample_frequency, decimation, stage_count):
+    """ Returns |H(f)| of the CIC decimator, normalized to 1 at DC """
+    if frequency == 0.0:
+        return 1.0
+    w = math.pi * frequency / sample_frequency
+    return abs(math.sin(w * decimation) / (decimation * math.sin(w))) ** stage_count
+
+
+def solve(matrix, vector):
+    """ Solves matrix * x = vector by Gaussian elimination """
+    n = len(vector)
+    rows = [row[:] + [vector[i]] for i, row in enumerate(matrix)]
+    for column in range(n):
+        pivot = max(range(column, n), key=lambda r: abs(rows[r][column]))
+        rows[column], rows[pivot] = rows[pivot], rows[column]
+        for r in range(n):
+            if r != column:
+                factor = rows[r][column] / rows[column][column]
+                for k in range(column, n + 1):
+                    rows[r][k] -= factor * rows[column][k]
+    return [rows[i][n] / rows[i][i] for i in range(n)]
+
+
+def design_cic_compensation(fir, ticks_per_second, decimation, stage_count):
+    """ Linear-phase FIR at the decimated rate with CIC * FIR ~= the lowpass """
+    sample_frequency = ticks_per_second / decimation
+    half = CIC_COMPENSATION_TAP_COUNT // 2
+    # H(f) = c[0] + 2 * sum(c[k] * cos(2 pi f k / fs)); least squares fit of c.
+    normal = [[0.0] * (half + 1) for _ in range(half + 1)]
+    target = [0.0] * (half + 1)
+    for i in range(CIC_COMPENSATION_GRID_POINT_COUNT + 1):
+        frequency = CIC_COMPENSATION_PASSBAND_IN_HZ * i / CIC_COMPENSATION_GRID_POINT_COUNT
+        basis = [1.0] + [
+            2.0 * math.cos(2.0 * math.pi * frequency * k / sample_frequency)
+            for k in range(1, half + 1)
+        ]
+        desired = fir_magnitude(fir, frequency, ticks_per_second) / cic_magnitude(
+            frequency, ticks_per_second, decimation, stage_count
+        )
+        for r in range(half + 1):
+            target[r] += basis[r] * desired
+            for c in range(half + 1):
+                normal[r][c] += basis[r] * basis[c]
+    c = solve(normal, target)
+    return c[:0:-1] + c
+
+
+class BandpassDesign:
+    """ The bandpass filter for one player frequency, see frequencyPlan.c """
+
+    def __init__(self, tick_period, ticks_per_second, sample_frequency, bandwidth, order):
+        two_fs = 2.0 * sample_frequency
+        center = float(round_half_away(ticks_per_second / tick_period))
+        low = two_fs * math.tan(math.pi * (center - bandwidth / 2) / sample_frequency)
+        high = two_fs * math.tan(math.pi * (center + bandwidth / 2) / sample_frequency)
+        band = high - low
+        center_squared = low * high
+
+        # Each Butterworth prototype pole becomes two bandpass poles; keep the
+        # upper one of each conjugate pair.
+        prototype_order = order // 2
+        self.poles = []
+        gain_denominator = 1.0
+        for k in range(prototype_order):
+            p = cmath.exp(1j * math.pi * (2 * k + prototype_order + 1) / (2 * prototype_order))
+            half = p * band / 2
+            root = cmath.sqrt(half * half - center_squared)
+            s = half + root if (half + root).imag > 0 else half - root
+            self.poles.append((two_fs + s) / (two_fs - s))
+            gain_denominator *= ((two_fs - s) * (two_fs - s).conjugate()).real
+        self.gain = (band * two_fs) ** prototype_order / gain_denominator
+        self.order = order
+
+    def direct_form(self):
+        """ Returns (b, a) as stored by filter.c, a without the leading 1 """
+        polynomial = [1.0 + 0j] + [0j] * self.order
+        all_poles = self.poles + [p.conjugate() for p in self.poles]
+        for k, pole in enumerate(all_poles):
+            for i in range(k + 1, 0, -1):
+                polynomial[i] -= pole * polynomial[i - 1]
+        a = [value.real for value in polynomial[1:]]
+
+        # The numerator is gain * (1 - z^-2)^(order / 2).
+        b = [0.0] * (self.order + 1)
+        for k in range(self.order // 2 + 1):
+            b[2 * k] = (-1) ** k * self.gain * math.comb(self.order // 2, k)
+        return b, a
+
+    def biquads(self):
+        """ Returns (b0, b1, b2, a1, a2) sections, see biquad_fromFactors() """
+        factors = [(-2.0 * p.real, (p * p.conjugate()).real) for p in self.poles]
+        factors.sort(key=lambda factor: math.sqrt(factor[1]))
+        sections = [[1.0, 0.0, -1.0, c1, c2] for c1, c2 in factors]
+
+        # Scale so that every partial cascade peaks at a gain of 1.
+        magnitude = [1.0] * SCALING_GRID_POINT_COUNT
+        remaining_gain = self.gain
+        for section in sections[:-1]:
+            for k in range(SCALING_GRID_POINT_COUNT):
+                w = math.pi * k / (SCALING_GRID_POINT_COUNT - 1)
+                magnitude[k] *= section_magnitude(section, w)
+            peak = max(magnitude)
+            gain = 1.0 / peak if peak > 0.0 else 1.0
+            magnitude = [value * gain for value in magnitude]
+            for i in range(3):
+                section[i] *= gain
+            remaining_gain /= gain
+        for i in range(3):
+            sections[-1][i] *= remaining_gain
+        return sections
+
+
+def section_magnitude(section, w):
+    """ Returns |H(e^jw)| for a single section """
+    z1 = cmath.exp(-1j * w)
+    z2 = z1 * z1
+    b0, b1, b2, a1, a2 = section
+    return abs((b0 + b1 * z1 + b2 * z2) / (1.0 + a1 * z1 + a2 * z2))
+
+
+def round_half_away(x):
+    """ Rounds like C's round(), halfway cases away from zero """
+    return int(math.floor(abs(x) + 0.5)) * (1 if x >= 0 else -1)
+
+
+def to_fixed(x, one, bits):
+    """ Quantizes and saturates like roundAndSaturate() in filterFixed.c """
+    limit = 1 << (bits - 1)
+    return max(-limit, min(limit - 1, round_half_away(x * one)))
+
+
+def format_doubles(values):
+    return "{" + ", ".join("%.16e" % value for value in values) + "}"
+
+
+def format_ints(values):
+    return "{" + ", ".join(str(value) for value in values) + "}"
+
+
+def write_table(lines, declaration, rows):
+    lines.append(declaration + " = {")
+    lines.append(",\n".join(rows))
+    lines.append("};")
+    lines.append("")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("filter_header", type=pathlib.Path)
+    parser.add_argument("frequency_plan_header", type=pathlib.Path)
+    parser.add_argument("cic_header", type=pathlib.Path)
+    parser.add_argument("output", type=pathlib.Path)
+    args = parser.parse_args()
+
+    filter_text = args.filter_header.read_text()
+    plan_text = args.frequency_plan_header.read_text()
+    cic_stage_count = int(read_define(args.cic_header.read_text(), "CIC_STAGE_COUNT"))
+    ticks_per_second = read_define(filter_text, "FILTER_SAMPLE_FREQUENCY_IN_KHZ") * 1000.0
+    decimation = read_define(filter_text, "FILTER_FIR_DECIMATION_FACTOR")
+    order = int(read_define(plan_text, "FREQUENCY_PLAN_BANDPASS_ORDER"))
+    bandwidth = read_define(plan_text, "FREQUENCY_PLAN_BANDWIDTH_IN_HZ")
+    tick_periods = read_tick_table(filter_text)
+    sample_frequency = ticks_per_second / decimation
+    if len(tick_periods) != read_define(filter_text, "FILTER_FREQUENCY_COUNT"):
+        sys.exit("generateFilterTables.py: FILTER_FREQUENCY_COUNT does not match the tick table")
+
+    for period in tick_periods:
+        if round_half_away(ticks_per_second / period) + bandwidth / 2 >= sample_frequency / 2:
+            sys.exit("generateFilterTables.py: period %d does not fit below half the sample rate" % period)
+    fir = design_fir(ticks_per_second)
+    cic_compensation = design_cic_compensation(
+        fir, ticks_per_second, int(decimation), cic_stage_count
+    )
+    designs = [
+        BandpassDesign(period, ticks_per_second, sample_frequency, bandwidth, order)
+        for period in tick_periods
+    ]
+
+    aligned = "__attribute__((aligned(FILTER_TABLES_ALIGNMENT)))"
+    lines = [
+        "// Generated by generateFilterTables.py from filter.h, frequencyPlan.h and cic.h.",
+        "// Do not edit; change filter_frequencyTickTable instead.",
+        "",
+        "#ifndef FILTERTABLES_H_",
+        "#define FILTERTABLES_H_",
+        "",
+        "#include <stdint.h>",
+        "",
+        '#include "biquad.h"',
+        '#include "filterFixed.h"',
+        "",
+        "#define FILTER_TABLES_FREQUENCY_COUNT %d" % len(tick_periods),
+        "#define FILTER_TABLES_FIR_TAP_COUNT %d" % FIR_TAP_COUNT,
+        "#define FILTER_TABLES_IIR_ORDER %d" % order,
+        "#define FILTER_TABLES_SECTION_COUNT %d" % (order // 2),
+        "#define FILTER_TABLES_CIC_COMPENSATION_TAP_COUNT %d" % CIC_COMPENSATION_TAP_COUNT,
+        "#define FILTER_TABLES_ALIGNMENT %d" % TABLE_ALIGNMENT,
+        "",
+        "// The tick periods that the tables were designed for.",
+        "static const uint16_t filterTables_tickPeriods[FILTER_TABLES_FREQUENCY_COUNT] = "
+        + format_ints(tick_periods)
+        + ";",
+        "",
+    ]
+    write_table(
+        lines,
+        "static const double filterTables_firCoefficients[FILTER_TABLES_FIR_TAP_COUNT] " + aligned,
+        ["%.16e" % value for value in fir],
+    )
+    write_table(
+        lines,
+        "static const filterFixed_q15_t filterTables_firCoefficientsQ15[FILTER_TABLES_FIR_TAP_COUNT] "
+        + aligned,
+        [str(to_fixed(value, Q15_ONE, 16)) for value in fir],
+    )
+    write_table(
+        lines,
+        "static const double filterTables_cicCompensationCoefficients"
+        "[FILTER_TABLES_CIC_COMPENSATION_TAP_COUNT] " + aligned,
+        ["%.16e" % value for value in cic_compensation],
+    )
+    direct_forms = [design.direct_form() for design in designs]
+    write_table(
+        lines,
+        "static const double filterTables_iirACoefficients[FILTER_TABLES_FREQUENCY_COUNT]"
+        "[FILTER_TABLES_IIR_ORDER] " + aligned,
+        [format_doubles(a) for b, a in direct_forms],
+    )
+    write_table(
+        lines,
+        "static const double filterTables_iirBCoefficients[FILTER_TABLES_FREQUENCY_COUNT]"
+        "[FILTER_TABLES_IIR_ORDER + 1] " + aligned,
+        [format_doubles(b) for b, a in direct_forms],
+    )
+    biquads = [design.biquads() for design in designs]
+    write_table(
+        lines,
+        "static const biquad_section_t filterTables_iirSections[FILTER_TABLES_FREQUENCY_COUNT]"
+        "[FILTER_TABLES_SECTION_COUNT] " + aligned,
+        ["{" + ", ".join(format_doubles(s) for s in sections) + "}" for sections in biquads],
+    )
+    write_table(
+        lines,
+        "static const filterFixed_biquad_t filterTables_iirSectionsQ30[FILTER_TABLES_FREQUENCY_COUNT]"
+        "[FILTER_TABLES_SECTION_COUNT] " + aligned,
+        [
+            "{"
+            + ", ".join(
+                "{%s, %s}"
+                % (
+                    format_ints([to_fixed(c, Q30_ONE, 32) for c in s[:3]]),
+                    format_ints([to_fixed(c, Q30_ONE, 32) for c in s[3:]]),
+                )
+                for s in sections
+            )
+            + "}"
+            for sections in biquads
+        ],
+    )
+    lines.append("#endif /* FILTERTABLES_H_ */")
+
+    args.output.parent.mkdir(parents=True, exist_ok=True)
+    args.output.write_text("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -4,6 +4,7 @@
 #include "leds.h"
 #include "mio.h"
 #include "hitLedTimer.h"
+#include "timerService.h"
 #include "utils.h"
 #include "buttons.h"
 
@@ -13,18 +14,11 @@
 #define HIT_TIMER_EXPIRE_VALUE 50000
 #define WAIT_TIME 300
 #define TRANSMIT_HIGH 1
+#define ONE_SHOT 0
 
-// State of lockout timer
-typedef enum {
-  INIT,    // Initializer
-  LED_ON, // LED high
-  LED_OFF // LED low and wait for hig
-} hitTimer_state_t;
-
-
-volatile static hitTimer_state_t timerState;
+//the LED is turned off when this one-shot timer expires
+static timerService_timer_t ledTimer;
 volatile bool ledTimerEnabled;
-volatile uint16_t timer = 0;
 
 // The hitLedTimer is active for 1/2 second once it is started.
 // While active, it turns on the LED connected to MIO pin 11
@@ -32,67 +26,23 @@ volatile uint16_t timer = 0;
 
 // Need to init things.
 void hitLedTimer_init() {
-    timerState = INIT;
+    timerService_register(&ledTimer, hitLedTimer_turnLedOff);
     mio_setPinAsOutput(HIT_LED_TIMER_OUTPUT_PIN);
     ledTimerEnabled = true;
     hitLedTimer_turnLedOff();
 }
 
-// Standard tick function.
-void hitLedTimer_tick(){
-
-    //Transitional Logic for timerState
-    switch(timerState) //State update
-    {
-        case LED_OFF:   // Setting timer to the initial state waiting to get initial hit
-           break;
-
-        case LED_ON:  // Hit detected LED high for 500 ms
-            // If timer reaches expire tick count, transition to init state
-            if (timer >= HIT_TIMER_EXPIRE_VALUE) {
-                timerState = INIT;
-                hitLedTimer_turnLedOff();
-            }
-            break;
-
-        case INIT:  // Reinitializes values
-            timerState = LED_OFF;
-            break;
-
-        default:    //default case essentially an error state
-            printf("No state\n");
-    }   
-
-    //Action Logic for timerState
-    switch(timerState) //State action
-    {
-        case LED_OFF:   // Setting timer to the initial state waiting to get initial hit
-            timer = 0;
-            break;
-
-        case LED_ON:  // Hit detected LED high for 500 ms
-            timer++;
-            break;
-
-        case INIT:    // Reinitializes values
-            break;
-
-        default:    //default case
-            printf("No state");
-    }
-}
-
 // Calling this starts the timer.
 void hitLedTimer_start() {
     if (ledTimerEnabled) {
         hitLedTimer_turnLedOn();
-        timerState = LED_ON;
+        timerService_start(&ledTimer, HIT_TIMER_EXPIRE_VALUE, ONE_SHOT);
     }
 }
 
 // Returns true if the timer is currently running.
 bool hitLedTimer_running() {
-    return (timerState == LED_ON);
+    return timerService_running(&ledTimer);
 }
 
 // Turns the gun's hit-LED on.
@@ -110,8 +60,7 @@ void hitLedTimer_turnLedOff() {
 // Disables the hitLedTimer.
 void hitLedTimer_disable() {
     ledTimerEnabled = false;
-    timer = 0;
-    timerState = LED_OFF;
+    timerService_cancel(&ledTimer);
 }
 
 // Enables the hitLedTimer.
@@ -121,7 +70,7 @@ void hitLedTimer_enable() {
 
 // Runs a visual test of the hit LED until BTN3 is pressed.
 // The test continuously blinks the hit-led on and off.
-// Depends on the interrupt handler to call tick function.
+// Depends on the interrupt handler to call timerService_tick().
 void hitLedTimer_runTest() {
     printf("starting hitLedTimer_runTest()\n");
 
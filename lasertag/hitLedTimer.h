@@ -19,12 +19,10 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #define HIT_LED_TIMER_EXPIRE_VALUE 50000 // Defined in terms of 100 kHz ticks.
 #define HIT_LED_TIMER_OUTPUT_PIN 11      // JF-3
 
-// Need to init things.
+// Need to init things. Registers the timer with the timer service (see
+// timerService.h), which turns the LED off from the ISR.
 void hitLedTimer_init();
 
-// Standard tick function.
-void hitLedTimer_tick();
-
 // Calling this starts the timer.
 void hitLedTimer_start();
 
@@ -45,7 +43,7 @@ void hitLedTimer_enable();
 
 // Runs a visual test of the hit LED until BTN3 is pressed.
 // The test continuously blinks the hit-led on and off.
-// Depends on the interrupt handler to call tick function.
+// Depends on the interrupt handler to call timerService_tick().
 void hitLedTimer_runTest();
 
 #endif /* HITLEDTIMER_H_ */
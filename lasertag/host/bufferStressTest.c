@@ -0,0 +1,170 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Stress test for the lock-free ADC buffer. A producer thread stands in for
+// the ISR and pushes a running count, and the main thread drains the buffer
+// the way detector() does. Three phases:
+// 1. paced: 100 samples every millisecond (the 100 kHz ADC rate), consumer
+//    keeps up, so nothing may be dropped.
+// 2. stalled: same rate, but the consumer stops for longer than the buffer
+//    holds, so values are overwritten.
+// 3. flood: the producer pushes as fast as it can, which laps the consumer
+//    while it is copying.
+// In every phase each value the consumer pops must be the one after the last
+// value it popped plus the number of values dropped in between (the values
+// are truncated to the buffer's storage width), and popped + dropped must
+// equal pushed.
+// Usage: bufferStressTest [millisecondsPerPhase]
+// Returns 0 if all phases pass.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "buffer.h"
+
+#define DEFAULT_PHASE_MILLISECONDS 1000
+#define SAMPLES_PER_MILLISECOND 100 // 100 kHz.
+#define NANOSECONDS_PER_MILLISECOND 1000000
+#define NANOSECONDS_PER_SECOND 1000000000
+#define STALL_MILLISECONDS 500 // Longer than the buffer holds at 100 kHz.
+#define POP_BLOCK_SIZE 256
+#define FLOOD_MAX_VALUE (1u << 30) // Keeps the count far from wrapping.
+
+typedef enum { PHASE_PACED, PHASE_STALLED, PHASE_FLOOD } phase_t;
+
+static const char *phaseNames[] = {"paced", "stalled", "flood"};
+
+static phase_t phase;
+static uint32_t phaseMilliseconds;
+static atomic_bool producerDone;
+static uint32_t pushedCount;
+
+static void addMilliseconds(struct timespec *t, uint32_t milliseconds) {
+  t->tv_nsec += (long)milliseconds * NANOSECONDS_PER_MILLISECOND;
+  t->tv_sec += t->tv_nsec / NANOSECONDS_PER_SECOND;
+  t->tv_nsec %= NANOSECONDS_PER_SECOND;
+}
+
+static void sleepMilliseconds(uint32_t milliseconds) {
+  struct timespec t = {0, 0};
+  addMilliseconds(&t, milliseconds);
+  nanosleep(&t, NULL);
+}
+
+// Pushes 1, 2, 3, ...
+static void *producer(void *unused) {
+  (void)unused;
+  uint32_t value = 0;
+  if (phase == PHASE_FLOOD) {
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+      for (uint32_t i = 0; i < SAMPLES_PER_MILLISECOND; i++)
+        buffer_pushover(++value);
+      clock_gettime(CLOCK_MONOTONIC, &now);
+    } while (value < FLOOD_MAX_VALUE &&
+             (now.tv_sec - start.tv_sec) * 1000 +
+                 (now.tv_nsec - start.tv_nsec) / NANOSECONDS_PER_MILLISECOND <
+             phaseMilliseconds);
+  } else {
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (uint32_t ms = 0; ms < phaseMilliseconds; ms++) {
+      for (uint32_t i = 0; i < SAMPLES_PER_MILLISECOND; i++)
+        buffer_pushover(++value);
+      addMilliseconds(&next, 1);
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+  }
+  pushedCount = value;
+  atomic_store(&producerDone, true);
+  return NULL;
+}
+
+// Runs one phase and returns true if it passed.
+static bool runPhase(phase_t newPhase) {
+  static buffer_data_t block[POP_BLOCK_SIZE];
+  phase = newPhase;
+  buffer_init();
+  atomic_store(&producerDone, false);
+  pthread_t thread;
+  pthread_create(&thread, NULL, producer, NULL);
+
+  uint32_t poppedCount = 0;
+  uint32_t last = 0;
+  uint32_t errorCount = 0;
+  bool stalled = false;
+  uint32_t popCalls = 0;
+  while (true) {
+    bool done = atomic_load(&producerDone);
+    if (phase == PHASE_STALLED && !stalled && poppedCount > 0) {
+      sleepMilliseconds(STALL_MILLISECONDS);
+      stalled = true;
+    }
+    // Mostly blocks, sometimes single values (buffer_pop() cannot tell an
+    // empty buffer from a value of zero, so use a block of one).
+    uint32_t droppedBefore = buffer_getDroppedSampleCount();
+    uint32_t count =
+        buffer_popBlock(block, ++popCalls % 8 == 0 ? 1 : POP_BLOCK_SIZE);
+    // Dropped values always come before the values that were popped.
+    uint32_t expected = last + 1 + buffer_getDroppedSampleCount() - droppedBefore;
+    for (uint32_t i = 0; i < count; i++, expected++) {
+      if (block[i] != (expected & BUFFER_DATA_MASK)) {
+        if (errorCount++ < 5)
+          printf(" -- error: popped %u, expected %u\n", block[i],
+                 expected & BUFFER_DATA_MASK);
+      }
+    }
+    last = expected - 1;
+    poppedCount += count;
+    if (count == 0) {
+      if (done && buffer_elements() == 0)
+        break;
+      sched_yield();
+    }
+  }
+  pthread_join(thread, NULL);
+
+  uint32_t droppedCount = buffer_getDroppedSampleCount();
+  if (poppedCount + droppedCount != pushedCount) {
+    printf(" -- error: popped %u + dropped %u != pushed %u\n", poppedCount,
+           droppedCount, pushedCount);
+    errorCount++;
+  }
+  if (last != pushedCount) {
+    printf(" -- error: last value %u, pushed %u\n", last, pushedCount);
+    errorCount++;
+  }
+  if (phase == PHASE_PACED && droppedCount != 0) {
+    printf(" -- error: dropped values while keeping up\n");
+    errorCount++;
+  }
+  if (phase == PHASE_STALLED && droppedCount == 0) {
+    printf(" -- error: the stall did not overflow the buffer\n");
+    errorCount++;
+  }
+  printf("%-8s pushed %9u popped %9u dropped %9u errors: %u\n",
+         phaseNames[phase], pushedCount, poppedCount, droppedCount, errorCount);
+  return errorCount == 0;
+}
+
+int main(int argc, char *argv[]) {
+  phaseMilliseconds = argc > 1 ? atoi(argv[1]) : DEFAULT_PHASE_MILLISECONDS;
+  bool success = true;
+  success &= runPhase(PHASE_PACED);
+  success &= runPhase(PHASE_STALLED);
+  success &= runPhase(PHASE_FLOOD);
+  printf("bufferStressTest %s\n", success ? "passed" : "failed");
+  return success ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Throughput benchmark for the detector hot path. Simulates a player
+// shooting at the selected frequency (200 ms bursts every second) into the
+// ADC, runs the ISR at 100 kHz simulated time, and drains the ADC buffer with
+// detector() the way game.c does. Reports how many times faster than real
+// time the detector runs, how much time the ISR takes and how long after the
+// start of a shot the hit is detected.
+// Usage: detectorBenchmark [simulatedSeconds] [frequencyNumber] [structure]
+//                          [resolution] [signalAmplitude] [fudgeFactorIndex]
+//                          [channelCount]
+// where structure is direct, delay, biquad (the default) or dft; see
+// filter_setIirStructure(). resolution is single (the default) or multi, which
+// enables multi-resolution detection; see detector_setMultiResolution().
+// signalAmplitude is the swing of the square wave around mid-scale in ADC
+// counts (full scale by default); weak shots take longer to detect.
+// fudgeFactorIndex selects the detection profile (0, the median detector, by
+// default); see detector_setFudgeFactorIndex(). The CFAR profiles learn the
+// noise floor while the first burst is on the air, so that burst is not counted.
+// channelCount replaces the default frequency plan with one that has a player
+// every tick period from 21 (4762 Hz) up (see frequencyPlan.h).
+// Returns 0 if every burst was detected on the right frequency.
+// Run under "perf record" to profile the detector. Built with the ISR_PROFILER
+// option, also prints the cost of each ISR tick call (see isrProfiler.h).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "detector.h"
+#include "filter.h"
+#include "frequencyPlan.h"
+#include "host.h"
+#include "interrupts.h"
+#include "intervalTimer.h"
+#include "isr.h"
+#include "isrMonitor.h"
+#include "isrProfiler.h"
+#include "transmitter.h"
+
+#define DEFAULT_SIMULATED_SECONDS 10
+#define DEFAULT_FREQUENCY_NUMBER 3
+#define ADC_MAX_VALUE 4095
+#define ADC_NOISE_AMPLITUDE 64
+#define ADC_SIGNAL_LOW ADC_NOISE_AMPLITUDE
+#define ADC_SIGNAL_HIGH (ADC_MAX_VALUE - ADC_NOISE_AMPLITUDE)
+#define BURST_PERIOD_TICKS 100000 // A shot every second.
+#define TICKS_PER_DETECTOR_CALL 100 // Detector sees ~1 ms of new samples.
+#define ISR_CUMULATIVE_TIMER INTERVAL_TIMER_TIMER_0
+#define DETECTOR_CUMULATIVE_TIMER INTERVAL_TIMER_TIMER_2
+#define INTERRUPTS_CURRENTLY_ENABLED true
+#define TICKS_PER_MILLISECOND (HOST_TIMER_TICKS_PER_SECOND / 1000)
+#define LARGE_PLAN_SHORTEST_PERIOD 21 // 4762 Hz, the highest that fits.
+
+static uint16_t frequencyNumber;
+static int32_t signalAmplitude = (ADC_SIGNAL_HIGH - ADC_SIGNAL_LOW) / 2;
+static uint32_t adcTick;
+
+// Uniform noise in [-ADC_NOISE_AMPLITUDE, ADC_NOISE_AMPLITUDE] so that the
+// detector sees a noise floor between shots, like the real receiver.
+static int32_t adcNoise(void) {
+  static uint32_t lfsr = 1;
+  lfsr = lfsr * 1664525 + 1013904223;
+  return (int32_t)(lfsr >> 16) % (ADC_NOISE_AMPLITUDE + 1) *
+         ((lfsr & 1) ? 1 : -1);
+}
+
+// Square wave at the selected player frequency during each burst, mid-scale
+// otherwise, plus noise.
+static uint32_t squareWaveAdcSource(void) {
+  uint32_t burstTick = adcTick++ % BURST_PERIOD_TICKS;
+  int32_t value = (ADC_MAX_VALUE + 1) / 2;
+  if (burstTick < TRANSMITTER_PULSE_WIDTH) {
+    uint16_t period = frequencyPlan_getTickPeriod(frequencyNumber);
+    value += (burstTick % period) < period / 2 ? -signalAmplitude : signalAmplitude;
+  }
+  return value + adcNoise();
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t simulatedSeconds =
+      argc > 1 ? atoi(argv[1]) : DEFAULT_SIMULATED_SECONDS;
+  if (argc > 7) {
+    uint16_t channelCount = atoi(argv[7]);
+    uint16_t tickPeriods[FREQUENCY_PLAN_MAX_CHANNEL_COUNT];
+    for (uint16_t i = 0; i < channelCount && i < FREQUENCY_PLAN_MAX_CHANNEL_COUNT; i++)
+      tickPeriods[i] = LARGE_PLAN_SHORTEST_PERIOD + i;
+    if (!frequencyPlan_set(tickPeriods, channelCount)) {
+      printf("channel count must be 1 to %d\n", FREQUENCY_PLAN_MAX_CHANNEL_COUNT);
+      return 1;
+    }
+  }
+  frequencyNumber = argc > 2 ? atoi(argv[2]) : DEFAULT_FREQUENCY_NUMBER;
+  if (frequencyNumber >= frequencyPlan_getChannelCount()) {
+    printf("frequency number must be less than %d\n",
+           frequencyPlan_getChannelCount());
+    return 1;
+  }
+
+  filter_iirStructure_t structure = FILTER_IIR_BIQUAD;
+  if (argc > 3 && !strcmp(argv[3], "direct"))
+    structure = FILTER_IIR_DIRECT_FORM;
+  else if (argc > 3 && !strcmp(argv[3], "delay"))
+    structure = FILTER_IIR_DELAY_LINE;
+  else if (argc > 3 && !strcmp(argv[3], "dft"))
+    structure = FILTER_IIR_SLIDING_DFT;
+  else if (argc > 3 && strcmp(argv[3], "biquad")) {
+    printf("structure must be direct, delay, biquad or dft\n");
+    return 1;
+  }
+
+  detector_initWithIirStructure(structure);
+  if (argc > 4 && !strcmp(argv[4], "multi"))
+    detector_setMultiResolution(true);
+  else if (argc > 4 && strcmp(argv[4], "single")) {
+    printf("resolution must be single or multi\n");
+    return 1;
+  }
+  if (argc > 5)
+    signalAmplitude = atoi(argv[5]);
+  uint16_t fudgeFactorIndex = argc > 6 ? atoi(argv[6]) : 0;
+  detector_setFudgeFactorIndex(fudgeFactorIndex);
+  isr_init();
+  intervalTimer_initAll();
+  interrupts_initAll(false);
+  host_setAdcSource(squareWaveAdcSource);
+  interrupts_enableTimerGlobalInts();
+  interrupts_startArmPrivateTimer();
+  interrupts_enableArmInts();
+
+  uint32_t totalTicks = simulatedSeconds * HOST_TIMER_TICKS_PER_SECOND;
+  uint32_t expectedHits = 0;
+  uint32_t hitCount = 0;
+  uint32_t wrongHitCount = 0;
+  uint32_t latencyTicksSum = 0;
+  uint32_t latencyTicksMax = 0;
+  for (uint32_t tick = 0; tick < totalTicks; tick += TICKS_PER_DETECTOR_CALL) {
+    if (tick % BURST_PERIOD_TICKS == 0 && (tick > 0 || fudgeFactorIndex == 0))
+      expectedHits++;
+    host_runTimerTicks(TICKS_PER_DETECTOR_CALL);
+    intervalTimer_start(DETECTOR_CUMULATIVE_TIMER);
+    detector(INTERRUPTS_CURRENTLY_ENABLED);
+    intervalTimer_stop(DETECTOR_CUMULATIVE_TIMER);
+    if (detector_hitDetected()) {
+      if (tick < BURST_PERIOD_TICKS && fudgeFactorIndex > 0) {
+        detector_clearHit();
+        continue;
+      }
+      // The detector has seen the samples up to the end of this call.
+      uint32_t latencyTicks =
+          (tick + TICKS_PER_DETECTOR_CALL) % BURST_PERIOD_TICKS;
+      if (detector_getFrequencyNumberOfLastHit() == frequencyNumber) {
+        hitCount++;
+        latencyTicksSum += latencyTicks;
+        if (latencyTicks > latencyTicksMax)
+          latencyTicksMax = latencyTicks;
+      } else
+        wrongHitCount++;
+      detector_clearHit();
+    }
+  }
+  interrupts_disableArmInts();
+
+  double simulated = (double)totalTicks / HOST_TIMER_TICKS_PER_SECOND;
+  double detectorSeconds =
+      intervalTimer_getTotalDurationInSeconds(DETECTOR_CUMULATIVE_TIMER);
+  double isrSeconds =
+      intervalTimer_getTotalDurationInSeconds(ISR_CUMULATIVE_TIMER);
+  printf("simulated time:        %.2f s (%u ADC samples)\n", simulated,
+         totalTicks);
+  printf("detector time:         %.3f s (%.1fx real time, %.1f ns/sample)\n",
+         detectorSeconds, simulated / detectorSeconds,
+         detectorSeconds * 1.0E9 / totalTicks);
+  printf("ISR time:              %.3f s (%.1f ns/tick)\n", isrSeconds,
+         isrSeconds * 1.0E9 / totalTicks);
+  printf("detector invocations:  %u\n", detector_getInvocationCount());
+  printf("hits on frequency %u:   %u of %u bursts\n", frequencyNumber, hitCount,
+         expectedHits);
+  printf("hits on other freqs:   %u\n", wrongHitCount);
+  if (hitCount > 0)
+    printf("hit latency:           %.1f ms mean, %.1f ms max\n",
+           (double)latencyTicksSum / hitCount / TICKS_PER_MILLISECOND,
+           (double)latencyTicksMax / TICKS_PER_MILLISECOND);
+  isrMonitor_printStatistics();
+#ifdef ISR_PROFILER
+  isrProfiler_print();
+#endif
+  return (hitCount == expectedHits && wrongHitCount == 0) ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Runs the milestone test suites natively. Usage: lasertagTest <suite>
+// Returns 0 if the suite passed. Suites that only print their results
+// (buffer, detector) are checked by the output patterns in CMakeLists.txt.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bufferTest.h"
+#include "detector.h"
+#include "filter.h"
+#include "filterTest.h"
+#include "isrMonitorTest.h"
+#include "isrProfilerTest.h"
+#include "mixerTest.h"
+#include "powerSelectTest.h"
+#include "queueTest.h"
+#include "timerServiceTest.h"
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    printf("usage: %s queue|buffer|filter|detector|powerSelect|timerService|"
+           "isrProfiler|isrMonitor|mixer\n",
+           argv[0]);
+    return 1;
+  }
+  bool success = true;
+  if (!strcmp(argv[1], "queue")) {
+    success = queue_runTest();
+  } else if (!strcmp(argv[1], "buffer")) {
+    buffer_runTest();
+  } else if (!strcmp(argv[1], "filter")) {
+    success = filter_runTest();
+  } else if (!strcmp(argv[1], "detector")) {
+    detector_init();
+    detector_runTest();
+  } else if (!strcmp(argv[1], "powerSelect")) {
+    success = powerSelect_runTest();
+  } else if (!strcmp(argv[1], "timerService")) {
+    success = timerService_runTest();
+  } else if (!strcmp(argv[1], "isrProfiler")) {
+    success = isrProfiler_runTest();
+  } else if (!strcmp(argv[1], "isrMonitor")) {
+    success = isrMonitor_runTest();
+  } else if (!strcmp(argv[1], "mixer")) {
+    success = mixer_runTest();
+  } else {
+    printf("unknown test suite: %s\n", argv[1]);
+    return 1;
+  }
+  return success ? 0 : 1;
+}
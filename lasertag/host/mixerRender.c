@@ -0,0 +1,245 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Renders a busy stretch of a game through the sound mixer into a WAV file, so
+// that the mix can be listened to off the board. The player is hit, keeps
+// firing every 100 ms, reloads, hears the game start and pulls the trigger on
+// an empty clip while all four voices are busy. The game sounds are at the
+// priorities that sound.c gives them, and IMA-ADPCM like the game plays them.
+// Usage: mixerRender [wavFile]
+// writes mixerRender.wav by default, 16-bit mono at 48 kHz, and prints the
+// peak, the number of clipped samples and the cost of the mix. First checks
+// each IMA-ADPCM sound against its wav2c array and prints the size and the
+// signal-to-noise ratio of both.
+// Returns 0 if the hit sound played to its end through the gunfire and every
+// IMA-ADPCM sound is within MIN_SNR_DB of its wav2c array.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// The wav2c headers need stdint.h first.
+#include "blasterReload48k.adpcm.h"
+#include "blasterReload48k.wav.h"
+#include "blasterShot48k.adpcm.h"
+#include "blasterShot48k.wav.h"
+#include "droidHit48k.adpcm.h"
+#include "droidHit48k.wav.h"
+#include "gunEmpty48k.adpcm.h"
+#include "gunEmpty48k.wav.h"
+#include "helloThere48k.adpcm.h"
+#include "helloThere48k.wav.h"
+#include "intervalTimer.h"
+#include "mixer.h"
+
+#define DEFAULT_WAV_FILE "mixerRender.wav"
+#define SAMPLE_RATE 48000
+#define SAMPLES_PER_MILLISECOND (SAMPLE_RATE / 1000)
+#define CHUNK_SAMPLES (10 * SAMPLES_PER_MILLISECOND) // 10 ms per render.
+#define MAX_SAMPLES (5 * SAMPLE_RATE)
+#define GUNFIRE_START_MILLISECONDS 50
+#define GUNFIRE_PERIOD_MILLISECONDS 100
+#define GUNFIRE_END_MILLISECONDS 1500
+#define RELOAD_MILLISECONDS 300
+#define GAME_START_MILLISECONDS 400
+#define CLICK_MILLISECONDS 450
+#define GUNFIRE_VOLUME (MIXER_FULL_VOLUME / 2)
+#define BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define NANOSECONDS_PER_SECOND 1.0E9
+#define SAMPLES_PER_ISR_TICK 0.48 // 48 kHz audio, 100 kHz ticks.
+// Well above what a decoder that is out of step with encodeAdpcm.py gets.
+#define MIN_SNR_DB 15.0
+
+// The priorities in sound.c.
+#define PRIORITY_BACKGROUND 0
+#define PRIORITY_EFFECT 1
+#define PRIORITY_HIT 2
+#define PRIORITY_GAME 3
+
+// A sound in both of its forms.
+typedef struct {
+  const char *name;
+  const uint16_t *samples;
+  const uint8_t *adpcm;
+  uint32_t sampleCount;
+} encodedSound_t;
+
+static const encodedSound_t encodedSounds[] = {
+    {"droidHit48k", droidHit48k_wav, droidHit48k_adpcm,
+     DROIDHIT48K_WAV_NUMBER_OF_SAMPLES},
+    {"blasterShot48k", blasterShot48k_wav, blasterShot48k_adpcm,
+     BLASTERSHOT48K_WAV_NUMBER_OF_SAMPLES},
+    {"blasterReload48k", blasterReload48k_wav, blasterReload48k_adpcm,
+     BLASTERRELOAD48K_WAV_NUMBER_OF_SAMPLES},
+    {"helloThere48k", helloThere48k_wav, helloThere48k_adpcm,
+     HELLOTHERE48K_WAV_NUMBER_OF_SAMPLES},
+    {"gunEmpty48k", gunEmpty48k_wav, gunEmpty48k_adpcm,
+     GUNEMPTY48K_WAV_NUMBER_OF_SAMPLES},
+};
+#define ENCODED_SOUND_COUNT (sizeof(encodedSounds) / sizeof(encodedSounds[0]))
+
+static mixer_sound_t hit, gunfire, reload, gameStart, click;
+static int16_t output[MAX_SAMPLES];
+static int16_t reference[MAX_SAMPLES];
+
+// Plays the sound on its own and returns the mixer output in out[].
+static void renderAlone(mixer_sound_t *sound, int16_t out[],
+                        uint32_t sampleCount) {
+  mixer_play(sound, MIXER_FULL_VOLUME);
+  mixer_render(out, sampleCount);
+}
+
+// Prints the size and the signal-to-noise ratio of each IMA-ADPCM sound.
+// Returns false if one is below MIN_SNR_DB.
+static bool checkAdpcm() {
+  bool success = true;
+  uint32_t wavBytes = 0;
+  uint32_t adpcmBytes = 0;
+  for (uint16_t i = 0; i < ENCODED_SOUND_COUNT; i++) {
+    const encodedSound_t *encoded = &encodedSounds[i];
+    mixer_sound_t wav, adpcm;
+    mixer_init();
+    mixer_register(&wav, encoded->samples, encoded->sampleCount, 0);
+    mixer_registerAdpcm(&adpcm, encoded->adpcm, encoded->sampleCount, 0);
+    renderAlone(&wav, reference, encoded->sampleCount);
+    renderAlone(&adpcm, output, encoded->sampleCount);
+    double signal = 0.0;
+    double noise = 0.0;
+    for (uint32_t k = 0; k < encoded->sampleCount; k++) {
+      double error = (double)output[k] - reference[k];
+      signal += (double)reference[k] * reference[k];
+      noise += error * error;
+    }
+    double snr = 10.0 * log10(signal / noise);
+    uint32_t bytes = (encoded->sampleCount + ADPCM_SAMPLES_PER_BYTE - 1) /
+                     ADPCM_SAMPLES_PER_BYTE;
+    printf("%-17s %6u samples: %6u bytes as wav2c, %6u as IMA-ADPCM, SNR "
+           "%.1lf dB\n",
+           encoded->name, encoded->sampleCount,
+           encoded->sampleCount * (uint32_t)sizeof(uint16_t), bytes, snr);
+    wavBytes += encoded->sampleCount * sizeof(uint16_t);
+    adpcmBytes += bytes;
+    success &= snr >= MIN_SNR_DB;
+  }
+  printf("IMA-ADPCM: %u bytes instead of %u, %.2lf times smaller\n",
+         adpcmBytes, wavBytes, (double)wavBytes / adpcmBytes);
+  return success;
+}
+
+// Writes value as count little-endian bytes.
+static void writeLittleEndian(FILE *file, uint32_t value, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++)
+    fputc((value >> (8 * i)) & 0xFF, file);
+}
+
+// Writes the samples as a 16-bit mono PCM WAV file.
+static bool writeWav(const char *fileName, const int16_t samples[],
+                     uint32_t sampleCount) {
+  FILE *file = fopen(fileName, "wb");
+  if (file == NULL) {
+    printf("cannot open %s\n", fileName);
+    return false;
+  }
+  uint32_t dataBytes = sampleCount * sizeof(int16_t);
+  fputs("RIFF", file);
+  writeLittleEndian(file, 36 + dataBytes, 4);
+  fputs("WAVEfmt ", file);
+  writeLittleEndian(file, 16, 4);          // Format chunk size.
+  writeLittleEndian(file, 1, 2);           // PCM.
+  writeLittleEndian(file, 1, 2);           // Mono.
+  writeLittleEndian(file, SAMPLE_RATE, 4); // Samples per second.
+  writeLittleEndian(file, SAMPLE_RATE * sizeof(int16_t), 4);
+  writeLittleEndian(file, sizeof(int16_t), 2); // Bytes per sample.
+  writeLittleEndian(file, 16, 2);              // Bits per sample.
+  fputs("data", file);
+  writeLittleEndian(file, dataBytes, 4);
+  for (uint32_t i = 0; i < sampleCount; i++)
+    writeLittleEndian(file, (uint16_t)samples[i], 2);
+  return fclose(file) == 0;
+}
+
+// Posts the plays of the scenario that fall in the chunk starting at sample.
+static void playScenario(uint32_t sample) {
+  uint32_t millisecond = sample / SAMPLES_PER_MILLISECOND;
+  uint32_t chunkMilliseconds = CHUNK_SAMPLES / SAMPLES_PER_MILLISECOND;
+  if (millisecond == 0)
+    mixer_play(&hit, MIXER_FULL_VOLUME);
+  if (millisecond >= GUNFIRE_START_MILLISECONDS &&
+      millisecond <= GUNFIRE_END_MILLISECONDS &&
+      (millisecond - GUNFIRE_START_MILLISECONDS) %
+              GUNFIRE_PERIOD_MILLISECONDS <
+          chunkMilliseconds)
+    mixer_play(&gunfire, GUNFIRE_VOLUME);
+  if (millisecond == RELOAD_MILLISECONDS)
+    mixer_play(&reload, MIXER_FULL_VOLUME);
+  if (millisecond == GAME_START_MILLISECONDS)
+    mixer_play(&gameStart, MIXER_FULL_VOLUME);
+  if (millisecond == CLICK_MILLISECONDS)
+    mixer_play(&click, MIXER_FULL_VOLUME);
+}
+
+int main(int argc, char *argv[]) {
+  const char *fileName = argc > 1 ? argv[1] : DEFAULT_WAV_FILE;
+  bool adpcmMatches = checkAdpcm();
+  mixer_init();
+  mixer_registerAdpcm(&hit, droidHit48k_adpcm,
+                      DROIDHIT48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_HIT);
+  mixer_registerAdpcm(&gunfire, blasterShot48k_adpcm,
+                      BLASTERSHOT48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_BACKGROUND);
+  mixer_registerAdpcm(&reload, blasterReload48k_adpcm,
+                      BLASTERRELOAD48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_EFFECT);
+  mixer_registerAdpcm(&gameStart, helloThere48k_adpcm,
+                      HELLOTHERE48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_GAME);
+  mixer_registerAdpcm(&click, gunEmpty48k_adpcm,
+                      GUNEMPTY48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_BACKGROUND);
+
+  // Render in chunks until the last sound ends, noting where the hit stops.
+  uint32_t sampleCount = 0;
+  uint32_t hitEnd = 0;
+  intervalTimer_init(BENCHMARK_TIMER);
+  intervalTimer_start(BENCHMARK_TIMER);
+  do {
+    playScenario(sampleCount);
+    mixer_render(&output[sampleCount], CHUNK_SAMPLES);
+    sampleCount += CHUNK_SAMPLES;
+    if (hitEnd == 0 && !mixer_isPlaying(&hit))
+      hitEnd = sampleCount;
+  } while (mixer_isBusy() && sampleCount + CHUNK_SAMPLES <= MAX_SAMPLES);
+  intervalTimer_stop(BENCHMARK_TIMER);
+  double nanoseconds = intervalTimer_getTotalDurationInSeconds(BENCHMARK_TIMER) *
+                       NANOSECONDS_PER_SECOND / sampleCount;
+
+  int16_t peak = 0;
+  uint32_t clippedCount = 0;
+  for (uint32_t i = 0; i < sampleCount; i++) {
+    int16_t magnitude = output[i] < 0 ? -(output[i] + 1) : output[i];
+    if (magnitude > peak)
+      peak = magnitude;
+    if (output[i] == INT16_MAX || output[i] == INT16_MIN)
+      clippedCount++;
+  }
+  printf("rendered %.2lf s to %s: peak %d, %u clipped samples\n",
+         (double)sampleCount / SAMPLE_RATE, fileName, peak, clippedCount);
+  printf("mix: %.2lf ns per output sample in %d-sample chunks, %.2lf ns per "
+         "ISR tick\n",
+         nanoseconds, CHUNK_SAMPLES, nanoseconds * SAMPLES_PER_ISR_TICK);
+  // The hit is done once the chunk that holds its last sample is rendered.
+  bool hitComplete = hitEnd >= DROIDHIT48K_WAV_NUMBER_OF_SAMPLES &&
+                     hitEnd < DROIDHIT48K_WAV_NUMBER_OF_SAMPLES + CHUNK_SAMPLES;
+  printf("hit sound %s\n", hitComplete ? "played to its end"
+                                       : "was cut off");
+  if (!writeWav(fileName, output, sampleCount))
+    return 1;
+  return hitComplete && adpcmMatches ? 0 : 1;
+}
@@ -4,12 +4,11 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-// Perform any necessary inits for the invincibility timer.
+// Perform any necessary inits for the invincibility timer. Registers the timer
+// with the timer service (see timerService.h), which ends invincibility from
+// the ISR.
 void invincibilityTimer_init();
 
-// Standard tick function.
-void invincibilityTimer_tick();
-
 // Calling this starts the timer.
 void invincibilityTimer_start(uint32_t seconds);
 
@@ -7,12 +7,18 @@
 #include "autoReloadTimer.h"
 #include "invincibilityTimer.h"
 #include "sound.h"
+#include "timerService.h"
+#include "isrProfiler.h"
+#include "isrMonitor.h"
 // The interrupt service routine (ISR) is implemented here.
 // Add function calls for state machine tick functions and
 // other interrupt related modules.
 
 // Perform initialization for interrupt and timing related modules.
 void isr_init() {
+    timerService_init(); //before the timers below register with it
+    isrProfiler_init();
+    isrMonitor_init();
     lockoutTimer_init();
     transmitter_init();
     trigger_init();
@@ -24,14 +30,18 @@ void isr_init() {
 }
 
 // This function is invoked by the timer interrupt at 100 kHz.
+// With the ISR_PROFILER option each call is timed, see isrProfiler.h.
+// isrMonitor checks every invocation for overruns, see isrMonitor.h.
 void isr_function() {
-    lockoutTimer_tick();
-    transmitter_tick();
-    trigger_tick();
-    hitLedTimer_tick();
-    buffer_pushover(interrupts_getAdcData());
-    sound_tick();
-    autoReloadTimer_tick();
-    invincibilityTimer_tick();
-
+    uint32_t entryCounter = interrupts_getPrivateTimerCounterValue();
+    bool bufferOverwritten;
+    //lockout, hit-LED, auto-reload and invincibility timers
+    ISR_PROFILER_MEASURE(ISR_PROFILER_TIMER_SERVICE, timerService_tick());
+    ISR_PROFILER_MEASURE(ISR_PROFILER_TRANSMITTER, transmitter_tick());
+    ISR_PROFILER_MEASURE(ISR_PROFILER_TRIGGER, trigger_tick());
+    ISR_PROFILER_MEASURE(ISR_PROFILER_BUFFER,
+        bufferOverwritten = buffer_pushover(interrupts_getAdcData()));
+    ISR_PROFILER_MEASURE(ISR_PROFILER_SOUND, sound_tick());
+    isrMonitor_recordIsr(entryCounter, interrupts_getPrivateTimerCounterValue(),
+                         bufferOverwritten);
 }
@@ -0,0 +1,150 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include "interrupts.h"
+#include "isrMonitor.h"
+
+#define EVENT_INDEX_MASK (ISR_MONITOR_EVENT_LOG_SIZE - 1)
+//the private timer runs at half of the 650 MHz CPU clock, with no prescaler
+#define PRIVATE_TIMER_CLOCK_HZ 325000000
+#define NANOSECONDS_PER_SECOND 1.0E9
+//a new worst case is logged once it is 1/8 worse than the last one logged
+#define WORST_CASE_LOG_SHIFT 3
+
+//written by the ISR only
+static isrMonitor_statistics_t totals;
+static uint32_t loggedLatency;
+static uint32_t loggedDuration;
+static bool overwriting;
+
+//single-producer/single-consumer ring, like the ADC buffer: the ISR only
+//writes head, the main loop only writes tail, and both count every event
+//ever logged
+static isrMonitor_event_t events[ISR_MONITOR_EVENT_LOG_SIZE];
+static _Atomic uint32_t head;
+static _Atomic uint32_t tail;
+
+static const char *eventNames[] = {"deadline missed", "worst latency",
+                                   "worst duration", "buffer overwrite"};
+
+static void logEvent(isrMonitor_eventType_t type, uint32_t latency,
+                     uint32_t duration) {
+    uint32_t index = atomic_load_explicit(&head, memory_order_relaxed);
+    if (index - atomic_load_explicit(&tail, memory_order_acquire) >=
+        ISR_MONITOR_EVENT_LOG_SIZE) {
+        totals.lostEventCount++;
+        return;
+    }
+    isrMonitor_event_t *event = &events[index & EVENT_INDEX_MASK];
+    event->type = type;
+    event->tick = totals.tickCount;
+    event->latency = latency;
+    event->duration = duration;
+    atomic_store_explicit(&head, index + 1, memory_order_release);
+}
+
+//true if value is more than 1/8 above the last value logged
+static inline bool muchWorse(uint32_t value, uint32_t logged) {
+    return value > logged + (logged >> WORST_CASE_LOG_SHIFT);
+}
+
+// Clears the totals and the event log and reads the tick period.
+void isrMonitor_init() {
+    totals = (isrMonitor_statistics_t){0};
+    totals.minLatency = UINT32_MAX;
+    totals.periodCounts =
+        PRIVATE_TIMER_CLOCK_HZ / interrupts_getPrivateTimerTicksPerSecond();
+    loggedLatency = 0;
+    loggedDuration = 0;
+    overwriting = false;
+    atomic_store(&head, 0);
+    atomic_store(&tail, 0);
+}
+
+// Records one ISR from the private timer counter at its start and at its end.
+void isrMonitor_recordIsr(uint32_t entryCounter, uint32_t exitCounter,
+                          bool bufferOverwritten) {
+    uint32_t loadValue = totals.periodCounts - 1;
+    uint32_t latency = loadValue - entryCounter;
+    uint32_t duration;
+    bool missed = exitCounter > entryCounter; //the counter reloaded
+    if (missed)
+        duration = entryCounter + totals.periodCounts - exitCounter;
+    else
+        duration = entryCounter - exitCounter;
+    totals.tickCount++;
+    if (latency < totals.minLatency)
+        totals.minLatency = latency;
+    if (latency > totals.maxLatency)
+        totals.maxLatency = latency;
+    if (duration > totals.maxDuration)
+        totals.maxDuration = duration;
+
+    if (missed) {
+        totals.missedDeadlineCount++;
+        logEvent(ISR_MONITOR_DEADLINE_MISSED, latency, duration);
+    }
+    if (muchWorse(latency, loggedLatency)) {
+        loggedLatency = latency;
+        logEvent(ISR_MONITOR_WORST_LATENCY, latency, duration);
+    }
+    if (muchWorse(duration, loggedDuration)) {
+        loggedDuration = duration;
+        logEvent(ISR_MONITOR_WORST_DURATION, latency, duration);
+    }
+    if (bufferOverwritten) {
+        totals.overwrittenSampleCount++;
+        //once the detector is a buffer behind every sample is an overwrite,
+        //so only the first of the run is logged
+        if (!overwriting)
+            logEvent(ISR_MONITOR_BUFFER_OVERWRITE, latency, duration);
+    }
+    overwriting = bufferOverwritten;
+}
+
+// Removes the oldest event from the log.
+bool isrMonitor_popEvent(isrMonitor_event_t *event) {
+    uint32_t index = atomic_load_explicit(&tail, memory_order_relaxed);
+    if (index == atomic_load_explicit(&head, memory_order_acquire))
+        return false;
+    *event = events[index & EVENT_INDEX_MASK];
+    //the slot is handed back to the ISR only after it has been copied
+    atomic_store_explicit(&tail, index + 1, memory_order_release);
+    return true;
+}
+
+// Fills in the totals.
+void isrMonitor_getStatistics(isrMonitor_statistics_t *statistics) {
+    *statistics = totals;
+    if (statistics->tickCount == 0)
+        statistics->minLatency = 0;
+}
+
+// Converts private timer counts to nanoseconds.
+double isrMonitor_countsToNanoseconds(uint32_t counts) {
+    return counts * NANOSECONDS_PER_SECOND / PRIVATE_TIMER_CLOCK_HZ;
+}
+
+// Drains the event log to the console.
+void isrMonitor_printEvents() {
+    isrMonitor_event_t event;
+    while (isrMonitor_popEvent(&event))
+        printf("ISR %s at tick %u: latency %.0f ns, duration %.0f ns\n",
+               eventNames[event.type], event.tick,
+               isrMonitor_countsToNanoseconds(event.latency),
+               isrMonitor_countsToNanoseconds(event.duration));
+}
+
+// Prints the totals to the console.
+void isrMonitor_printStatistics() {
+    isrMonitor_statistics_t statistics;
+    isrMonitor_getStatistics(&statistics);
+    printf("ISR ticks: %u, missed deadlines: %u, overwritten samples: %u, "
+           "lost events: %u\n",
+           statistics.tickCount, statistics.missedDeadlineCount,
+           statistics.overwrittenSampleCount, statistics.lostEventCount);
+    printf("ISR latency: %.0f to %.0f ns, longest ISR: %.0f ns of %.0f ns\n",
+           isrMonitor_countsToNanoseconds(statistics.minLatency),
+           isrMonitor_countsToNanoseconds(statistics.maxLatency),
+           isrMonitor_countsToNanoseconds(statistics.maxDuration),
+           isrMonitor_countsToNanoseconds(statistics.periodCounts));
+}
@@ -0,0 +1,97 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef ISRMONITOR_H_
+#define ISRMONITOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Watches the timer ISR for overruns and jitter. isr_function() reads the
+// private timer counter (interrupts_getPrivateTimerCounterValue()) when it
+// starts and when it ends and passes both to isrMonitor_recordIsr(). The
+// counter counts down from the load value to 0 once per 100 kHz period and
+// the interrupt is raised when it reloads, so:
+//  - the entry latency, the time from the interrupt to the start of the ISR,
+//    is the load value minus the counter at entry, and its spread is the
+//    jitter of the tick;
+//  - if the counter has reloaded by the end of the ISR, the next interrupt was
+//    raised while the ISR was still running. timerIsr() clears the interrupt
+//    status when it returns, so that tick is lost: a missed deadline.
+// The counter only tells where in the period the ISR ends, so an ISR that runs
+// for a whole period or more shows up a period short, and only counts as an
+// overrun if it ends earlier in a period than it started.
+//
+// isr_function() also reports each ADC sample that buffer_pushover() wrote
+// over an unread one, i.e. the detector fell a whole buffer behind.
+//
+// Missed deadlines, the start of each run of buffer overwrites and every
+// latency or duration more than 1/8 worse than the worst one logged so far
+// are logged as events in a ring that the main loop drains with
+// isrMonitor_popEvent(). The ring is lock-free for the ISR as the only writer
+// and the main loop as the only reader. When it is full, new events are
+// counted as lost and dropped.
+
+#define ISR_MONITOR_EVENT_LOG_SIZE 64 // Must be a power of two.
+
+typedef enum {
+  ISR_MONITOR_DEADLINE_MISSED,  // The ISR ran into the next tick.
+  ISR_MONITOR_WORST_LATENCY,    // The longest entry latency so far.
+  ISR_MONITOR_WORST_DURATION,   // The longest ISR so far.
+  ISR_MONITOR_BUFFER_OVERWRITE, // The first of a run of overwritten samples.
+} isrMonitor_eventType_t;
+
+// Times are in private timer counts (3.08 ns).
+typedef struct {
+  isrMonitor_eventType_t type;
+  uint32_t tick;     // The ISR invocation, counted from isrMonitor_init().
+  uint32_t latency;  // Entry latency of that ISR.
+  uint32_t duration; // Run time of that ISR.
+} isrMonitor_event_t;
+
+// Totals since isrMonitor_init(). Times are in private timer counts.
+typedef struct {
+  uint32_t tickCount;
+  uint32_t missedDeadlineCount;
+  uint32_t overwrittenSampleCount;
+  uint32_t lostEventCount;
+  uint32_t minLatency;
+  uint32_t maxLatency;
+  uint32_t maxDuration;
+  uint32_t periodCounts; // Private timer counts per tick.
+} isrMonitor_statistics_t;
+
+// Clears the totals and the event log and reads the tick period from the
+// interrupts module. isr_init() calls this.
+void isrMonitor_init();
+
+// Records one ISR from the private timer counter at its start and at its end.
+// bufferOverwritten is true if the ISR pushed an ADC sample over an unread
+// one.
+void isrMonitor_recordIsr(uint32_t entryCounter, uint32_t exitCounter,
+                          bool bufferOverwritten);
+
+// Removes the oldest event from the log into event. Returns false if the log
+// is empty. Call this from the main loop only.
+bool isrMonitor_popEvent(isrMonitor_event_t *event);
+
+// Fills in the totals. They are updated by the ISR, so read them with the ISR
+// stopped for a consistent set.
+void isrMonitor_getStatistics(isrMonitor_statistics_t *statistics);
+
+// Converts private timer counts to nanoseconds.
+double isrMonitor_countsToNanoseconds(uint32_t counts);
+
+// Drains the event log to the console, one line per event.
+void isrMonitor_printEvents();
+
+// Prints the totals to the console.
+void isrMonitor_printStatistics();
+
+#endif /* ISRMONITOR_H_ */
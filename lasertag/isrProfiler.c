@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <string.h>
+#include "display.h"
+#include "isrProfiler.h"
+
+#ifdef ZYBO_BOARD
+#include "xparameters.h"
+#else
+#include "host.h"
+#endif
+
+#define OVERHEAD_SAMPLE_COUNT 100
+#define PERCENTILE 0.99
+#define NANOSECONDS_PER_SECOND 1.0E9
+#define ROW_BUFFER_SIZE 80
+#define DISPLAY_TEXT_SIZE 1
+#define DISPLAY_TEXT_COLOR DISPLAY_WHITE
+
+//PMCR bits: enable all counters, reset the cycle counter, count every cycle
+//rather than every 64th
+#define PMCR_ENABLE 0x1
+#define PMCR_CYCLE_COUNTER_RESET 0x4
+#define PMCR_CYCLE_DIVIDER 0x8
+#define PMCNTENSET_CYCLE_COUNTER 0x80000000
+
+typedef struct {
+    uint32_t callCount;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t bins[ISR_PROFILER_BIN_COUNT];
+} profile_t;
+
+static profile_t profiles[ISR_PROFILER_FUNCTION_COUNT];
+static uint32_t readOverhead;
+
+#if defined(HOST_BUILD) && (defined(__x86_64__) || defined(__i386__))
+//the TSC rate is not known, so it is measured against the monotonic clock
+//from isrProfiler_init() to each isrProfiler_getStatistics()
+static uint64_t calibrationCounter;
+static uint64_t calibrationNanoseconds;
+#endif
+
+static const char *names[ISR_PROFILER_FUNCTION_COUNT] = {
+    "timerService_tick", "transmitter_tick", "trigger_tick", "buffer_pushover",
+    "sound_tick"};
+
+//counts below 8 have their own bin, larger ones are binned on their top four
+//bits: the leading one picks the power of two and the next three one of its
+//eight bins
+static inline uint16_t binOf(uint32_t count) {
+    if (count < 8)
+        return count;
+    uint16_t msb = 31 - __builtin_clz(count);
+    if (msb >= ISR_PROFILER_MAX_COUNT_BITS)
+        return ISR_PROFILER_BIN_COUNT - 1;
+    return 8 * (msb - 2) + ((count >> (msb - 3)) & 7);
+}
+
+//the largest count that lands in the bin
+static uint32_t binUpperEdge(uint16_t bin) {
+    if (bin < 8)
+        return bin;
+    uint16_t msb = bin / 8 + 2;
+    return ((uint32_t)(8 + bin % 8 + 1) << (msb - 3)) - 1;
+}
+
+static double nanosecondsPerCount() {
+#ifdef ZYBO_BOARD
+    return NANOSECONDS_PER_SECOND / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+#elif defined(__x86_64__) || defined(__i386__)
+    uint64_t counts = __rdtsc() - calibrationCounter;
+    uint64_t nanoseconds = host_getTimeInNanoseconds() - calibrationNanoseconds;
+    return counts > 0 ? (double)nanoseconds / counts : 0.0;
+#else
+    return 1.0; //the counter is the monotonic clock
+#endif
+}
+
+// Starts the counter, measures the cost of reading it and clears the profile.
+void isrProfiler_init() {
+#ifdef ZYBO_BOARD
+    uint32_t control = mfcp(XREG_CP15_PERF_MONITOR_CTRL);
+    control &= ~PMCR_CYCLE_DIVIDER;
+    mtcp(XREG_CP15_PERF_MONITOR_CTRL,
+         control | PMCR_ENABLE | PMCR_CYCLE_COUNTER_RESET);
+    mtcp(XREG_CP15_COUNT_ENABLE_SET, PMCNTENSET_CYCLE_COUNTER);
+#elif defined(__x86_64__) || defined(__i386__)
+    calibrationCounter = __rdtsc();
+    calibrationNanoseconds = host_getTimeInNanoseconds();
+#endif
+    //two back-to-back reads, the least that a measured call can take
+    readOverhead = UINT32_MAX;
+    for (uint16_t i = 0; i < OVERHEAD_SAMPLE_COUNT; i++) {
+        uint32_t start = isrProfiler_readCounter();
+        uint32_t count = isrProfiler_readCounter() - start;
+        if (count < readOverhead)
+            readOverhead = count;
+    }
+    isrProfiler_reset();
+}
+
+// Clears the profile.
+void isrProfiler_reset() {
+    for (uint16_t function = 0; function < ISR_PROFILER_FUNCTION_COUNT; function++) {
+        profile_t *profile = &profiles[function];
+        profile->callCount = 0;
+        profile->min = UINT32_MAX;
+        profile->max = 0;
+        profile->sum = 0;
+        for (uint16_t bin = 0; bin < ISR_PROFILER_BIN_COUNT; bin++)
+            profile->bins[bin] = 0;
+    }
+}
+
+// Adds one call that took count counter counts, less the read overhead.
+void isrProfiler_record(isrProfiler_function_t function, uint32_t count) {
+    profile_t *profile = &profiles[function];
+    count = count > readOverhead ? count - readOverhead : 0;
+    profile->callCount++;
+    profile->sum += count;
+    if (count < profile->min)
+        profile->min = count;
+    if (count > profile->max)
+        profile->max = count;
+    profile->bins[binOf(count)]++;
+}
+
+// Fills in the statistics of one function.
+void isrProfiler_getStatistics(isrProfiler_function_t function,
+                               isrProfiler_statistics_t *statistics) {
+    const profile_t *profile = &profiles[function];
+    statistics->callCount = profile->callCount;
+    statistics->min = profile->callCount ? profile->min : 0;
+    statistics->max = profile->max;
+    statistics->mean =
+        profile->callCount ? (double)profile->sum / profile->callCount : 0.0;
+    //the first bin at which the running count covers 99% of the calls
+    uint32_t target = (uint32_t)(PERCENTILE * profile->callCount + 0.5);
+    uint32_t runningCount = 0;
+    statistics->p99 = 0;
+    for (uint16_t bin = 0; bin < ISR_PROFILER_BIN_COUNT && target > 0; bin++) {
+        runningCount += profile->bins[bin];
+        if (runningCount >= target) {
+            uint32_t edge = binUpperEdge(bin);
+            statistics->p99 = edge < profile->max ? edge : profile->max;
+            break;
+        }
+    }
+    double nanoseconds = nanosecondsPerCount();
+    statistics->meanNanoseconds = statistics->mean * nanoseconds;
+    statistics->p99Nanoseconds = statistics->p99 * nanoseconds;
+}
+
+// Returns the name of the tick call.
+const char *isrProfiler_getName(isrProfiler_function_t function) {
+    return names[function];
+}
+
+//one line of the table; the TFT is too narrow for the nanoseconds
+static void formatRow(isrProfiler_function_t function, char buffer[],
+                      bool nanoseconds) {
+    isrProfiler_statistics_t statistics;
+    isrProfiler_getStatistics(function, &statistics);
+    int length = snprintf(buffer, ROW_BUFFER_SIZE, "%-17s %6u %6.0f %6u %6u",
+                          names[function], statistics.min, statistics.mean,
+                          statistics.p99, statistics.max);
+    if (nanoseconds)
+        snprintf(buffer + length, ROW_BUFFER_SIZE - length, " %7.1f %7.1f",
+                 statistics.meanNanoseconds, statistics.p99Nanoseconds);
+    strcat(buffer, "\n");
+}
+
+#define HEADER "function             min   mean    p99    max"
+
+// Prints the table to the console.
+void isrProfiler_print() {
+    char row[ROW_BUFFER_SIZE];
+    printf("ISR profile in counter counts, less %u for the reads:\n",
+           readOverhead);
+    printf(HEADER " mean ns  p99 ns\n");
+    for (uint16_t function = 0; function < ISR_PROFILER_FUNCTION_COUNT; function++) {
+        formatRow(function, row, true);
+        printf("%s", row);
+    }
+}
+
+// Draws the table on the TFT.
+void isrProfiler_display() {
+    char row[ROW_BUFFER_SIZE];
+    display_fillScreen(DISPLAY_BLACK);
+    display_setTextSize(DISPLAY_TEXT_SIZE);
+    display_setTextColor(DISPLAY_TEXT_COLOR);
+    display_setCursor(0, 0);
+    display_print("ISR profile (CPU cycles)\n\n");
+    display_print(HEADER "\n");
+    for (uint16_t function = 0; function < ISR_PROFILER_FUNCTION_COUNT; function++) {
+        formatRow(function, row, false);
+        display_print(row);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef ISRPROFILER_H_
+#define ISRPROFILER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef ZYBO_BOARD
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include "host.h"
+#endif
+
+// Per-function cost profile of the ISR. With the ISR_PROFILER build option
+// ("cmake -DISR_PROFILER=ON"), isr_function() reads a cycle counter around
+// each of its tick calls and records the difference here: the Cortex-A9 PMU
+// cycle counter on the board, the TSC on an x86 host. Each function keeps its
+// minimum, mean and maximum and a histogram with eight bins per power of two
+// (12.5% resolution), from which the 99th percentile is read. Everything is in
+// fixed arrays, so recording never allocates and costs the same every tick.
+// Without the option isr_function() is not instrumented and nothing is
+// recorded, and the functions below other than isrProfiler_init() are not
+// built.
+
+// The calls that isr_function() makes on every tick.
+typedef enum {
+  ISR_PROFILER_TIMER_SERVICE,
+  ISR_PROFILER_TRANSMITTER,
+  ISR_PROFILER_TRIGGER,
+  ISR_PROFILER_BUFFER,
+  ISR_PROFILER_SOUND,
+  ISR_PROFILER_FUNCTION_COUNT
+} isrProfiler_function_t;
+
+// Counts below 8 get one bin each, then eight bins per power of two up to
+// 2^ISR_PROFILER_MAX_COUNT_BITS; longer calls land in the last bin.
+#define ISR_PROFILER_MAX_COUNT_BITS 24
+#define ISR_PROFILER_BIN_COUNT (8 * (ISR_PROFILER_MAX_COUNT_BITS - 2))
+
+// What has been recorded for one function, in counter counts. The mean and
+// the percentile are also given in nanoseconds.
+typedef struct {
+  uint32_t callCount;
+  uint32_t min;
+  uint32_t max;
+  double mean;
+  uint32_t p99; // Upper edge of the bin that holds the 99th percentile.
+  double meanNanoseconds;
+  double p99Nanoseconds;
+} isrProfiler_statistics_t;
+
+// Reads the free-running counter that the profile is kept in.
+static inline uint32_t isrProfiler_readCounter(void) {
+#ifdef ZYBO_BOARD
+  return mfcp(XREG_CP15_PERF_CYCLE_COUNTER);
+#elif defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__rdtsc();
+#else
+  return (uint32_t)host_getTimeInNanoseconds();
+#endif
+}
+
+// Wraps one call in isr_function(). Expands to the bare call without the
+// ISR_PROFILER option.
+#ifdef ISR_PROFILER
+#define ISR_PROFILER_MEASURE(function, call)                                   \
+  do {                                                                         \
+    uint32_t isrProfilerStart = isrProfiler_readCounter();                     \
+    call;                                                                      \
+    isrProfiler_record(function, isrProfiler_readCounter() - isrProfilerStart);\
+  } while (0)
+#else
+#define ISR_PROFILER_MEASURE(function, call) call
+#endif
+
+// Starts the counter (the PMU cycle counter on the board), measures the cost
+// of reading it and clears the profile. isr_init() calls this. isrProfiler.c
+// is only built with the ISR_PROFILER option; without it this does nothing and
+// the PMU is left alone.
+#ifdef ISR_PROFILER
+void isrProfiler_init();
+#else
+static inline void isrProfiler_init() {}
+#endif
+
+// Clears the profile.
+void isrProfiler_reset();
+
+// Adds one call that took count counter counts. The cost of the counter reads
+// themselves, measured by isrProfiler_init(), is subtracted.
+void isrProfiler_record(isrProfiler_function_t function, uint32_t count);
+
+// Fills in the statistics of one function. Read them with the ISR stopped, or
+// a call may be half recorded.
+void isrProfiler_getStatistics(isrProfiler_function_t function,
+                               isrProfiler_statistics_t *statistics);
+
+// Returns the name of the tick call, e.g. "sound_tick".
+const char *isrProfiler_getName(isrProfiler_function_t function);
+
+// Prints a table of the statistics of every function to the console.
+void isrProfiler_print();
+
+// Draws the same table on the TFT.
+void isrProfiler_display();
+
+#endif /* ISRPROFILER_H_ */
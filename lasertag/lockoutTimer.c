@@ -3,22 +3,14 @@
 #include <stdio.h>
 #include "intervalTimer.h"
 #include "lockoutTimer.h"
+#include "timerService.h"
 
 //setting defines for lockout timer
 #define LOCKOUT_TIME .5
+#define ONE_SHOT 0
 
-// State of lockout timer
-typedef enum {
-  INIT,    // Setting timer to the initial state waiting to get initial hit
-  LOCKEDOUT, // Hit detected and lock out commences for .5 seconds
-  UNLOCKED // Lock out time is completed and waiting for new hit
-} lockoutTimer_state_t;
-
-//Timer State
-volatile static lockoutTimer_state_t timerState;
-
-// Creating the timer counter
-
+//the lockout is a one-shot timer with nothing to do when it expires
+static timerService_timer_t lockoutTimer;
 
 // The lockoutTimer is active for 1/2 second once it is started.
 // It is used to lock-out the detector once a hit has been detected.
@@ -27,65 +19,21 @@ volatile static lockoutTimer_state_t timerState;
 
 // Perform any necessary inits for the lockout timer.
 void lockoutTimer_init() {
-    timerState = INIT;
-}
-
-// Standard tick function.
-void lockoutTimer_tick() {
-    static uint16_t timer = 0;
-    switch(timerState) //State update
-    {
-        case UNLOCKED:   // Setting timer to the initial state waiting to get initial hit
-           break;
-
-        case LOCKEDOUT:  // Hit detected and lock out commences for .5 seconds
-
-            //If timer hits expire value, go to init state
-            if (timer == LOCKOUT_TIMER_EXPIRE_VALUE) {
-                timerState = INIT;
-            }
-            break;
-
-        case INIT:  // Lock out time is completed and waiting for new hit
-            timerState = UNLOCKED;
-            break;
-
-        default:    //default case essentially an error state
-            printf("No state\n");
-    }   
-
-
-    switch(timerState) //State action
-    {
-        case UNLOCKED:   // Setting timer to the initial state waiting to get initial hit
-            timer = 0;
-            break;
-
-        case LOCKEDOUT:  // Hit detected and lock out commences for .5 seconds
-            timer++;
-            break;
-
-        case INIT:    // Lock out time is completed and waiting for new hit
-            break;
-
-        default:    //default case
-            printf("No state");
-    }
+    timerService_register(&lockoutTimer, NULL);
 }
 
 // Calling this starts the timer.
 void lockoutTimer_start() {
-    timerState = LOCKEDOUT;
+    timerService_start(&lockoutTimer, LOCKOUT_TIMER_EXPIRE_VALUE, ONE_SHOT);
 }
 
 // Returns true if the timer is running.
 bool lockoutTimer_running() {
-    //printf("Checking Timerstate\n");
-    return (timerState == LOCKEDOUT);
+    return timerService_running(&lockoutTimer);
 }
 
 // Test function assumes interrupts have been completely enabled and
-// lockoutTimer_tick() function is invoked by isr_function().
+// timerService_tick() function is invoked by isr_function().
 // Prints out pass/fail status and other info to console.
 // Returns true if passes, false otherwise.
 // This test uses the interval timer to determine correct delay for
@@ -18,12 +18,10 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 
 #define LOCKOUT_TIMER_EXPIRE_VALUE 50000 // Defined in terms of 100 kHz ticks.
 
-// Perform any necessary inits for the lockout timer.
+// Perform any necessary inits for the lockout timer. Registers the timer with
+// the timer service (see timerService.h), which runs it from the ISR.
 void lockoutTimer_init();
 
-// Standard tick function.
-void lockoutTimer_tick();
-
 // Calling this starts the timer.
 void lockoutTimer_start();
 
@@ -31,7 +29,7 @@ void lockoutTimer_start();
 bool lockoutTimer_running();
 
 // Test function assumes interrupts have been completely enabled and
-// lockoutTimer_tick() function is invoked by isr_function().
+// timerService_tick() function is invoked by isr_function().
 // Prints out pass/fail status and other info to console.
 // Returns true if passes, false otherwise.
 // This test uses the interval timer to determine correct delay for
@@ -0,0 +1,76 @@
+#include "powerSelect.h"
+
+//Compare-exchange of values[a] and values[b]: the smaller ends up in a and the
+//larger in b. MIN_ONLY and MAX_ONLY are the halves for when the other output
+//is never read again
+#define SORT_PAIR(a, b) { \
+    double lo = values[a] < values[b] ? values[a] : values[b]; \
+    double hi = values[a] < values[b] ? values[b] : values[a]; \
+    values[a] = lo; \
+    values[b] = hi; \
+}
+#define MIN_ONLY(a, b) values[a] = values[a] < values[b] ? values[a] : values[b]
+#define MAX_ONLY(a, b) values[b] = values[a] < values[b] ? values[b] : values[a]
+
+// Returns the index of the largest of count values. If several values tie for
+// the largest, returns the highest of their indices.
+uint16_t powerSelect_maxIndex(const double values[], uint16_t count) {
+    uint16_t maxIndex = 0;
+    double maxValue = values[0];
+    for (uint16_t i = 1; i < count; i++){
+        //>= so that the last of equal values wins, like the stable sort did
+        maxIndex = values[i] >= maxValue ? i : maxIndex;
+        maxValue = values[i] >= maxValue ? values[i] : maxValue;
+    }
+    return maxIndex;
+}
+
+//Hoare's selection: partitions around the middle element until the k-th
+//smallest is in place
+static double quickSelect(double values[], uint16_t count, uint16_t k) {
+    int32_t left = 0;
+    int32_t right = count - 1;
+    while (left < right) {
+        double pivot = values[(left + right) / 2];
+        int32_t i = left;
+        int32_t j = right;
+        while (i <= j) {
+            while (values[i] < pivot)
+                i++;
+            while (values[j] > pivot)
+                j--;
+            if (i <= j) {
+                double swap = values[i];
+                values[i++] = values[j];
+                values[j--] = swap;
+            }
+        }
+        //Everything in [left, j] is <= pivot and everything in [i, right] >= it
+        if (k <= j)
+            right = j;
+        else if (k >= i)
+            left = i;
+        else
+            break;
+    }
+    return values[k];
+}
+
+// Returns the lower median of count values, reordering values[] in place.
+double powerSelect_median(double values[], uint16_t count) {
+    if (count != POWER_SELECT_NETWORK_COUNT)
+        return quickSelect(values, count, (count - 1) / 2);
+    //Knuth's 29 compare-exchange sorting network for ten elements. The
+    //compare-exchanges whose smaller or larger output never reaches
+    //values[4] are cut down to a single min or max, 49 operations in all
+    SORT_PAIR(4, 9); SORT_PAIR(3, 8); SORT_PAIR(2, 7); SORT_PAIR(1, 6); SORT_PAIR(0, 5);
+    SORT_PAIR(1, 4); SORT_PAIR(6, 9); SORT_PAIR(0, 3); SORT_PAIR(5, 8);
+    SORT_PAIR(0, 2); SORT_PAIR(3, 6); SORT_PAIR(7, 9);
+    MAX_ONLY(0, 1); SORT_PAIR(2, 4); SORT_PAIR(5, 7); MIN_ONLY(8, 9);
+    SORT_PAIR(1, 2); SORT_PAIR(4, 6); SORT_PAIR(7, 8); SORT_PAIR(3, 5);
+    SORT_PAIR(2, 5); MIN_ONLY(6, 8); MAX_ONLY(1, 3); SORT_PAIR(4, 7);
+    MAX_ONLY(2, 3); MIN_ONLY(6, 7);
+    MAX_ONLY(3, 4); MIN_ONLY(5, 6);
+    MIN_ONLY(4, 5);
+    return values[(POWER_SELECT_NETWORK_COUNT - 1) / 2];
+}
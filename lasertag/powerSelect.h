@@ -0,0 +1,34 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef POWERSELECT_H_
+#define POWERSELECT_H_
+
+#include <stdint.h>
+
+// Selection kernels for the hit detector, which only needs the largest of the
+// power values and the median, not a full sort. For the default ten player
+// frequencies both are branch-free: the compares turn into min/max and
+// conditional-move instructions, so their cost does not depend on the data.
+
+#define POWER_SELECT_NETWORK_COUNT 10 // The count with a selection network.
+
+// Returns the index of the largest of count values. If several values tie for
+// the largest, returns the highest of their indices, the one that a stable
+// ascending sort puts last.
+uint16_t powerSelect_maxIndex(const double values[], uint16_t count);
+
+// Returns the lower median of count values, the one at index (count - 1) / 2
+// once sorted (the 5th smallest of ten). Works in place and leaves the median
+// at that index, with the other elements reordered but not sorted. Ten values
+// go through a sorting network pruned to the compare-exchanges that the median
+// depends on; other counts use quickselect.
+double powerSelect_median(double values[], uint16_t count);
+
+#endif /* POWERSELECT_H_ */
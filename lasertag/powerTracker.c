@@ -0,0 +1,38 @@
+#include <string.h>
+#include "powerTracker.h"
+
+// Sets up tracker over storage[] (length values) for a window of zeros.
+void powerTracker_init(powerTracker_t *tracker, float storage[],
+                       uint32_t length) {
+    tracker->squares = storage;
+    tracker->length = length;
+    tracker->shortWindowCount = 0;
+    powerTracker_clear(tracker);
+}
+
+// Sets all of the values in the window to zero.
+void powerTracker_clear(powerTracker_t *tracker) {
+    memset(tracker->squares, 0, tracker->length * sizeof(tracker->squares[0]));
+    tracker->index = 0;
+    tracker->sum = 0;
+    memset(tracker->shortWindowSums, 0, sizeof(tracker->shortWindowSums));
+}
+
+// Also tracks the power of the newest lengths[i] values.
+void powerTracker_setShortWindows(powerTracker_t *tracker,
+                                  const uint32_t lengths[], uint32_t count) {
+    if (count > POWER_TRACKER_MAX_SHORT_WINDOWS)
+        count = POWER_TRACKER_MAX_SHORT_WINDOWS;
+    tracker->shortWindowCount = count;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length = lengths[i] < tracker->length ? lengths[i] : tracker->length;
+        tracker->shortWindowLengths[i] = length;
+        //sum the newest length squares, which end just before the oldest
+        tracker->shortWindowSums[i] = 0;
+        uint32_t index = tracker->index;
+        for (uint32_t j = 0; j < length; j++) {
+            index = index == 0 ? tracker->length - 1 : index - 1;
+            tracker->shortWindowSums[i] += powerTracker_toFixed(tracker->squares[index]);
+        }
+    }
+}
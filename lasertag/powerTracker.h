@@ -0,0 +1,96 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef POWERTRACKER_H_
+#define POWERTRACKER_H_
+
+#include <stdint.h>
+
+// Tracks the power (sum of squares) of the last length values of a signal.
+// Each square is rounded once to single precision and kept in a ring, which
+// takes 4 bytes per value, half of a window of doubles. The running sum is a
+// 64-bit integer with POWER_TRACKER_FRACTION_BITS fraction bits: a float
+// square always converts to the same integer, so adding the newest square and
+// subtracting the one that leaves the window cancel exactly. The sum never
+// drifts, however long it runs, and never needs to be recomputed. The storage
+// is provided by the caller. The tracker can also keep the power of a few
+// shorter windows over the newest values in the same ring, with the same
+// exact sums (see powerTracker_setShortWindows()).
+
+// Squares of at least 2^-20 convert exactly; smaller ones are rounded to a
+// multiple of 2^-44 (about 6e-14). Squares are limited to
+// POWER_TRACKER_MAX_SQUARE (values up to 16 in magnitude) so that a window of
+// up to 2048 of them fits in the sum.
+#define POWER_TRACKER_FRACTION_BITS 44
+#define POWER_TRACKER_SCALE ((double)(1ULL << POWER_TRACKER_FRACTION_BITS))
+#define POWER_TRACKER_MAX_SQUARE 256.0f
+#define POWER_TRACKER_MAX_SHORT_WINDOWS 4
+
+typedef struct {
+  float *squares; // length values.
+  uint32_t length;
+  uint32_t index; // The oldest square, which the next value replaces.
+  int64_t sum;    // Sum of squares[] in fixed point.
+  uint32_t shortWindowCount;
+  uint32_t shortWindowLengths[POWER_TRACKER_MAX_SHORT_WINDOWS];
+  int64_t shortWindowSums[POWER_TRACKER_MAX_SHORT_WINDOWS];
+} powerTracker_t;
+
+// Sets up tracker over storage[] (length values) for a window of zeros.
+void powerTracker_init(powerTracker_t *tracker, float storage[],
+                       uint32_t length);
+
+// Sets all of the values in the window to zero.
+void powerTracker_clear(powerTracker_t *tracker);
+
+// Also tracks the power of the newest lengths[i] values, for count (at most
+// POWER_TRACKER_MAX_SHORT_WINDOWS) windows shorter than the tracker's window.
+// The sums start from the values already in the window. A count of zero
+// removes the short windows.
+void powerTracker_setShortWindows(powerTracker_t *tracker,
+                                  const uint32_t lengths[], uint32_t count);
+
+// Converts a stored square to the fixed point of the sum.
+static inline int64_t powerTracker_toFixed(float square) {
+  return (int64_t)((double)square * POWER_TRACKER_SCALE + 0.5);
+}
+
+// Slides the window by one value.
+static inline void powerTracker_add(powerTracker_t *tracker, double value) {
+  float square = value * value;
+  if (!(square <= POWER_TRACKER_MAX_SQUARE))
+    square = POWER_TRACKER_MAX_SQUARE;
+  int64_t newest = powerTracker_toFixed(square);
+  for (uint32_t i = 0; i < tracker->shortWindowCount; i++) {
+    // The square that leaves a window of length L was added L values ago.
+    uint32_t length = tracker->shortWindowLengths[i];
+    uint32_t leaving = tracker->index >= length
+                           ? tracker->index - length
+                           : tracker->index + tracker->length - length;
+    tracker->shortWindowSums[i] +=
+        newest - powerTracker_toFixed(tracker->squares[leaving]);
+  }
+  tracker->sum += newest - powerTracker_toFixed(tracker->squares[tracker->index]);
+  tracker->squares[tracker->index] = square;
+  if (++tracker->index == tracker->length)
+    tracker->index = 0;
+}
+
+// Returns the sum of the squares of the values in the window.
+static inline double powerTracker_getPower(const powerTracker_t *tracker) {
+  return tracker->sum / POWER_TRACKER_SCALE;
+}
+
+// Returns the sum of the squares of the values in short window [window].
+static inline double powerTracker_getShortWindowPower(const powerTracker_t *tracker,
+                                                      uint32_t window) {
+  return tracker->shortWindowSums[window] / POWER_TRACKER_SCALE;
+}
+
+#endif /* POWERTRACKER_H_ */
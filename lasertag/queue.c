@@ -25,8 +25,14 @@
 // values (e.g. zeros), call queue_overwritePush() up to queue_size() times.
 void queue_init(queue_t *q, queue_size_t size, const char *name){
     
+    //Round the array up to a power of two so that indexes wrap with a mask
+    queue_size_t capacity = 1;
+    while(capacity < size){
+        capacity <<= 1;
+    }
+
     //Malloc for data*
-    if(!(q->data = (queue_data_t*)malloc(size*sizeof(queue_data_t)))){
+    if(!(q->data = (queue_data_t*)malloc(capacity*sizeof(queue_data_t)))){
         printf("%s\n",MALLOC_ERR);
         assert(FALSE);
     }
@@ -38,6 +44,7 @@ void queue_init(queue_t *q, queue_size_t size, const char *name){
     //adding last variables
     q->elementCount = EMPTY;
     q->size = size;
+    q->mask = capacity - 1;
 
     //under and over flow flags
     q->underflowFlag = FALSE;
@@ -46,6 +53,16 @@ void queue_init(queue_t *q, queue_size_t size, const char *name){
 }
 
 
+// Empties the queue and clears the flags, keeping its storage.
+void queue_clear(queue_t *q){
+    q->indexIn = 0;
+    q->indexOut = 0;
+    q->elementCount = EMPTY;
+    q->underflowFlag = FALSE;
+    q->overflowFlag = FALSE;
+}
+
+
 // Get the user-assigned name for the queue.
 const char *queue_name(queue_t *q){
     return q->name;
@@ -82,7 +99,7 @@ void queue_push(queue_t *q, queue_data_t value){
     //changing things that are done only when the queue is not full
     q->data[q->indexIn] = value;
     q->elementCount++;
-    q->indexIn = (q->indexIn+1) % q->size;
+    q->indexIn = (q->indexIn+1) & q->mask;
 
     //make sure the flag is cleared
     q->underflowFlag = FALSE;
@@ -102,7 +119,7 @@ queue_data_t queue_pop(queue_t *q){
     //changing things that are done only when the queue is empty
     queue_data_t temp_data = q->data[q->indexOut];
     q->elementCount--;
-    q->indexOut = (q->indexOut+1) % q->size;
+    q->indexOut = (q->indexOut+1) & q->mask;
     q->overflowFlag = FALSE;
 
     //return queue_data_t type
@@ -130,7 +147,7 @@ queue_data_t queue_readElementAt(queue_t *q, queue_index_t index){
     }
 
     //return queue_data_t type
-    return q->data[(q->indexOut+index) % q->size];
+    return q->data[(q->indexOut+index) & q->mask];
 }
 
 // Returns a count of the elements currently contained in the queue.
@@ -150,7 +167,22 @@ bool queue_overflow(queue_t *q){
     return q->overflowFlag;
 }
 
+// Describes the queue contents as up to two contiguous spans, oldest first.
+uint32_t queue_getSpans(const queue_t *q, queue_span_t spans[2]){
+    //The first span runs from the oldest element to the end of the array
+    queue_size_t firstCount = q->mask + 1 - q->indexOut;
+    if(firstCount > q->elementCount){
+        firstCount = q->elementCount;
+    }
+    spans[0].data = &q->data[q->indexOut];
+    spans[0].count = firstCount;
+    spans[1].data = q->data;
+    spans[1].count = q->elementCount - firstCount;
+    return (spans[0].count > 0) + (spans[1].count > 0);
+}
+
 // Frees the storage that you malloc'd before.
 void queue_garbageCollect(queue_t *q){
     free(q->data);
+    q->data = NULL;
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "sample.h"
 
 // Limit the size of the statically-allocated queue name.
 #define QUEUE_MAX_NAME_SIZE 50
@@ -23,8 +24,8 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 // Big enough to address everything in the queue.
 typedef uint32_t queue_index_t;
 
-// Just make everything double for this project.
-typedef double queue_data_t;
+// Double for this project, or float in the single-precision build (sample.h).
+typedef sample_t queue_data_t;
 
 // Not sure we need something different from the index type.
 typedef uint32_t queue_size_t;
@@ -40,9 +41,11 @@ typedef struct {
   queue_index_t indexOut;
   // Keep track of the number of elements currently in queue.
   queue_size_t elementCount;
-  // This is the size of the data array. Actual queue
-  // capacity is one less.
+  // This is the capacity of the queue.
   queue_size_t size;
+  // The data array holds the next power of two >= size elements, so that
+  // indexes wrap with "& mask" instead of "% size".
+  queue_index_t mask;
   // Points to a dynamically-allocated array.
   queue_data_t *data;
   // True if queue_pop() is called on an empty queue. Reset
@@ -62,6 +65,10 @@ typedef struct {
 // values (e.g. zeros), call queue_overwritePush() up to queue_size() times.
 void queue_init(queue_t *q, queue_size_t size, const char *name);
 
+// Empties the queue and clears the flags, keeping the storage that
+// queue_init() allocated. Use this, not queue_init(), to start a queue over.
+void queue_clear(queue_t *q);
+
 // Get the user-assigned name for the queue.
 const char *queue_name(queue_t *q);
 
@@ -105,7 +112,43 @@ bool queue_underflow(queue_t *q);
 // queue).
 bool queue_overflow(queue_t *q);
 
-// Frees the storage that you malloc'd before.
+// Frees the storage that you malloc'd before. q->data is left NULL, so the
+// queue can be set up again with queue_init().
 void queue_garbageCollect(queue_t *q);
 
+/******************************************************************************
+***** Unchecked, inlined access for inner loops (filter.c). These do no error
+***** checking and print nothing; the caller guarantees the preconditions. The
+***** functions above remain the checked API that the tests use.
+******************************************************************************/
+
+// A contiguous run of queue elements, oldest first.
+typedef struct {
+  const queue_data_t *data;
+  queue_size_t count;
+} queue_span_t;
+
+// Same as queue_overwritePush() without the checks or function calls.
+static inline void queue_overwritePushUnchecked(queue_t *q, queue_data_t value) {
+  bool full = q->elementCount == q->size;
+  q->data[q->indexIn] = value;
+  q->indexIn = (q->indexIn + 1) & q->mask;
+  q->indexOut = (q->indexOut + full) & q->mask;
+  q->elementCount += !full;
+  q->underflowFlag = false;
+}
+
+// Same as queue_readElementAt() for 0 <= index < queue_elementCount(q).
+static inline queue_data_t queue_readElementAtUnchecked(const queue_t *q,
+                                                         queue_index_t index) {
+  return q->data[(q->indexOut + index) & q->mask];
+}
+
+// Describes the queue contents as up to two contiguous spans so that loops can
+// run straight over memory: spans[0] holds the oldest elements and spans[1]
+// (empty unless the contents wrap around the end of the array) the rest.
+// Returns the number of non-empty spans. The spans are valid until the next
+// push or pop.
+uint32_t queue_getSpans(const queue_t *q, queue_span_t spans[2]);
+
 #endif /* QUEUE_H_ */
\ No newline at end of file
@@ -0,0 +1,26 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+// The type of the samples that flow through the filters: the queues, the delay
+// lines and the biquad state and coefficients. Build with
+// -DFILTER_SINGLE_PRECISION=ON to make them float, which the Cortex-A9 NEON
+// unit can vectorize (it has no double-precision lanes) and which halves their
+// memory. Values that need the extra precision stay double in either build:
+// the power accumulators and the sliding DFT. The direct-form IIR filters need
+// double samples too (see biquad.h), so the float build runs them as biquads.
+#ifdef FILTER_SINGLE_PRECISION
+typedef float sample_t;
+#else
+typedef double sample_t;
+#endif
+
+#endif /* SAMPLE_H_ */
@@ -0,0 +1,35 @@
+#include <math.h>
+#include "slidingDft.h"
+
+#define PI 3.14159265358979323846
+
+// Sets up a bin at cyclesPerSample for a window of windowLength samples.
+void slidingDft_initBin(slidingDft_bin_t *bin, double cyclesPerSample,
+                        uint32_t windowLength) {
+    double w = 2.0 * PI * cyclesPerSample;
+    bin->rotationReal = cos(w);
+    bin->rotationImag = -sin(w);
+    bin->wrapReal = cos(w * windowLength);
+    bin->wrapImag = -sin(w * windowLength);
+    bin->real = 0.0;
+    bin->imag = 0.0;
+}
+
+// Recomputes the bin from the window with Horner's rule, oldest sample first,
+// which is the same recursion without the samples leaving the window.
+void slidingDft_recompute(slidingDft_bin_t *bin, const double history[],
+                          uint32_t windowLength, uint32_t oldestIndex) {
+    double real = 0.0;
+    double imag = 0.0;
+    uint32_t index = oldestIndex;
+    for (uint32_t i = 0; i < windowLength; i++) {
+        double rotatedReal = bin->rotationReal * real - bin->rotationImag * imag;
+        double rotatedImag = bin->rotationReal * imag + bin->rotationImag * real;
+        real = rotatedReal + history[index];
+        imag = rotatedImag;
+        if (++index == windowLength)
+            index = 0;
+    }
+    bin->real = real;
+    bin->imag = imag;
+}
@@ -0,0 +1,61 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef SLIDINGDFT_H_
+#define SLIDINGDFT_H_
+
+#include <stdint.h>
+
+// A single DFT bin over a sliding window of the last windowLength samples,
+// S = x[n] + e^-jw*x[n-1] + ... + e^-jw(N-1)*x[n-N+1], updated with one complex
+// rotation per sample:
+// S = x[n] + e^-jw*S' - e^-jwN*x[n-N].
+// The bin frequency does not have to be a multiple of 1/windowLength, so it can
+// sit exactly on a player frequency. The recursion is marginally stable; in
+// double precision the drift is far below the detector's resolution, and
+// slidingDft_recompute() resets it whenever power is computed from scratch.
+
+typedef struct {
+  double rotationReal; // e^-jw
+  double rotationImag;
+  double wrapReal;     // e^-jwN
+  double wrapImag;
+  double real;         // S
+  double imag;
+} slidingDft_bin_t;
+
+// Sets up a bin at cyclesPerSample (frequency / sample rate) for a window of
+// windowLength samples and clears it.
+void slidingDft_initBin(slidingDft_bin_t *bin, double cyclesPerSample,
+                        uint32_t windowLength);
+
+// Slides the window by one sample: newest enters, oldest (the sample from
+// windowLength samples ago) leaves.
+static inline void slidingDft_update(slidingDft_bin_t *bin, double newest,
+                                     double oldest) {
+  double real = bin->rotationReal * bin->real - bin->rotationImag * bin->imag;
+  double imag = bin->rotationReal * bin->imag + bin->rotationImag * bin->real;
+  bin->real = real + newest - bin->wrapReal * oldest;
+  bin->imag = imag - bin->wrapImag * oldest;
+}
+
+// Recomputes the bin from the window. history[] is a ring of windowLength
+// samples whose oldest sample is at history[oldestIndex].
+void slidingDft_recompute(slidingDft_bin_t *bin, const double history[],
+                          uint32_t windowLength, uint32_t oldestIndex);
+
+// Returns 2 * |S|^2 / windowLength, which for a sinusoid at the bin frequency
+// equals the sum of its squares over the window: the same scale as the power
+// of a unity-gain bandpass filter's output.
+static inline double slidingDft_getPower(const slidingDft_bin_t *bin,
+                                         uint32_t windowLength) {
+  return 2.0 * (bin->real * bin->real + bin->imag * bin->imag) / windowLength;
+}
+
+#endif /* SLIDINGDFT_H_ */
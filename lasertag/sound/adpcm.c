@@ -0,0 +1,73 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include "adpcm.h"
+
+#define SIGN_BIT 0x8
+#define MAGNITUDE_MASK 0x7
+#define NIBBLE_MASK 0xF
+#define NIBBLE_BITS 4
+#define MAX_STEP_INDEX 88
+
+// The IMA tables, the same as in encodeAdpcm.py.
+static const int16_t stepTable[MAX_STEP_INDEX + 1] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,
+    19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+    337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+    876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+    5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t indexTable[MAGNITUDE_MASK + 1] = {-1, -1, -1, -1,
+                                                       2,  4,  6,  8};
+
+// Gets the decoder ready for the start of a sound.
+void adpcm_initDecoder(adpcm_decoder_t *decoder) {
+  decoder->prediction = 0;
+  decoder->stepIndex = 0;
+}
+
+// Decodes count samples from sample position on.
+void adpcm_decode(adpcm_decoder_t *decoder, const uint8_t data[],
+                  uint32_t position, int16_t out[], uint32_t count) {
+  // Kept in locals so that they stay in registers for the loop.
+  int32_t prediction = decoder->prediction;
+  int16_t stepIndex = decoder->stepIndex;
+  for (uint32_t k = 0; k < count; k++, position++) {
+    uint8_t code = (data[position / ADPCM_SAMPLES_PER_BYTE] >>
+                    (NIBBLE_BITS * (position % ADPCM_SAMPLES_PER_BYTE))) &
+                   NIBBLE_MASK;
+    int32_t step = stepTable[stepIndex];
+    // step * (magnitude + 1/2) / 4, rounded down the way every IMA decoder
+    // does it.
+    int32_t difference = step >> 3;
+    if (code & 4)
+      difference += step;
+    if (code & 2)
+      difference += step >> 1;
+    if (code & 1)
+      difference += step >> 2;
+    prediction += (code & SIGN_BIT) ? -difference : difference;
+    if (prediction > INT16_MAX)
+      prediction = INT16_MAX;
+    else if (prediction < INT16_MIN)
+      prediction = INT16_MIN;
+    stepIndex += indexTable[code & MAGNITUDE_MASK];
+    if (stepIndex < 0)
+      stepIndex = 0;
+    else if (stepIndex > MAX_STEP_INDEX)
+      stepIndex = MAX_STEP_INDEX;
+    out[k] = prediction;
+  }
+  decoder->prediction = prediction;
+  decoder->stepIndex = stepIndex;
+}
@@ -0,0 +1,38 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef ADPCM_H_
+#define ADPCM_H_
+
+#include <stdint.h>
+
+// Decodes the 4-bit IMA-ADPCM sounds that encodeAdpcm.py writes at build time
+// from the wav2c arrays. Each 16-bit sample is stored as a 4-bit step from a
+// prediction, so a sound takes a quarter of the memory of its wav2c array.
+// The sound is one stream with no block headers: the decoder starts from a
+// prediction of 0 with the smallest step, two samples per byte, the first in
+// the low nibble. A sound can only be decoded in order, from the start, which
+// is how the mixer plays it. An all-zero stream decodes to silence.
+
+#define ADPCM_SAMPLES_PER_BYTE 2
+
+typedef struct {
+  int32_t prediction; // The last sample decoded.
+  int16_t stepIndex;  // Into the IMA step table.
+} adpcm_decoder_t;
+
+// Gets the decoder ready for the start of a sound.
+void adpcm_initDecoder(adpcm_decoder_t *decoder);
+
+// Decodes the count samples of data starting at sample position into out[].
+// position must be the sample after the last one decoded.
+void adpcm_decode(adpcm_decoder_t *decoder, const uint8_t data[],
+                  uint32_t position, int16_t out[], uint32_t count);
+
+#endif /* ADPCM_H_ */
@@ -0,0 +1,165 @@
+#!/usr/bin/python3
+
+"""
+Encodes a wav2c sound array as 4-bit IMA-ADPCM at build time.
+
+The wav2c .wav.c files hold each sound as 16-bit offset-binary samples. The
+sound code plays the ADPCM version instead, which takes a quarter of the
+memory and is decoded as it is played (see adpcm.h). The encoded stream has
+no header: it starts from a prediction of 0 with the smallest step and packs
+two samples per byte, the first in the low nibble.
+
+For name.wav.c, writes name.adpcm.c with
+
+    const uint8_t name_adpcm[];
+
+and name.adpcm.h with its extern declaration and
+NAME_ADPCM_NUMBER_OF_SAMPLES, like the wav2c header.
+
+Usage: encodeAdpcm.py name.wav.c outputDirectory
+"""
+
+import argparse
+import math
+import pathlib
+import re
+import sys
+
+OFFSET_BINARY_ZERO = 0x8000
+INT16_MIN = -32768
+INT16_MAX = 32767
+BYTES_PER_LINE = 16
+
+# The IMA tables, the same as in adpcm.c.
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190,
+    209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499,
+    2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+    8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767]
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_samples(path):
+    """ Returns the samples of a wav2c array as signed 16-bit values """
+    text = pathlib.Path(path).read_text()
+    # The wav2c files number the samples in comments on every line.
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.DOTALL)
+    match = re.search(r"\{([^}]*)\}", text)
+    if not match:
+        sys.exit("encodeAdpcm.py: no array in " + str(path))
+    return [int(value) - OFFSET_BINARY_ZERO
+            for value in re.findall(r"\d+", match.group(1))]
+
+
+def decode(code, prediction, step_index):
+    """ One step of the decoder in adpcm.c """
+    step = STEP_TABLE[step_index]
+    difference = step >> 3
+    if code & 4:
+        difference += step
+    if code & 2:
+        difference += step >> 1
+    if code & 1:
+        difference += step >> 2
+    prediction += -difference if code & 8 else difference
+    prediction = min(max(prediction, INT16_MIN), INT16_MAX)
+    step_index = min(max(step_index + INDEX_TABLE[code & 7], 0),
+                     len(STEP_TABLE) - 1)
+    return prediction, step_index
+
+
+def encode(samples):
+    """
+    Returns the 4-bit codes of the samples. The encoder runs the decoder
+    along, so that each code is chosen from the prediction that the decoder
+    will have.
+    """
+    prediction = 0
+    step_index = 0
+    codes = []
+    for sample in samples:
+        step = STEP_TABLE[step_index]
+        difference = sample - prediction
+        code = 0
+        if difference < 0:
+            code = 8
+            difference = -difference
+        for bit in (4, 2, 1):
+            if difference >= step:
+                code |= bit
+                difference -= step
+            step >>= 1
+        codes.append(code)
+        prediction, step_index = decode(code, prediction, step_index)
+    return codes
+
+
+def signal_to_noise_ratio(samples, codes):
+    """ Returns the SNR of the decoded sound in dB """
+    prediction = 0
+    step_index = 0
+    signal = 0
+    noise = 0
+    for sample, code in zip(samples, codes):
+        prediction, step_index = decode(code, prediction, step_index)
+        signal += sample * sample
+        noise += (sample - prediction) ** 2
+    if noise == 0:
+        return math.inf
+    return 10 * math.log10(signal / noise) if signal > 0 else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("wav")
+    parser.add_argument("output_directory")
+    arguments = parser.parse_args()
+
+    wav_path = pathlib.Path(arguments.wav)
+    name = wav_path.name.split(".")[0]
+    samples = read_samples(wav_path)
+    codes = encode(samples)
+    if len(codes) % 2:
+        codes.append(0)
+    data = [codes[i] | codes[i + 1] << 4 for i in range(0, len(codes), 2)]
+
+    output = pathlib.Path(arguments.output_directory)
+    output.mkdir(parents=True, exist_ok=True)
+    lines = ["// Generated by encodeAdpcm.py from " + wav_path.name +
+             ", do not edit.",
+             "",
+             "#include \"" + name + ".adpcm.h\"",
+             "",
+             "const uint8_t " + name + "_adpcm[" + str(len(data)) + "] = {"]
+    for i in range(0, len(data), BYTES_PER_LINE):
+        lines.append(", ".join("0x%02x" % byte
+                               for byte in data[i:i + BYTES_PER_LINE]) + ",")
+    lines.append("};")
+    (output / (name + ".adpcm.c")).write_text("\n".join(lines) + "\n")
+
+    guard = name.upper() + "_ADPCM_H_"
+    (output / (name + ".adpcm.h")).write_text("\n".join([
+        "// Generated by encodeAdpcm.py from " + wav_path.name +
+        ", do not edit.",
+        "",
+        "#ifndef " + guard,
+        "#define " + guard,
+        "",
+        "#include <stdint.h>",
+        "",
+        "extern const uint8_t " + name + "_adpcm[];",
+        "#define " + name.upper() + "_ADPCM_NUMBER_OF_SAMPLES " +
+        str(len(samples)),
+        "",
+        "#endif /* " + guard + " */",
+        ""]))
+    print("%s: %d samples, %d bytes, SNR %.1f dB" %
+          (name, len(samples), len(data),
+           signal_to_noise_ratio(samples, codes[:len(samples)])))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,225 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "mixer.h"
+
+#define NO_VOICE -1
+#define BLOCK_SIZE 64 // Output samples mixed per pass over the voices.
+#define OFFSET_BINARY_ZERO 0x8000
+#define Q15_SHIFT 15
+
+typedef struct {
+  mixer_sound_t *sound;    // NULL if the voice is free.
+  uint32_t position;       // Index of the next sample of the sound.
+  adpcm_decoder_t decoder; // For IMA-ADPCM sounds.
+} voice_t;
+
+// The registered sounds, scanned only when a request is pending.
+static mixer_sound_t *sounds[MIXER_MAX_SOUND_COUNT];
+static uint16_t soundCount;
+static volatile bool requestPending;
+
+// Only touched by mixer_render().
+static voice_t voices[MIXER_VOICE_COUNT];
+
+// Takes the sound off its voice. mixer_isPlaying() still counts a restart
+// that has been requested since.
+static void freeVoice(voice_t *voice) {
+  mixer_sound_t *sound = voice->sound;
+  sound->voice = NO_VOICE;
+  sound->playing = false;
+  voice->sound = NULL;
+}
+
+// Returns a free voice, or the one to steal for a sound of the given
+// priority, or NO_VOICE if every voice plays a sound of higher priority.
+static int8_t findVoice(uint8_t priority) {
+  int8_t victim = NO_VOICE;
+  for (int8_t v = 0; v < MIXER_VOICE_COUNT; v++) {
+    if (voices[v].sound == NULL)
+      return v;
+    if (voices[v].sound->priority > priority)
+      continue;
+    // The lowest priority, then the one that has played longest.
+    if (victim == NO_VOICE ||
+        voices[v].sound->priority < voices[victim].sound->priority ||
+        (voices[v].sound->priority == voices[victim].sound->priority &&
+         voices[v].position > voices[victim].position))
+      victim = v;
+  }
+  return victim;
+}
+
+// Applies the plays and stops posted since the last render. Only the ISR
+// writes playing, and it does so before clearing the request, so that
+// mixer_isPlaying() never sees the sound between the two states.
+static void applyRequests() {
+  requestPending = false;
+  for (uint16_t i = 0; i < soundCount; i++) {
+    mixer_sound_t *sound = sounds[i];
+    if (sound->stopRequested) {
+      if (sound->voice != NO_VOICE)
+        freeVoice(&voices[sound->voice]);
+      sound->stopRequested = false;
+    }
+    if (sound->playRequested) {
+      int8_t v = sound->voice != NO_VOICE ? sound->voice
+                                          : findVoice(sound->priority);
+      if (v == NO_VOICE) {
+        // Every voice is busy with something louder; the sound is not on a
+        // voice, so playing is already false.
+        sound->playRequested = false;
+        continue;
+      }
+      if (voices[v].sound != NULL && voices[v].sound != sound)
+        freeVoice(&voices[v]);
+      voices[v].sound = sound;
+      voices[v].position = 0;
+      adpcm_initDecoder(&voices[v].decoder);
+      sound->voice = v;
+      sound->playing = true;
+      sound->playRequested = false;
+    }
+  }
+}
+
+// Stops every voice and forgets every sound.
+void mixer_init() {
+  for (uint16_t v = 0; v < MIXER_VOICE_COUNT; v++)
+    voices[v].sound = NULL;
+  soundCount = 0;
+  requestPending = false;
+}
+
+// Adds a sound to the mixer, stopped.
+static void addSound(mixer_sound_t *sound, const uint16_t samples[],
+                     const uint8_t adpcm[], uint32_t sampleCount,
+                     uint8_t priority) {
+  if (soundCount == MIXER_MAX_SOUND_COUNT) {
+    printf("mixer_register(): more than %d sounds\n", MIXER_MAX_SOUND_COUNT);
+    assert(false);
+    return;
+  }
+  sound->samples = samples;
+  sound->adpcm = adpcm;
+  sound->sampleCount = sampleCount;
+  sound->priority = priority;
+  sound->volume = MIXER_FULL_VOLUME;
+  sound->voice = NO_VOICE;
+  sound->playRequested = false;
+  sound->stopRequested = false;
+  sound->playing = false;
+  sounds[soundCount++] = sound;
+}
+
+// Adds a sound of 16-bit samples to the mixer, stopped.
+void mixer_register(mixer_sound_t *sound, const uint16_t samples[],
+                    uint32_t sampleCount, uint8_t priority) {
+  addSound(sound, samples, NULL, sampleCount, priority);
+}
+
+// Adds an IMA-ADPCM sound to the mixer, stopped.
+void mixer_registerAdpcm(mixer_sound_t *sound, const uint8_t adpcm[],
+                         uint32_t sampleCount, uint8_t priority) {
+  addSound(sound, NULL, adpcm, sampleCount, priority);
+}
+
+// Starts the sound from its beginning on the next render.
+void mixer_play(mixer_sound_t *sound, int16_t volume) {
+  // The request is complete before the ISR is told about it; only the ISR
+  // writes playing, when it gives the sound a voice.
+  sound->volume = volume;
+  sound->stopRequested = false;
+  sound->playRequested = true;
+  requestPending = true;
+}
+
+// Changes the volume of the sound, playing or not.
+void mixer_setVolume(mixer_sound_t *sound, int16_t volume) {
+  sound->volume = volume;
+}
+
+// Stops the sound.
+void mixer_stop(mixer_sound_t *sound) {
+  sound->playRequested = false;
+  sound->stopRequested = true;
+  requestPending = true;
+}
+
+// Stops every sound.
+void mixer_stopAll() {
+  for (uint16_t i = 0; i < soundCount; i++)
+    mixer_stop(sounds[i]);
+}
+
+// Returns true while the sound is playing or a play is pending.
+bool mixer_isPlaying(const mixer_sound_t *sound) {
+  return sound->playRequested || (sound->playing && !sound->stopRequested);
+}
+
+// Returns true while any sound is playing or a play is pending.
+bool mixer_isBusy() {
+  for (uint16_t i = 0; i < soundCount; i++)
+    if (mixer_isPlaying(sounds[i]))
+      return true;
+  return false;
+}
+
+// Mixes up to BLOCK_SIZE output samples. Each voice is added in turn, so
+// its sample pointer and volume stay in registers for the whole block.
+static void renderBlock(int16_t out[], uint32_t count) {
+  int32_t sums[BLOCK_SIZE];
+  for (uint32_t k = 0; k < count; k++)
+    sums[k] = 0;
+  for (uint16_t v = 0; v < MIXER_VOICE_COUNT; v++) {
+    voice_t *voice = &voices[v];
+    if (voice->sound == NULL)
+      continue;
+    uint32_t remaining = voice->sound->sampleCount - voice->position;
+    uint32_t n = remaining < count ? remaining : count;
+    int32_t volume = voice->sound->volume;
+    // Each product is back in Q15 before the sum, so MIXER_VOICE_COUNT
+    // full-scale voices cannot overflow it.
+    if (voice->sound->adpcm != NULL) {
+      int16_t decoded[BLOCK_SIZE];
+      adpcm_decode(&voice->decoder, voice->sound->adpcm, voice->position,
+                   decoded, n);
+      for (uint32_t k = 0; k < n; k++)
+        sums[k] += (decoded[k] * volume) >> Q15_SHIFT;
+    } else {
+      const uint16_t *samples = &voice->sound->samples[voice->position];
+      for (uint32_t k = 0; k < n; k++)
+        sums[k] += ((int16_t)(samples[k] ^ OFFSET_BINARY_ZERO) * volume) >>
+                   Q15_SHIFT;
+    }
+    voice->position += n;
+    if (voice->position == voice->sound->sampleCount)
+      freeVoice(voice);
+  }
+  for (uint32_t k = 0; k < count; k++)
+    out[k] = sums[k] > INT16_MAX   ? INT16_MAX
+             : sums[k] < INT16_MIN ? INT16_MIN
+                                   : sums[k];
+}
+
+// Applies the pending requests and mixes the next count output samples.
+void mixer_render(int16_t out[], uint32_t count) {
+  if (requestPending)
+    applyRequests();
+  while (count > 0) {
+    uint32_t n = count < BLOCK_SIZE ? count : BLOCK_SIZE;
+    renderBlock(out, n);
+    out += n;
+    count -= n;
+  }
+}
@@ -0,0 +1,91 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef MIXER_H_
+#define MIXER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adpcm.h"
+
+// Plays up to MIXER_VOICE_COUNT sounds at once. Each playing sound has a voice
+// that steps through its samples; mixer_render() scales each voice by its Q15
+// volume, adds them up and saturates the sum to a Q15 output sample. When
+// every voice is busy, a new sound takes the voice of the lowest-priority
+// sound (the one that has played longest, among equals), as long as that
+// priority is not above its own; otherwise the new sound is not played.
+//
+// A sound is either 16-bit samples, as from wav2c, or 4-bit IMA-ADPCM, as
+// from encodeAdpcm.py, which each voice decodes as it mixes (see adpcm.h).
+//
+// Like the timer service, the sounds are owned by the caller and registered
+// once. mixer_play(), mixer_stop() and mixer_setVolume() may be called from
+// the main loop or from the ISR: they only post a request in the sound, and
+// mixer_render() applies it, so the voices are only touched in the ISR and no
+// interrupts need to be disabled. Only the ISR writes the playing flag of a
+// sound; mixer_isPlaying() also counts the pending requests. A sound plays on
+// one voice at a time: playing it again restarts it.
+
+#define MIXER_VOICE_COUNT 4
+#define MIXER_MAX_SOUND_COUNT 16
+#define MIXER_FULL_VOLUME INT16_MAX // Q15 gain of 1.
+
+typedef struct {
+  const uint16_t *samples; // 16-bit offset-binary samples, as from wav2c.
+  const uint8_t *adpcm;    // Or IMA-ADPCM (see adpcm.h); the other is NULL.
+  uint32_t sampleCount;
+  uint8_t priority;        // Higher priorities take voices from lower ones.
+  volatile int16_t volume; // Q15 gain, 0 to MIXER_FULL_VOLUME.
+  int8_t voice;            // -1 if the sound is not on a voice.
+  volatile bool playRequested;
+  volatile bool stopRequested;
+  volatile bool playing;   // Written by the ISR only.
+} mixer_sound_t;
+
+// Stops every voice and forgets every sound. Call this before registering the
+// sounds, with the ISR not running.
+void mixer_init();
+
+// Adds a sound to the mixer, stopped. Call this from an init function, with
+// the ISR not running.
+void mixer_register(mixer_sound_t *sound, const uint16_t samples[],
+                    uint32_t sampleCount, uint8_t priority);
+
+// Adds an IMA-ADPCM sound to the mixer, stopped. Call this from an init
+// function, with the ISR not running.
+void mixer_registerAdpcm(mixer_sound_t *sound, const uint8_t adpcm[],
+                         uint32_t sampleCount, uint8_t priority);
+
+// Starts the sound from its beginning at the given Q15 volume, on the next
+// mixer_render().
+void mixer_play(mixer_sound_t *sound, int16_t volume);
+
+// Changes the volume of the sound, playing or not.
+void mixer_setVolume(mixer_sound_t *sound, int16_t volume);
+
+// Stops the sound.
+void mixer_stop(mixer_sound_t *sound);
+
+// Stops every sound.
+void mixer_stopAll();
+
+// Returns true from mixer_play() until the sound ends, is stopped or loses
+// its voice.
+bool mixer_isPlaying(const mixer_sound_t *sound);
+
+// Returns true while any sound is playing or a play is pending.
+bool mixer_isBusy();
+
+// Applies the pending requests and mixes the next count output samples into
+// out[] as Q15 values. Silence once no sound is playing. Call this from the
+// ISR (or a single thread) only.
+void mixer_render(int16_t out[], uint32_t count);
+
+#endif /* MIXER_H_ */
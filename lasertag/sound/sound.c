@@ -9,21 +9,22 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 
 #include <stdio.h>
 
+#include "mixer.h"
 #include "sound.h"
-#include "battleDroidScream48k.wav.h"
-#include "blasterReload48k.wav.h"
-#include "blasterShot48k.wav.h"
-#include "droidHit48k.wav.h"
-#include "helloThere48k.wav.h"
-#include "jediDie48k.wav.h"
-#include "jediHit48k.wav.h"
-#include "lightSaberClose48k.wav.h"
-#include "lightSaberLoop48k.wav.h"
-#include "lightSaberOpen48k.wav.h"
-#include "surrenderJedi48k.wav.h"
-#include "swBadGuyTheme48k.wav.h"
-#include "swGoodGuyTheme48k.wav.h"
-#include "gunEmpty48k.wav.h"
+#include "battleDroidScream48k.adpcm.h"
+#include "blasterReload48k.adpcm.h"
+#include "blasterShot48k.adpcm.h"
+#include "droidHit48k.adpcm.h"
+#include "helloThere48k.adpcm.h"
+#include "jediDie48k.adpcm.h"
+#include "jediHit48k.adpcm.h"
+#include "lightSaberClose48k.adpcm.h"
+#include "lightSaberLoop48k.adpcm.h"
+#include "lightSaberOpen48k.adpcm.h"
+#include "surrenderJedi48k.adpcm.h"
+#include "swBadGuyTheme48k.adpcm.h"
+#include "swGoodGuyTheme48k.adpcm.h"
+#include "gunEmpty48k.adpcm.h"
 #include "timer_ps.h"
 #include "xiicps.h"
 #include "xil_printf.h"
@@ -58,10 +59,20 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 
 #define SOUND_MULTIPLIER INT16_MAX / 3 // Primitive volume control.
 
-#define NO_SOUND 0 // A zero generates no sound.
-#define ONE_SECOND_OF_SOUND_ARRAY_SIZE                                         \
+#define ONE_SECOND_OF_SOUND_SAMPLE_COUNT                                       \
   48000 // The sample rate is 48k so that is 1 second's worth.
-uint16_t soundOfSilence[ONE_SECOND_OF_SOUND_ARRAY_SIZE];
+#define OFFSET_BINARY_ZERO 0x8000 // Converts mixer output to the offset-binary
+                                  // format of the FIFO.
+// All-zero IMA-ADPCM decodes to silence (see adpcm.h).
+static const uint8_t soundOfSilence[ONE_SECOND_OF_SOUND_SAMPLE_COUNT /
+                                    ADPCM_SAMPLES_PER_BYTE];
+
+// Mixer priorities: a sound can take the voice of a sound of equal or lower
+// priority when all of the voices are busy (see mixer.h).
+#define PRIORITY_BACKGROUND 0 // Gunfire, clicks, the lightsaber hum.
+#define PRIORITY_EFFECT 1     // Reloads, lightsaber open and close.
+#define PRIORITY_HIT 2        // Being hit.
+#define PRIORITY_GAME 3       // Game start, lost lives and game over.
 
 // Declared below the sound state-machine code.
 static int AudioInitialize(u16 timerID, u16 iicID, u32 i2sAddr);
@@ -72,17 +83,15 @@ static int AudioInitialize(u16 timerID, u16 iicID, u32 i2sAddr);
 // True if sound_init() has been called, false otherwise.
 volatile static bool sound_initFlag = false;
 
-// True if a sound should be played, false otherwise.
-// Note that the state-machine sets this back to false once it has completed
-// playing a sound.
-volatile static bool sound_playSoundFlag = false;
+// One mixer sound per sound_sounds_t, so that several can play at once.
+static mixer_sound_t sounds[sound_gameOver_jedi + 1];
 
-// Keep track of the base pointer to the sound array with current sample-rate
-// and sample count.
-volatile static uint16_t *sound_array; // Base pointer to the sound array.
+// The sound selected by sound_setSound() for sound_startSound().
+volatile static sound_sounds_t sound_selected = sound_oneSecondSilence_e;
 
-// static uint32_t sound_sampleRate;  // Sample rate for this sound.
-volatile static uint32_t sound_sampleCount; // Number of samples in this sound.
+// Mixed samples waiting for room in the FIFO, from mixAhead[mixIndex] on.
+static int16_t mixAhead[SOUND_MIX_AHEAD_SAMPLE_COUNT];
+static uint16_t mixIndex = SOUND_MIX_AHEAD_SAMPLE_COUNT;
 
 // Keep track of the current volume setting.
 volatile static sound_volume_t sound_currentVolume = sound_minimumVolume_e;
@@ -120,14 +129,54 @@ static void sound_sendDataToBothChannels(uint32_t sampleValue) {
             sampleValue); // add to right Channel.
 }
 
+// Registers every sound with the mixer.
+static void registerSounds() {
+  mixer_init();
+  mixer_registerAdpcm(&sounds[sound_gameStart_jedi], helloThere48k_adpcm,
+                      HELLOTHERE48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_GAME);
+  mixer_registerAdpcm(&sounds[sound_gameStart_droid], surrenderJedi48k_adpcm,
+                      SURRENDERJEDI48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_GAME);
+  mixer_registerAdpcm(&sounds[sound_oneSecondSilence_e], soundOfSilence,
+                      ONE_SECOND_OF_SOUND_SAMPLE_COUNT, PRIORITY_BACKGROUND);
+  // These are droid sounds
+  mixer_registerAdpcm(&sounds[sound_gunFire_droid], blasterShot48k_adpcm,
+                      BLASTERSHOT48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_BACKGROUND);
+  mixer_registerAdpcm(&sounds[sound_gunReload_droid], blasterReload48k_adpcm,
+                      BLASTERRELOAD48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_EFFECT);
+  mixer_registerAdpcm(&sounds[sound_gunClick_e], gunEmpty48k_adpcm,
+                      GUNEMPTY48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_BACKGROUND);
+  mixer_registerAdpcm(&sounds[sound_hit_droid], droidHit48k_adpcm,
+                      DROIDHIT48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_HIT);
+  mixer_registerAdpcm(&sounds[sound_lightsaber_open], lightSaberOpen48k_adpcm,
+                      LIGHTSABEROPEN48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_EFFECT);
+  mixer_registerAdpcm(&sounds[sound_lightsaber_close], lightSaberClose48k_adpcm,
+                      LIGHTSABERCLOSE48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_EFFECT);
+  mixer_registerAdpcm(&sounds[sound_lightsaber_loop], lightSaberLoop48k_adpcm,
+                      LIGHTSABERLOOP48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_BACKGROUND);
+  mixer_registerAdpcm(&sounds[sound_die_droid], battleDroidScream48k_adpcm,
+                      BATTLEDROIDSCREAM48K_ADPCM_NUMBER_OF_SAMPLES,
+                      PRIORITY_GAME);
+  mixer_registerAdpcm(&sounds[sound_gameOver_droid], swGoodGuyTheme48k_adpcm,
+                      SWGOODGUYTHEME48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_GAME);
+  mixer_registerAdpcm(&sounds[sound_hit_jedi], jediHit48k_adpcm,
+                      JEDIHIT48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_HIT);
+  mixer_registerAdpcm(&sounds[sound_die_jedi], jediDie48k_adpcm,
+                      JEDIDIE48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_GAME);
+  mixer_registerAdpcm(&sounds[sound_gameOver_jedi], swBadGuyTheme48k_adpcm,
+                      SWBADGUYTHEME48K_ADPCM_NUMBER_OF_SAMPLES, PRIORITY_GAME);
+}
+
 // Must be called before using the sound state machine.
 sound_status_t sound_init() {
   // Setup the audio CODEC.
   AudioInitialize(SCU_TIMER_ID, AUDIO_IIC_ID, AUDIO_CTRL_BASEADDR);
+  registerSounds();
   sound_initFlag = true;
-  // Initialize the silence array.
-  for (uint32_t i = 0; i < ONE_SECOND_OF_SOUND_ARRAY_SIZE; i++)
-    soundOfSilence[i] = NO_SOUND;
   sound_setVolume(sound_minimumVolume_e); // Init the volume level.
   return SOUND_STATUS_OK;
 }
@@ -164,19 +213,6 @@ static void debugStatePrint() {
 // Standard tick function.
 void sound_tick() {
   //  debugStatePrint();
-  static uint32_t arrayIndex = 0;
-  // Action switch statement.
-  switch (currentState) {
-  case sound_init_st:
-    // Does nothing.
-    break;
-  case sound_wait_st:
-    // Does nothing.
-    break;
-  case sound_play_st:
-    // Does nothing.
-    break;
-  }
   // Transistion switch statement.
   switch (currentState) {
   case sound_init_st:
@@ -185,34 +221,33 @@ void sound_tick() {
     }
     break;
   case sound_wait_st:
-    if (sound_playSoundFlag) {
-      arrayIndex = 0;
+    if (mixer_isBusy()) {
       currentState = sound_play_st;
+      mixIndex = SOUND_MIX_AHEAD_SAMPLE_COUNT; // Nothing mixed yet.
       sound_resetTxFifo();  // Reset the TX FIFO.
       sound_enableTxFifo(); // Enable the TX FIFO, disable mute.
     }
     break;
   case sound_play_st:
-    // Each time you enter this state, add as many samples as will fit in the
-    // FIFO.
-    if (sound_array == NULL) {
-      printf("ERROR, sound_tick: sound array has not been set.\n");
-      return;
-    }
-    // This while-loop continues to load sound-data into the FIFOs until it is
-    // full or the sound data are exhausted.
+    // Each time you enter this state, add as many mixed samples as will fit in
+    // the FIFO. At 48 kHz that is about one every other tick. The mixer is
+    // asked for SOUND_MIX_AHEAD_SAMPLE_COUNT samples at a time.
     while (!(Xil_In32(AUDIO_CTRL_BASEADDR + I2S_FIFO_STS_REG) &
              0b0010)) { // while room in FIFO.
+      if (mixIndex == SOUND_MIX_AHEAD_SAMPLE_COUNT) {
+        if (!mixer_isBusy()) {          // All done?
+          sound_disableTxFifo();        // Disable the TX FIFO.
+          currentState = sound_wait_st; // Go back to the wait state.
+          break;
+        }
+        mixer_render(mixAhead, SOUND_MIX_AHEAD_SAMPLE_COUNT);
+        mixIndex = 0;
+      }
       uint32_t sampleValue =
-          sound_array[arrayIndex] * sound_currentVolume; // Scale by volume.
+          (uint16_t)(mixAhead[mixIndex++] + OFFSET_BINARY_ZERO) *
+          sound_currentVolume; // Scale by volume.
       sound_sendDataToBothChannels(
           sampleValue); // Send the sound data to the left and right channels.
-      arrayIndex++;     // Go to next sample.
-      if (arrayIndex == sound_sampleCount) { // All done?
-        sound_playSoundFlag = false;         // Yes.
-        sound_disableTxFifo();               // Disable the TX FIFO.
-        currentState = sound_wait_st;        // Go back to the wait state.
-      }
     }
     break;
   }
@@ -220,109 +255,41 @@ void sound_tick() {
 
 // Sets the sound and starts playing it immediately.
 void sound_playSound(sound_sounds_t sound) {
-  sound_setSound(sound); // Set the sound to be played.
-  sound_startSound();    // Start playing the sound.
+  if (sound > sound_gameOver_jedi) {
+    printf("sound_playSound(): bogus sound value(%d)\n", sound);
+    return;
+  }
+  // Not through sound_setSound(), which the main loop may be in the middle of.
+  mixer_play(&sounds[sound], MIXER_FULL_VOLUME);
 }
 
 // Returns true if the sound is still playing.
 bool sound_isBusy() {
-  return (sound_playSoundFlag); // Busy if NOT in the wait state.
+  return mixer_isBusy(); // Busy while any sound is playing.
 }
 
 // Returns true if the sound has finished playing.
 bool sound_isSoundComplete() { return (!sound_isBusy()); }
 
-// Use this to set the base address for the array containing sound data.
-// Allow sounds to be interrupted.
+// Selects the sound that sound_startSound() plays. Sounds that are already
+// playing keep playing, mixed with it.
 void sound_setSound(sound_sounds_t sound) {
-  if (sound_isBusy()) { // You are currently playing some sound.
-    sound_stopSound(); // Stop the sound and reset the state-machine, FIFO, etc.
-  }
-  sound_array =
-      NULL; // Set the pointer to NULL so you can detect it never being set.
-  switch (sound) {
-  case sound_gameStart_jedi:
-    sound_array = helloThere48k_wav; // Set the array holding the data.
-    sound_sampleCount =
-        HELLOTHERE48K_WAV_NUMBER_OF_SAMPLES; // Size of the array.
-    break;
-  case sound_gameStart_droid:
-    sound_array = surrenderJedi48k_wav; // Set the array holding the data.
-    sound_sampleCount =
-        SURRENDERJEDI48K_WAV_NUMBER_OF_SAMPLES; // Size of the array.
-    break;
-  case sound_oneSecondSilence_e:
-    sound_array = soundOfSilence;
-    sound_sampleCount = ONE_SECOND_OF_SOUND_ARRAY_SIZE;
-    break;
-    //These are droid sounds
-  case sound_gunFire_droid:
-    sound_array = blasterShot48k_wav; // Set the array holding the data.
-    sound_sampleCount =
-        BLASTERSHOT48K_WAV_NUMBER_OF_SAMPLES; // Size of the array.
-    break;
-  case sound_gunReload_droid:
-    sound_array = blasterReload48k_wav; // Set the array holding the data.
-    sound_sampleCount =
-        BLASTERRELOAD48K_WAV_NUMBER_OF_SAMPLES; // Size of the array.
-    break;
-  case sound_gunClick_e:
-    sound_array = gunEmpty48k_wav;
-    sound_sampleCount = GUNEMPTY48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_hit_droid:
-    sound_array = droidHit48k_wav; // You get the idea...
-    sound_sampleCount = DROIDHIT48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_lightsaber_open:
-    sound_array = lightSaberOpen48k_wav; // You get the idea...
-    sound_sampleCount = LIGHTSABEROPEN48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_lightsaber_close:
-    sound_array = lightSaberClose48k_wav; // You get the idea...
-    sound_sampleCount = LIGHTSABERCLOSE48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_lightsaber_loop:
-    sound_array = lightSaberLoop48k_wav; // You get the idea...
-    sound_sampleCount = LIGHTSABERLOOP48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_die_droid:
-    sound_array = battleDroidScream48k_wav;
-    sound_sampleCount = BATTLEDROIDSCREAM48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_gameOver_droid:
-    sound_array = swGoodGuyTheme48k_wav;
-    sound_sampleCount = SWGOODGUYTHEME48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_hit_jedi:
-    sound_array = jediHit48k_wav;
-    sound_sampleCount = JEDIHIT48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_die_jedi:
-    sound_array = jediDie48k_wav;
-    sound_sampleCount = JEDIDIE48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  case sound_gameOver_jedi:
-    sound_array = swBadGuyTheme48k_wav;
-    sound_sampleCount = SWBADGUYTHEME48K_WAV_NUMBER_OF_SAMPLES;
-    break;
-  default:
+  if (sound > sound_gameOver_jedi) {
     printf("sound_setSound(): bogus sound value(%d)\n", sound);
+    return;
   }
+  sound_selected = sound;
 }
 
 // Used to set the volume. Use one of the provided values.
 void sound_setVolume(sound_volume_t volume) { sound_currentVolume = volume; }
 
 // Tell the state machine to start playing the sound.
-void sound_startSound() { sound_playSoundFlag = true; }
+void sound_startSound() { mixer_play(&sounds[sound_selected], MIXER_FULL_VOLUME); }
 
-// Stops playing the sound and resets the state-machine to the wait state.
-void sound_stopSound() {
-  sound_playSoundFlag = false; // disable the state-machine.
-  currentState =
-      sound_wait_st; // Force the state-machine back to the wait state.
-}
+// Stops playing every sound; the state-machine goes back to the wait state
+// once the mixer is idle.
+void sound_stopSound() { mixer_stopAll(); }
 
 // Plays several sounds.
 // To invoke, just place this in your main.
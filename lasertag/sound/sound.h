@@ -23,6 +23,10 @@ typedef uint32_t sound_status_t;
 #define SOUND_VOLUME_2 (INT16_MAX / 8)
 #define SOUND_VOLUME_3 (INT16_MAX) // Max volume
 
+// Samples that sound_tick() mixes and decodes at a time, just ahead of the
+// FIFO. Fewer calls to the mixer than one per sample, for 1/6 ms of latency.
+#define SOUND_MIX_AHEAD_SAMPLE_COUNT 8
+
 // sound-specific defines.
 typedef enum {
   sound_gameStart_jedi,       // Play a sound when the game starts.
@@ -55,20 +59,22 @@ typedef enum {
 // Must be called before using the sound state machine.
 sound_status_t sound_init();
 
-// Standard tick function.
+// Standard tick function. Feeds the I2S FIFO with the mix of the sounds that
+// are playing (see mixer.h): a new sound no longer cuts off the others.
 void sound_tick();
 
-// Sets the sound and starts playing it immediately.
+// Sets the sound and starts playing it immediately. Safe to call from the
+// ISR. If the sound is already playing it starts over.
 void sound_playSound(sound_sounds_t sound);
 
-// Returns true if the sound is still playing.
+// Returns true while any sound is playing.
 bool sound_isBusy();
 
 // Returns true if the sound has finished playing.
 bool sound_isSoundComplete();
 
-// Use this to set the base address for the array containing sound data.
-// Allow sounds to be interrupted.
+// Selects the sound that sound_startSound() plays. Sounds that are already
+// playing keep playing.
 void sound_setSound(sound_sounds_t sound);
 
 // Used to set the volume. Use one of the provided values.
@@ -77,7 +83,7 @@ void sound_setVolume(sound_volume_t);
 // Tell the state machine to start playing the sound.
 void sound_startSound();
 
-// Stops playing the sound and resets the state-machine to the wait state.
+// Stops playing every sound and resets the state-machine to the wait state.
 void sound_stopSound();
 
 // Plays several sounds.
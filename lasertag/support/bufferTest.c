@@ -13,9 +13,11 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #include "buffer.h"
 
 #define MAX_ERROR_CNT 5
-#define MARK(n) (n^0x8000)
+#define MARK(n) ((n^0x8000) & BUFFER_DATA_MASK)
+#define BLOCK_SIZE 1000
 
 static uint32_t error_cnt;
+static buffer_data_t block[BLOCK_SIZE];
 
 static void check_value(buffer_data_t expected)
 {
@@ -34,6 +36,7 @@ void buffer_runTest(void)
 
 	buffer_init();
 	bsize = buffer_size();
+	printf("%d elements of %d bits in %d bytes\n", bsize, BUFFER_STORAGE_BITS, buffer_storageBytes());
 
 	printf("half-fill and drain test\n");
 	start = 0x10;
@@ -73,4 +76,31 @@ void buffer_runTest(void)
 	check_value(0);
 	check_value(0);
 	printf("errors: %d\n", error_cnt);
+
+	printf("block pop test\n");
+	start = 0x60;
+	error_cnt = 0;
+	// Wrap around the end of the buffer and read in uneven blocks.
+	for (i = start; i < start+bsize/2; i++) buffer_pushover(MARK(i));
+	for (i = start; i < start+bsize/2; i++) check_value(MARK(i));
+	for (i = start; i < start+bsize*3/4; i++) buffer_pushover(MARK(i));
+	i = start;
+	while (i < start+bsize*3/4) {
+		uint32_t count = buffer_popBlock(block, BLOCK_SIZE);
+		if (count != BLOCK_SIZE && count != start+bsize*3/4-i) {
+			printf(" -- error: popped %d values\n", count);
+			error_cnt++;
+			break;
+		}
+		for (uint32_t j = 0; j < count; j++, i++) {
+			if (block[j] != MARK(i)) {
+				if (error_cnt < MAX_ERROR_CNT)
+					printf(" -- error: expected: 0x%08X, found: 0x%08X\n", MARK(i), block[j]);
+				error_cnt++;
+			}
+		}
+	}
+	if (buffer_popBlock(block, BLOCK_SIZE) != 0 || buffer_elements() != 0)
+		error_cnt++;
+	printf("errors: %d\n", error_cnt);
 }
@@ -16,8 +16,11 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
  ******************************************************************************/
 //#define ADC_THROUGH_DETECTOR
 
+#include <complex.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifdef ADC_THROUGH_DETECTOR
 #include "detector.h"
@@ -28,8 +31,16 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 
 #include "queue.h"
 #include "filter.h"
+#include "filterFixed.h"
+#include "firKernel.h"
+#include "frequencyPlan.h"
 #include "histogram.h"
+#include "powerTracker.h"
+#include "intervalTimer.h"
 #include "utils.h"
+#ifdef ZYBO_BOARD
+#include "xparameters.h"
+#endif
 
 /*******************************************************************************
  * Uncomment the line below if your IIR-A coefficient arrays contain a leading
@@ -107,7 +118,11 @@ void filterTest_init(void) {
 }
 
 // Performs a floating-point compare that allows for some error.
+#ifdef FILTER_SINGLE_PRECISION
+#define TEST_FILTER_FLOATING_POINT_EPSILON 1.0E-5L // Single precision.
+#else
 #define TEST_FILTER_FLOATING_POINT_EPSILON 1.0E-12L
+#endif
 bool filterTest_floatingPointEqual(double a, double b) {
   return fabs(a - b) < TEST_FILTER_FLOATING_POINT_EPSILON;
 }
@@ -147,10 +162,13 @@ uint16_t filterTest_getDecimationValue(void) {
 // Returns true if it actually invokes filter_firFilter().
 // Used when not using the detector() function.
 static uint16_t firDecimationCount = 0;
+// The output of the last filter_firFilter() call. Only the direct-form IIR
+// filters read the FIR outputs from yQueue, so do not rely on it.
+static double filterTest_lastFirOutput = 0.0;
 bool filterTest_decimatingFirFilter(void) {
   if (firDecimationCount ==
       filterTest_getDecimationValue() - 1) { // Time to run the FIR filter?
-    filter_firFilter();                      // Run the FIR filter.
+    filterTest_lastFirOutput = filter_firFilter(); // Run the FIR filter.
     firDecimationCount = 0;                  // Reset the decimation count.
     return true; // Return true because you ran the FIR filter.
   }
@@ -335,40 +353,17 @@ buffer_data_t computeAdcBufferInput(uint16_t freqTick,
 #define PERIODS_TO_PLOT                                                        \
   2 // The number of period's worth of data to collect and plot.
 #define INPUT_PLOT_VIEW_DELAY 1000 // The plot will be visible for this long.
-// Plots the frequency response of the FIR filter on the TFT.
-// Everything is defined assuming a 100 kHz sample rate.
-// Frequencies run from 1.1 kHz to 50 kHz.
-// Output values are retrieved from a FIR debug queue (see
-// filter_getFirOutputDebugQueue()). Power is computed internally. Does not use
-// the filter_computePower... functions. To plot the input as well as output,
-// pass true to plotInputFlag.
-void filterTest_runSquareWaveFirPowerTest(bool printMessageFlag,
-                                          bool plotInputFlag) {
-  if (!filterTest_initFlag) {
-    printf("Must call filterTest_init() before running any filter tests.\n");
-    return;
-  }
+// Runs a square wave of every test period through the FIR filter (the
+// decimating front end selected with filter_initWithFirKernel()) for a pulse
+// width and stores the power of its outputs in testPeriodPowerValue[]. To plot
+// the input as well, pass true to plotInputFlag.
+static void filterTest_computeSquareWaveFirPower(double testPeriodPowerValue[],
+                                                 bool plotInputFlag) {
   double firPower = 0.0; // Power will be accumulated here.
 #ifdef ADC_THROUGH_DETECTOR
   detector_init(); // Use the detector to invoke the filters.
   buffer_init(); // Use the ADC buffer to provide data to the filters.
 #endif
-  if (printMessageFlag) {
-    // Tells you that this function is plotting the frequency response for the
-    // FIR filter for a set of frequencies.
-    printf(
-        "running filter_runFirPowerTest() - plotting power for "
-        "frequencies %1.2lf kHz to %1.2lf kHz for FIR filter.\n",
-        ((double)((FILTER_SAMPLE_FREQUENCY_IN_KHZ)) /
-         filterTest_firTestTickCounts[0]),
-        ((double)((FILTER_SAMPLE_FREQUENCY_IN_KHZ)) /
-         filterTest_firTestTickCounts[FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT -
-                                      1]));
-  }
-  double testPeriodPowerValue
-      [FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT]; // Computed power values will
-                                                 // go here.
-  uint16_t freqCount = 0;                        // Used to print info message.
   // Simulate running everything at 100 kHz. Simply add either 1.0 or -1.0 to
   // xQueue based upon the the frequency you are simulating. Iterate over all of
   // the test-periods.
@@ -400,9 +395,8 @@ void filterTest_runSquareWaveFirPowerTest(bool printMessageFlag,
         filter_addNewInput(
             filterValue); // Put the data into the input queue of the filter.
         if (filterTest_decimatingFirFilter()) {
-          double firOutput = filterTest_readMostRecentValueFromQueue(
-              filter_getYQueue());           // Get the output from the yQueue.
-          firPower += firOutput * firOutput; // Compute the power so far.
+          firPower += filterTest_lastFirOutput *
+                      filterTest_lastFirOutput; // Compute the power so far.
         }
 #endif
         if (plotInputFlag &&
@@ -446,10 +440,42 @@ void filterTest_runSquareWaveFirPowerTest(bool printMessageFlag,
 #endif
     testPeriodPowerValue[testPeriodIndex] =
         firPower; // Store the resulting power.
-    printf("freqCount:%d, testPeriodPowerValue:%le\n", freqCount,
-           testPeriodPowerValue[testPeriodIndex]); // Info. print.
-    freqCount++;
   }
+}
+
+// Plots the frequency response of the FIR filter on the TFT.
+// Everything is defined assuming a 100 kHz sample rate.
+// Frequencies run from 1.1 kHz to 50 kHz.
+// Output values are retrieved from a FIR debug queue (see
+// filter_getFirOutputDebugQueue()). Power is computed internally. Does not use
+// the filter_computePower... functions. To plot the input as well as output,
+// pass true to plotInputFlag.
+void filterTest_runSquareWaveFirPowerTest(bool printMessageFlag,
+                                          bool plotInputFlag) {
+  if (!filterTest_initFlag) {
+    printf("Must call filterTest_init() before running any filter tests.\n");
+    return;
+  }
+  if (printMessageFlag) {
+    // Tells you that this function is plotting the frequency response for the
+    // FIR filter for a set of frequencies.
+    printf(
+        "running filter_runFirPowerTest() - plotting power for "
+        "frequencies %1.2lf kHz to %1.2lf kHz for FIR filter.\n",
+        ((double)((FILTER_SAMPLE_FREQUENCY_IN_KHZ)) /
+         filterTest_firTestTickCounts[0]),
+        ((double)((FILTER_SAMPLE_FREQUENCY_IN_KHZ)) /
+         filterTest_firTestTickCounts[FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT -
+                                      1]));
+  }
+  double testPeriodPowerValue
+      [FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT]; // Computed power values will
+                                                 // go here.
+  filterTest_computeSquareWaveFirPower(testPeriodPowerValue, plotInputFlag);
+  for (uint16_t freqCount = 0;
+       freqCount < FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT; freqCount++)
+    printf("freqCount:%d, testPeriodPowerValue:%le\n", freqCount,
+           testPeriodPowerValue[freqCount]); // Info. print.
   // After running all of the data through the filters, plot it out.
   printf("Plotting response to square-wave input.\n");
   filterTest_plotFirFrequencyResponse(testPeriodPowerValue);
@@ -951,6 +977,1332 @@ bool filterTest_runPowerTest(void) {
   return firstComputeStatus & incrementalComputeStatus;
 }
 
+/*******************************************************************************
+***** Fixed-point engine tests
+***** The fixed-point engine (filterFixed.c) is checked two ways:
+***** 1. Bit-exactness against a plain integer model of the same arithmetic, so
+*****    that any optimized version of the engine can be checked the same way.
+***** 2. SNR and hit-detection agreement against a double-precision model of
+*****    filter.c on the standard square-wave test inputs.
+*******************************************************************************/
+
+#define FIXED_TEST_FIR_TAP_COUNT 81
+#define FIXED_TEST_IIR_A_COUNT 10
+#define FIXED_TEST_IIR_B_COUNT 11
+#define FIXED_TEST_OUTPUT_COUNT 2000 // Power window, in decimated samples.
+#define FIXED_TEST_RANDOM_SAMPLE_COUNT 50000
+#define FIXED_TEST_MIN_FIR_SNR_DB 60.0
+#define FIXED_TEST_MIN_IIR_SNR_DB 40.0
+#define FIXED_TEST_MAX_POWER_ERROR 0.01 // Relative error of the hit channel.
+#define FIXED_TEST_FUDGE_FACTOR 190     // Same as FUDGE_FACTOR in detector.c.
+#define FIXED_TEST_MEDIAN_INDEX 4       // Same as MEDIAN_INDEX in detector.c.
+
+// Integer model state. Index 0 holds the newest value.
+static int16_t fixedModelX[FIXED_TEST_FIR_TAP_COUNT];
+static int32_t fixedModelFirOutput;
+static int32_t fixedModelIn[FILTER_FREQUENCY_COUNT]
+                           [FILTER_FIXED_IIR_SECTION_COUNT][2];
+static int32_t fixedModelOut[FILTER_FREQUENCY_COUNT]
+                            [FILTER_FIXED_IIR_SECTION_COUNT][2];
+
+// Double model state. Index 0 holds the newest value.
+static double doubleModelX[FIXED_TEST_FIR_TAP_COUNT];
+static double doubleModelY[FIXED_TEST_IIR_B_COUNT];
+static double doubleModelZ[FILTER_FREQUENCY_COUNT][FIXED_TEST_IIR_A_COUNT];
+
+// Shifts a new value into a history array (index 0 is the newest).
+#define FIXED_TEST_SHIFT_IN(array, value)                                      \
+  do {                                                                         \
+    memmove(&(array)[1], &(array)[0],                                          \
+            sizeof(array) - sizeof((array)[0]));                               \
+    (array)[0] = (value);                                                      \
+  } while (0)
+
+static void filterTest_resetModels(void) {
+  memset(fixedModelX, 0, sizeof(fixedModelX));
+  memset(fixedModelIn, 0, sizeof(fixedModelIn));
+  memset(fixedModelOut, 0, sizeof(fixedModelOut));
+  fixedModelFirOutput = 0;
+  memset(doubleModelX, 0, sizeof(doubleModelX));
+  memset(doubleModelY, 0, sizeof(doubleModelY));
+  memset(doubleModelZ, 0, sizeof(doubleModelZ));
+}
+
+#ifdef FILTER_FIXED_POINT
+// Integer model of filterFixed_firFilter().
+static int16_t filterTest_fixedModelFir(void) {
+  const int16_t *h = filterFixed_getFirCoefficientArray();
+  int32_t total = 0;
+  for (uint32_t i = 0; i < FIXED_TEST_FIR_TAP_COUNT; i++)
+    total += h[i] * fixedModelX[i];
+  int32_t y = (total + (1 << 14)) >> 15;
+  y = y > INT16_MAX ? INT16_MAX : (y < INT16_MIN ? INT16_MIN : y);
+  fixedModelFirOutput = y << 16;
+  return y;
+}
+
+// Integer model of filterFixed_iirFilter().
+static int32_t filterTest_fixedModelIir(uint16_t filterNumber) {
+  int32_t x = fixedModelFirOutput;
+  for (uint32_t s = 0; s < FILTER_FIXED_IIR_SECTION_COUNT; s++) {
+    const filterFixed_biquad_t *c =
+        &filterFixed_getIirSectionArray(filterNumber)[s];
+    int32_t *in = fixedModelIn[filterNumber][s];
+    int32_t *out = fixedModelOut[filterNumber][s];
+    int64_t total = (int64_t)c->b[0] * x + (int64_t)c->b[1] * in[0] +
+                    (int64_t)c->b[2] * in[1] - (int64_t)c->a[0] * out[0] -
+                    (int64_t)c->a[1] * out[1];
+    total = (total + (1LL << 29)) >> 30;
+    int32_t y = total > INT32_MAX ? INT32_MAX
+                                  : (total < INT32_MIN ? INT32_MIN : total);
+    in[1] = in[0];
+    in[0] = x;
+    out[1] = out[0];
+    out[0] = y;
+    x = y;
+  }
+  return x;
+}
+#endif
+
+// Double model of filter_firFilter().
+
+static double filterTest_doubleModelFir(void) {
+  const double *h = filter_getFirCoefficientArray();
+  double total = 0.0;
+  for (uint32_t i = 0; i < FIXED_TEST_FIR_TAP_COUNT; i++)
+    total += h[i] * doubleModelX[i];
+  FIXED_TEST_SHIFT_IN(doubleModelY, total);
+  return total;
+}
+
+// Double model of filter_iirFilter().
+static double filterTest_doubleModelIir(uint16_t filterNumber) {
+  const double *b = filter_getIirBCoefficientArray(filterNumber);
+  const double *a = filter_getIirACoefficientArray(filterNumber);
+  double total = 0.0;
+  for (uint32_t i = 0; i < FIXED_TEST_IIR_B_COUNT; i++)
+    total += b[i] * doubleModelY[i];
+  for (uint32_t i = 0; i < FIXED_TEST_IIR_A_COUNT; i++)
+    total -= a[i] * doubleModelZ[filterNumber][i];
+  FIXED_TEST_SHIFT_IN(doubleModelZ[filterNumber], total);
+  return total;
+}
+
+#ifdef FILTER_FIXED_POINT
+// Feeds random Q15 samples through the engine and the integer model, with
+// decimation and all ten IIR filters, and checks every output and the power
+// values bit for bit.
+static bool filterTest_runFixedPointBitExactTest(bool printMessageFlag) {
+  filterFixed_init();
+  filterTest_resetModels();
+  static int64_t modelOutputs[FILTER_FREQUENCY_COUNT][FIXED_TEST_OUTPUT_COUNT];
+  memset(modelOutputs, 0, sizeof(modelOutputs));
+  filterFixed_power_t incrementalPower[FILTER_FREQUENCY_COUNT] = {0};
+  uint32_t outputIndex = 0;
+  uint32_t mismatchCount = 0;
+  srand(0);
+  for (uint32_t n = 0; n < FIXED_TEST_RANDOM_SAMPLE_COUNT; n++) {
+    int16_t x = (int16_t)(rand() & 0xFFFF);
+    filterFixed_addNewInput(x);
+    FIXED_TEST_SHIFT_IN(fixedModelX, x);
+    if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+      continue;
+    if (filterFixed_firFilter() != filterTest_fixedModelFir())
+      mismatchCount++;
+    for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+      int32_t y = filterTest_fixedModelIir(i);
+      if (filterFixed_iirFilter(i) != y)
+        mismatchCount++;
+      incrementalPower[i] = filterFixed_computePower(i, false);
+      modelOutputs[i][outputIndex] = y >> 8;
+    }
+    outputIndex = (outputIndex + 1) % FIXED_TEST_OUTPUT_COUNT;
+  }
+  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+    filterFixed_power_t modelPower = 0;
+    for (uint32_t j = 0; j < FIXED_TEST_OUTPUT_COUNT; j++)
+      modelPower += modelOutputs[i][j] * modelOutputs[i][j];
+    if (incrementalPower[i] != modelPower ||
+        filterFixed_computePower(i, true) != modelPower)
+      mismatchCount++;
+  }
+  if (printMessageFlag)
+    printf("filterTest_runFixedPointBitExactTest %s (%d mismatches)\n",
+           mismatchCount ? "failed" : "passed", mismatchCount);
+  return mismatchCount == 0;
+}
+#endif
+
+// qsort() comparison for doubles.
+static int filterTest_compareDoubles(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// Returns the hit-detection decision the detector would make: the index of
+// the strongest channel, or -1 if it does not exceed the median by the fudge
+// factor.
+static int16_t filterTest_hitDecision(const double powerValues[]) {
+  double sorted[FILTER_FREQUENCY_COUNT];
+  uint16_t maxIndex = 0;
+  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+    if (powerValues[i] > powerValues[maxIndex])
+      maxIndex = i;
+    int16_t j = i - 1;
+    for (; j >= 0 && sorted[j] > powerValues[i]; j--)
+      sorted[j + 1] = sorted[j];
+    sorted[j + 1] = powerValues[i];
+  }
+  return powerValues[maxIndex] >=
+                 FIXED_TEST_FUDGE_FACTOR * sorted[FIXED_TEST_MEDIAN_INDEX]
+             ? maxIndex
+             : -1;
+}
+
+static double filterTest_snrInDb(double signal, double noise) {
+  return noise > 0.0 ? 10.0 * log10(signal / noise) : INFINITY;
+}
+
+#ifdef FILTER_FIXED_POINT
+// Runs a square-wave pulse at each player frequency through the fixed-point
+// engine and the double model. Checks the SNR of the FIR and IIR outputs and
+// that the power values lead to the same hit-detection decision.
+static bool filterTest_runFixedPointSnrTest(bool printMessageFlag) {
+  bool success = true;
+  double firSignal = 0.0, firNoise = 0.0;
+  double iirSignal[FILTER_FREQUENCY_COUNT] = {0.0};
+  double iirNoise[FILTER_FREQUENCY_COUNT] = {0.0};
+  for (uint16_t freq = 0; freq < FILTER_FREQUENCY_COUNT; freq++) {
+    filterFixed_init();
+    filterTest_resetModels();
+    uint16_t period = filter_frequencyTickTable[freq];
+    double doublePower[FILTER_FREQUENCY_COUNT] = {0.0};
+    double fixedPower[FILTER_FREQUENCY_COUNT];
+    for (uint32_t n = 0; n < FILTER_TEST_PULSE_WIDTH_LENGTH; n++) {
+      double x = computeFilterInput(n % period, period);
+      filterFixed_addNewInput(filterFixed_fromDouble(x));
+      FIXED_TEST_SHIFT_IN(doubleModelX, x);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      double firReference = filterTest_doubleModelFir();
+      double firError =
+          filterFixed_q15ToDouble(filterFixed_firFilter()) - firReference;
+      firSignal += firReference * firReference;
+      firNoise += firError * firError;
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+        double iirReference = filterTest_doubleModelIir(i);
+        double iirError =
+            filterFixed_q31ToDouble(filterFixed_iirFilter(i)) - iirReference;
+        iirSignal[i] += iirReference * iirReference;
+        iirNoise[i] += iirError * iirError;
+        doublePower[i] += iirReference * iirReference;
+      }
+    }
+    // The pulse is exactly one power window long.
+    for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+      fixedPower[i] =
+          filterFixed_powerToDouble(filterFixed_computePower(i, true));
+    int16_t doubleHit = filterTest_hitDecision(doublePower);
+    int16_t fixedHit = filterTest_hitDecision(fixedPower);
+    double powerError =
+        fabs(fixedPower[freq] - doublePower[freq]) / doublePower[freq];
+    if (printMessageFlag)
+      printf("frequency %d: hit on %d (double) %d (fixed), power error %.2le\n",
+             freq, doubleHit, fixedHit, powerError);
+    if (doubleHit != fixedHit || powerError > FIXED_TEST_MAX_POWER_ERROR)
+      success = false;
+  }
+  double firSnr = filterTest_snrInDb(firSignal, firNoise);
+  if (printMessageFlag)
+    printf("FIR SNR: %.1lf dB\n", firSnr);
+  if (firSnr < FIXED_TEST_MIN_FIR_SNR_DB)
+    success = false;
+  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+    double iirSnr = filterTest_snrInDb(iirSignal[i], iirNoise[i]);
+    if (printMessageFlag)
+      printf("IIR filter %d SNR: %.1lf dB\n", i, iirSnr);
+    if (iirSnr < FIXED_TEST_MIN_IIR_SNR_DB)
+      success = false;
+  }
+  if (printMessageFlag)
+    printf("filterTest_runFixedPointSnrTest %s\n",
+           success ? "passed" : "failed");
+  return success;
+}
+
+#endif
+
+// Runs both fixed-point engine tests. filterFixed.c is only built with
+// FILTER_FIXED_POINT, so the other builds have nothing to test.
+bool filterTest_runFixedPointTest(bool printMessageFlag) {
+#ifdef FILTER_FIXED_POINT
+  bool success = filterTest_runFixedPointBitExactTest(printMessageFlag);
+  success &= filterTest_runFixedPointSnrTest(printMessageFlag);
+  return success;
+#else
+  return true;
+#endif
+}
+
+/*******************************************************************************
+***** Sample precision test
+*******************************************************************************/
+
+#define PRECISION_TEST_MIN_SNR_DB 80.0
+#define PRECISION_TEST_MAX_POWER_ERROR 1.0E-4 // Relative error, hit channel.
+
+// Runs a square-wave pulse at each player frequency through filter.c, in the
+// precision it was built with (see sample.h), and through the double model.
+// Checks the SNR of the FIR and IIR outputs and that the power values lead to
+// the same hit-detection decision.
+bool filterTest_runPrecisionTest(bool printMessageFlag) {
+  bool success = true;
+  double firSignal = 0.0, firNoise = 0.0;
+  double iirSignal = 0.0, iirNoise = 0.0;
+  for (uint16_t freq = 0; freq < FILTER_FREQUENCY_COUNT; freq++) {
+    filter_init();
+    filterTest_resetModels();
+    uint16_t period = filter_frequencyTickTable[freq];
+    double doublePower[FILTER_FREQUENCY_COUNT] = {0.0};
+    double filterPower[FILTER_FREQUENCY_COUNT];
+    for (uint32_t n = 0; n < FILTER_TEST_PULSE_WIDTH_LENGTH; n++) {
+      double x = computeFilterInput(n % period, period);
+      filter_addNewInput(x);
+      FIXED_TEST_SHIFT_IN(doubleModelX, x);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      double firReference = filterTest_doubleModelFir();
+      double firError = filter_firFilter() - firReference;
+      firSignal += firReference * firReference;
+      firNoise += firError * firError;
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+        double iirReference = filterTest_doubleModelIir(i);
+        double iirError = filter_iirFilter(i) - iirReference;
+        iirSignal += iirReference * iirReference;
+        iirNoise += iirError * iirError;
+        doublePower[i] += iirReference * iirReference;
+      }
+    }
+    // The pulse is exactly one power window long.
+    for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+      filterPower[i] = filter_computePower(i, true, false);
+    int16_t doubleHit = filterTest_hitDecision(doublePower);
+    int16_t filterHit = filterTest_hitDecision(filterPower);
+    double powerError =
+        fabs(filterPower[freq] - doublePower[freq]) / doublePower[freq];
+    if (printMessageFlag)
+      printf("frequency %d: hit on %d (double) %d (%s), power error %.2le\n",
+             freq, doubleHit, filterHit,
+             sizeof(sample_t) == sizeof(float) ? "float" : "double",
+             powerError);
+    if (doubleHit != filterHit || powerError > PRECISION_TEST_MAX_POWER_ERROR)
+      success = false;
+  }
+  double firSnr = filterTest_snrInDb(firSignal, firNoise);
+  double iirSnr = filterTest_snrInDb(iirSignal, iirNoise);
+  if (printMessageFlag)
+    printf("FIR SNR: %.1lf dB, IIR SNR: %.1lf dB\n", firSnr, iirSnr);
+  if (firSnr < PRECISION_TEST_MIN_SNR_DB || iirSnr < PRECISION_TEST_MIN_SNR_DB)
+    success = false;
+  if (printMessageFlag)
+    printf("filterTest_runPrecisionTest %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+/*******************************************************************************
+***** FIR kernel tests
+*******************************************************************************/
+
+#define FIR_KERNEL_TEST_SAMPLE_COUNT 5000 // Wraps the kernel window a few times.
+#define FIR_KERNEL_TEST_EPSILON 1.0E-5    // Single precision.
+#define FIR_KERNEL_BENCHMARK_SAMPLE_COUNT 200000
+#define FIR_KERNEL_BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define FIR_KERNEL_BENCHMARK_RUN_COUNT 5 // The fastest run is reported.
+#define NANOSECONDS_PER_SECOND 1.0E9
+#define FIR_FOLDING_TEST_WINDOW_COUNT 100
+#define FIR_FOLDING_BENCHMARK_OUTPUT_COUNT 200000
+#define FIR_FOLDING_BENCHMARK_WINDOW_SIZE 1024
+#define FIR_FOLDING_BENCHMARK_RUN_COUNT 5 // The fastest run is reported.
+
+// Tap counts that exercise the vector loops and every tail length, odd and
+// even.
+static const uint32_t firFoldingTestTapCounts[] = {2, 3, 8, 16, 17, 33,
+                                                   46, 81, 127, 128};
+
+// Checks every supported window-based FIR kernel against the double model on
+// random input.
+bool filterTest_runFirKernelTest(bool printMessageFlag) {
+  bool success = true;
+  for (filter_firKernel_t kernel = FILTER_FIR_KERNEL_SCALAR;
+       kernel < FILTER_FIR_KERNEL_BEST; kernel++) {
+    if (!firKernel_isSupported(kernel))
+      continue;
+    filter_initWithFirKernel(kernel);
+    filterTest_resetModels();
+    srand(0);
+    double maxError = 0.0;
+    for (uint32_t n = 0; n < FIR_KERNEL_TEST_SAMPLE_COUNT; n++) {
+      double x = 2.0 * filterTest_randomValue0To1() - 1.0;
+      filter_addNewInput(x);
+      FIXED_TEST_SHIFT_IN(doubleModelX, x);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      double error = fabs(filter_firFilter() - filterTest_doubleModelFir());
+      if (error > maxError)
+        maxError = error;
+    }
+    if (maxError > FIR_KERNEL_TEST_EPSILON)
+      success = false;
+    if (printMessageFlag)
+      printf("FIR kernel %s: max error %.2le\n", firKernel_getName(kernel),
+             maxError);
+  }
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runFirKernelTest %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Returns the FIR output for a window (oldest input first) in double
+// precision.
+static double filterTest_windowFir(const float window[],
+                                   const double coefficients[],
+                                   uint32_t tapCount) {
+  double total = 0.0;
+  for (uint32_t i = 0; i < tapCount; i++)
+    total += window[i] * coefficients[tapCount - 1 - i];
+  return total;
+}
+
+// Installs random symmetric tables, and the same tables with one coefficient
+// nudged by the smallest possible amount, for every supported kernel. The
+// symmetric tables must be folded, the others must fall back to the general
+// kernel, and both must match the double-precision FIR.
+bool filterTest_runFirFoldingTest(bool printMessageFlag) {
+  bool success = true;
+  static firKernel_fir_t fir;
+  double coefficients[FIR_KERNEL_MAX_TAP_COUNT];
+  float window[FIR_KERNEL_MAX_TAP_COUNT];
+  srand(0);
+  for (filter_firKernel_t kernel = FILTER_FIR_KERNEL_SCALAR;
+       kernel < FILTER_FIR_KERNEL_BEST; kernel++) {
+    if (!firKernel_isSupported(kernel))
+      continue;
+    double maxError = 0.0;
+    for (uint32_t t = 0;
+         t < sizeof(firFoldingTestTapCounts) / sizeof(firFoldingTestTapCounts[0]);
+         t++) {
+      uint32_t tapCount = firFoldingTestTapCounts[t];
+      // Keep the sum of |coefficients| at or below 1 so the epsilon holds.
+      for (uint32_t i = 0; i < (tapCount + 1) / 2; i++) {
+        coefficients[i] = (2.0 * filterTest_randomValue0To1() - 1.0) / tapCount;
+        coefficients[tapCount - 1 - i] = coefficients[i];
+      }
+      for (uint32_t symmetric = 0; symmetric < 2; symmetric++) {
+        if (!symmetric)
+          coefficients[0] = nextafter(coefficients[0], 1.0);
+        else
+          coefficients[0] = coefficients[tapCount - 1];
+        firKernel_install(&fir, kernel, coefficients, tapCount, true);
+        if (fir.folded != (bool)symmetric) {
+          success = false;
+          printf("FIR kernel %s, %u taps: folded is %d, expected %u\n",
+                 firKernel_getName(kernel), tapCount, fir.folded, symmetric);
+        }
+        for (uint32_t w = 0; w < FIR_FOLDING_TEST_WINDOW_COUNT; w++) {
+          for (uint32_t i = 0; i < tapCount; i++)
+            window[i] = 2.0 * filterTest_randomValue0To1() - 1.0;
+          double error = fabs(firKernel_run(&fir, window) -
+                              filterTest_windowFir(window, coefficients, tapCount));
+          if (error > maxError)
+            maxError = error;
+        }
+      }
+    }
+    if (maxError > FIR_KERNEL_TEST_EPSILON)
+      success = false;
+    if (printMessageFlag)
+      printf("FIR kernel %s general/folded: max error %.2le\n",
+             firKernel_getName(kernel), maxError);
+  }
+  // The generated table must be exactly symmetric, or nothing in filter.c
+  // runs folded.
+  if (!firKernel_isSymmetric(filter_getFirCoefficientArray(),
+                             FIXED_TEST_FIR_TAP_COUNT) ||
+      !filter_setFirFolding(true)) {
+    success = false;
+    printf("The FIR table of filter.c is not symmetric\n");
+  }
+  if (printMessageFlag)
+    printf("filterTest_runFirFoldingTest %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Times one FIR output for an installed table, in nanoseconds. The window
+// slides along the buffer so that every output sees different alignment.
+static double filterTest_timeFirKernel(const firKernel_fir_t *fir,
+                                       const float buffer[]) {
+  uint32_t offsetCount = FIR_FOLDING_BENCHMARK_WINDOW_SIZE - fir->tapCount;
+  volatile float sink = 0.0f;
+  double fastest = INFINITY;
+  for (uint32_t run = 0; run < FIR_FOLDING_BENCHMARK_RUN_COUNT; run++) {
+    intervalTimer_init(FIR_KERNEL_BENCHMARK_TIMER);
+    intervalTimer_start(FIR_KERNEL_BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < FIR_FOLDING_BENCHMARK_OUTPUT_COUNT; n++)
+      sink += firKernel_run(fir, &buffer[n % offsetCount]);
+    intervalTimer_stop(FIR_KERNEL_BENCHMARK_TIMER);
+    fastest = fmin(fastest, intervalTimer_getTotalDurationInSeconds(
+                                FIR_KERNEL_BENCHMARK_TIMER));
+  }
+  (void)sink;
+  return fastest * NANOSECONDS_PER_SECOND / FIR_FOLDING_BENCHMARK_OUTPUT_COUNT;
+}
+
+// Times one filter_firFilter() output of a double-precision kernel, general
+// or folded, in nanoseconds.
+static double filterTest_timeFilterFir(filter_firKernel_t kernel, bool fold) {
+  filter_initWithFirKernel(kernel);
+  filter_setIirStructure(FILTER_IIR_BIQUAD); // As in the detector.
+  filter_setFirFolding(fold);
+  for (uint32_t i = 0; i < FIR_FOLDING_BENCHMARK_WINDOW_SIZE; i++)
+    filter_addNewInput(2.0 * filterTest_randomValue0To1() - 1.0);
+  volatile double sink = 0.0;
+  double fastest = INFINITY;
+  for (uint32_t run = 0; run < FIR_FOLDING_BENCHMARK_RUN_COUNT; run++) {
+    intervalTimer_init(FIR_KERNEL_BENCHMARK_TIMER);
+    intervalTimer_start(FIR_KERNEL_BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < FIR_FOLDING_BENCHMARK_OUTPUT_COUNT; n++)
+      sink += filter_firFilter();
+    intervalTimer_stop(FIR_KERNEL_BENCHMARK_TIMER);
+    fastest = fmin(fastest, intervalTimer_getTotalDurationInSeconds(
+                                FIR_KERNEL_BENCHMARK_TIMER));
+  }
+  (void)sink;
+  return fastest * NANOSECONDS_PER_SECOND / FIR_FOLDING_BENCHMARK_OUTPUT_COUNT;
+}
+
+// Prints the general and folded cost of one FIR output, and on the board the
+// CPU cycles, for one kernel.
+static void filterTest_printFirFolding(filter_firKernel_t kernel,
+                                       double generalNanoseconds,
+                                       double foldedNanoseconds,
+                                       bool filterFolds) {
+  printf("FIR kernel %-15s general %6.1lf ns, folded %6.1lf ns per output "
+         "(%.0lf%% saved), filter.c runs %s\n",
+         firKernel_getName(kernel), generalNanoseconds, foldedNanoseconds,
+         100.0 * (1.0 - foldedNanoseconds / generalNanoseconds),
+         filterFolds ? "folded" : "general");
+#ifdef ZYBO_BOARD
+  printf("%27s general %6.0lf, folded %6.0lf cycles per output\n", "",
+         generalNanoseconds * XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ /
+             NANOSECONDS_PER_SECOND,
+         foldedNanoseconds * XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ /
+             NANOSECONDS_PER_SECOND);
+#endif
+}
+
+// Prints the cost of one output of the (symmetric) FIR in filter.c with the
+// general and the folded form of each kernel: filter_firFilter() for the
+// double-precision kernels, the bare kernel for the single-precision ones.
+void filterTest_runFirFoldingBenchmark(void) {
+  static firKernel_fir_t general;
+  static firKernel_fir_t folded;
+  static float buffer[FIR_FOLDING_BENCHMARK_WINDOW_SIZE];
+  srand(0);
+  for (filter_firKernel_t kernel = FILTER_FIR_KERNEL_QUEUE;
+       kernel <= FILTER_FIR_KERNEL_DELAY_LINE; kernel++) {
+    double generalNanoseconds = filterTest_timeFilterFir(kernel, false);
+    double foldedNanoseconds = filterTest_timeFilterFir(kernel, true);
+    filterTest_printFirFolding(kernel, generalNanoseconds, foldedNanoseconds,
+                               filter_setFirFolding(true));
+  }
+  filter_init();
+  for (uint32_t i = 0; i < FIR_FOLDING_BENCHMARK_WINDOW_SIZE; i++)
+    buffer[i] = 2.0 * filterTest_randomValue0To1() - 1.0;
+  for (filter_firKernel_t kernel = FILTER_FIR_KERNEL_SCALAR;
+       kernel < FILTER_FIR_KERNEL_BEST; kernel++) {
+    if (!firKernel_isSupported(kernel))
+      continue;
+    firKernel_install(&general, kernel, filter_getFirCoefficientArray(),
+                      FIXED_TEST_FIR_TAP_COUNT, false);
+    firKernel_install(&folded, kernel, filter_getFirCoefficientArray(),
+                      FIXED_TEST_FIR_TAP_COUNT, true);
+    double generalNanoseconds = filterTest_timeFirKernel(&general, buffer);
+    double foldedNanoseconds = filterTest_timeFirKernel(&folded, buffer);
+    filterTest_printFirFolding(kernel, generalNanoseconds, foldedNanoseconds,
+                               folded.folded);
+  }
+}
+
+// Times filter_addNewInputs() plus the decimated filter_firFilter() calls for
+// each FIR kernel and prints the cost per FIR output, the fastest of
+// FIR_KERNEL_BENCHMARK_RUN_COUNT runs.
+void filterTest_runFirKernelBenchmark(void) {
+  double queueNanoseconds = 0.0;
+  double block[FILTER_FIR_DECIMATION_FACTOR];
+  for (uint32_t i = 0; i < FILTER_FIR_DECIMATION_FACTOR; i++)
+    block[i] = (i & 1) ? 1.0 : -1.0;
+  for (filter_firKernel_t kernel = FILTER_FIR_KERNEL_QUEUE;
+       kernel < FILTER_FIR_KERNEL_BEST; kernel++) {
+    if (kernel > FILTER_FIR_KERNEL_DELAY_LINE && kernel != FILTER_FIR_KERNEL_CIC &&
+        !firKernel_isSupported(kernel))
+      continue;
+    filter_initWithFirKernel(kernel);
+    // As in the detector: the biquads do not need yQueue, and the inputs of
+    // each output come in as a block.
+    filter_setIirStructure(FILTER_IIR_BIQUAD);
+    double fastest = INFINITY;
+    for (uint32_t run = 0; run < FIR_KERNEL_BENCHMARK_RUN_COUNT; run++) {
+      intervalTimer_init(FIR_KERNEL_BENCHMARK_TIMER);
+      intervalTimer_start(FIR_KERNEL_BENCHMARK_TIMER);
+      for (uint32_t n = 0; n < FIR_KERNEL_BENCHMARK_SAMPLE_COUNT;
+           n += FILTER_FIR_DECIMATION_FACTOR) {
+        filter_addNewInputs(block, FILTER_FIR_DECIMATION_FACTOR);
+        filter_firFilter();
+      }
+      intervalTimer_stop(FIR_KERNEL_BENCHMARK_TIMER);
+      fastest = fmin(fastest, intervalTimer_getTotalDurationInSeconds(
+                                  FIR_KERNEL_BENCHMARK_TIMER));
+    }
+    double nanoseconds = fastest * NANOSECONDS_PER_SECOND /
+                         (FIR_KERNEL_BENCHMARK_SAMPLE_COUNT /
+                          FILTER_FIR_DECIMATION_FACTOR);
+    if (kernel == FILTER_FIR_KERNEL_QUEUE)
+      queueNanoseconds = nanoseconds;
+    printf("FIR kernel %-19s %8.1lf ns per output (%.1lfx)\n",
+           firKernel_getName(kernel), nanoseconds,
+           queueNanoseconds / nanoseconds);
+  }
+  filter_init();
+}
+
+/*******************************************************************************
+***** CIC front end test
+*******************************************************************************/
+
+// Largest difference of the CIC front end from the FIR in square-wave power at
+// the player frequencies.
+#define CIC_TEST_MAX_PASSBAND_ERROR_DB 0.5
+// Above the player frequencies the CIC front end may reject aliases by at most
+// this much less than the reference FIR.
+#define CIC_TEST_MAX_STOPBAND_EXCESS_DB 3.0
+
+// Like filterTest_computeSquareWaveFirPower() but averages the power of each test
+// period over every phase of the square wave against the decimation. A square
+// wave at 20 ticks lands on the decimated Nyquist frequency, where a single
+// phase measures anything from zero to the full power depending on the delay
+// of the filter.
+static void filterTest_computeSquareWavePhaseAveragedPower(double power[]) {
+  for (uint16_t i = 0; i < FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT; i++) {
+    uint16_t periodTickCount = filterTest_firTestTickCounts[i];
+    power[i] = 0.0;
+    for (uint16_t phase = 0; phase < FILTER_FIR_DECIMATION_FACTOR; phase++) {
+      for (uint32_t tick = 0; tick < FILTER_TEST_PULSE_WIDTH_LENGTH; tick++) {
+        filter_addNewInput(computeFilterInput((tick + phase) % periodTickCount,
+                                              periodTickCount));
+        if (filterTest_decimatingFirFilter())
+          power[i] += filterTest_lastFirOutput * filterTest_lastFirOutput;
+      }
+    }
+    power[i] /= FILTER_FIR_DECIMATION_FACTOR;
+  }
+}
+
+// Mean power over the player frequencies, the reference for alias rejection.
+static double filterTest_meanPassbandPower(const double power[]) {
+  double sum = 0.0;
+  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+    sum += power[i];
+  return sum / FILTER_FREQUENCY_COUNT;
+}
+
+// Runs square waves through the reference FIR and through the CIC front end
+// and checks that they agree at the player frequencies and that the CIC front
+// end rejects everything above them about as well as the FIR does. Prints both
+// responses at every test period.
+bool filterTest_runCicFrontEndTest(bool printMessageFlag) {
+  double firPower[FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT];
+  double cicPower[FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT];
+  filter_initWithFirKernel(FILTER_FIR_KERNEL_QUEUE);
+  filterTest_computeSquareWavePhaseAveragedPower(firPower);
+  if (filter_initWithFirKernel(FILTER_FIR_KERNEL_CIC) != FILTER_FIR_KERNEL_CIC) {
+    filter_init();
+    return false;
+  }
+  filterTest_computeSquareWavePhaseAveragedPower(cicPower);
+  filter_init();
+
+  double firPassbandPower = filterTest_meanPassbandPower(firPower);
+  double cicPassbandPower = filterTest_meanPassbandPower(cicPower);
+  double worstPassbandError = 0.0;
+  double worstStopbandExcess = -INFINITY;
+  for (uint16_t i = 0; i < FILTER_TEST_FIR_POWER_TEST_PERIOD_COUNT; i++) {
+    double errorDb = 10.0 * log10(cicPower[i] / firPower[i]);
+    // Level relative to the passband, negative in the stopband.
+    double firLevelDb = 10.0 * log10(firPower[i] / firPassbandPower);
+    double cicLevelDb = 10.0 * log10(cicPower[i] / cicPassbandPower);
+    if (i < FILTER_FREQUENCY_COUNT)
+      worstPassbandError = fmax(worstPassbandError, fabs(errorDb));
+    else
+      worstStopbandExcess = fmax(worstStopbandExcess, cicLevelDb - firLevelDb);
+    if (printMessageFlag)
+      printf("%2d ticks (%5.2lf kHz): FIR power %.3le (%+5.1lf dB), CIC power "
+             "%.3le (%+5.1lf dB), %+.2lf dB\n",
+             filterTest_firTestTickCounts[i],
+             (double)FILTER_SAMPLE_FREQUENCY_IN_KHZ /
+                 filterTest_firTestTickCounts[i],
+             firPower[i], firLevelDb, cicPower[i], cicLevelDb, errorDb);
+  }
+  // No output at all would make every comparison NaN.
+  bool success = firPassbandPower > 0.0 && cicPassbandPower > 0.0 &&
+                 worstPassbandError < CIC_TEST_MAX_PASSBAND_ERROR_DB &&
+                 worstStopbandExcess < CIC_TEST_MAX_STOPBAND_EXCESS_DB;
+  if (printMessageFlag)
+    printf("filterTest_runCicFrontEndTest %s (%.3lf dB at worst at the player "
+           "frequencies, at worst %.2lf dB less alias rejection than the "
+           "FIR)\n",
+           success ? "passed" : "failed", worstPassbandError,
+           worstStopbandExcess);
+  return success;
+}
+
+/*******************************************************************************
+***** Biquad IIR test
+*******************************************************************************/
+
+#define BIQUAD_TEST_SAMPLE_COUNT 200000 // 20000 decimated IIR outputs.
+// The direct-form filters are ill-conditioned: their clustered poles are only
+// determined to about 1e-6 by the coefficients, which limits the agreement.
+#define BIQUAD_TEST_MIN_SNR_DB 80.0
+#define BIQUAD_TEST_MAX_POWER_ERROR 1.0E-6
+
+// Runs random input through the biquad cascades and the direct-form double
+// model and checks the SNR of every IIR output and the power values.
+bool filterTest_runBiquadTest(bool printMessageFlag) {
+  bool success = true;
+  if (filter_setIirStructure(FILTER_IIR_BIQUAD) != FILTER_IIR_BIQUAD) {
+    filter_init();
+    return false;
+  }
+  filterTest_resetModels();
+  srand(0);
+  double signal[FILTER_FREQUENCY_COUNT] = {0.0};
+  double noise[FILTER_FREQUENCY_COUNT] = {0.0};
+  bool first = true;
+  for (uint32_t n = 0; n < BIQUAD_TEST_SAMPLE_COUNT; n++) {
+    double x = 2.0 * filterTest_randomValue0To1() - 1.0;
+    filter_addNewInput(x);
+    FIXED_TEST_SHIFT_IN(doubleModelX, x);
+    if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+      continue;
+    filter_firFilter();
+    filterTest_doubleModelFir();
+    for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+      double reference = filterTest_doubleModelIir(i);
+      double error = filter_iirFilter(i) - reference;
+      signal[i] += reference * reference;
+      noise[i] += error * error;
+      filter_computePower(i, first, false);
+    }
+    first = false;
+  }
+  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+    double snr = filterTest_snrInDb(signal[i], noise[i]);
+    // The incremental power must agree with a recomputation from scratch.
+    double power = filter_getCurrentPowerValue(i);
+    double powerError =
+        fabs(filter_computePower(i, true, false) - power) / power;
+    if (printMessageFlag)
+      printf("biquad IIR filter %d SNR: %.1lf dB, power error %.2le\n", i, snr,
+             powerError);
+    if (snr < BIQUAD_TEST_MIN_SNR_DB || powerError > BIQUAD_TEST_MAX_POWER_ERROR)
+      success = false;
+  }
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runBiquadTest %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+/*******************************************************************************
+***** Delay-line test
+*******************************************************************************/
+
+#define DELAY_LINE_TEST_SAMPLE_COUNT 20000
+#define DELAY_LINE_TEST_OUTPUT_COUNT                                           \
+  (DELAY_LINE_TEST_SAMPLE_COUNT / FILTER_FIR_DECIMATION_FACTOR)
+#define DELAY_LINE_BENCHMARK_SAMPLE_COUNT 200000
+
+static double delayLineTestFirOutputs[DELAY_LINE_TEST_OUTPUT_COUNT];
+static double delayLineTestIirOutputs[DELAY_LINE_TEST_OUTPUT_COUNT]
+                                     [FILTER_FREQUENCY_COUNT];
+
+// Runs the same random input through the queue-backed reference filters and
+// the delay-line filters, which add the same products in the same order, so
+// every FIR and IIR output must match bit for bit.
+bool filterTest_runDelayLineTest(bool printMessageFlag) {
+  uint32_t mismatchCount = 0;
+  for (uint32_t pass = 0; pass < 2; pass++) {
+    if (pass == 0) {
+      filter_init();
+    } else {
+      filter_initWithFirKernel(FILTER_FIR_KERNEL_DELAY_LINE);
+      filter_setIirStructure(FILTER_IIR_DELAY_LINE);
+    }
+    srand(0);
+    for (uint32_t n = 0; n < DELAY_LINE_TEST_SAMPLE_COUNT; n++) {
+      filter_addNewInput(2.0 * filterTest_randomValue0To1() - 1.0);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      uint32_t output = n / FILTER_FIR_DECIMATION_FACTOR;
+      double firOutput = filter_firFilter();
+      if (pass == 0)
+        delayLineTestFirOutputs[output] = firOutput;
+      else if (firOutput != delayLineTestFirOutputs[output])
+        mismatchCount++;
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+        double iirOutput = filter_iirFilter(i);
+        if (pass == 0)
+          delayLineTestIirOutputs[output][i] = iirOutput;
+        else if (iirOutput != delayLineTestIirOutputs[output][i])
+          mismatchCount++;
+      }
+    }
+  }
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runDelayLineTest %s (%d mismatched outputs)\n",
+           mismatchCount ? "failed" : "passed", mismatchCount);
+  return mismatchCount == 0;
+}
+
+// Times filter_addNewInput() plus the decimated filter_firFilter() and
+// filter_iirFilter() calls over the queues and over the delay lines and prints
+// the cost per decimated sample.
+void filterTest_runDelayLineBenchmark(void) {
+  double queueNanoseconds = 0.0;
+  for (uint32_t pass = 0; pass < 2; pass++) {
+    if (pass == 0) {
+      filter_init();
+    } else {
+      filter_initWithFirKernel(FILTER_FIR_KERNEL_DELAY_LINE);
+      filter_setIirStructure(FILTER_IIR_DELAY_LINE);
+    }
+    intervalTimer_init(FIR_KERNEL_BENCHMARK_TIMER);
+    intervalTimer_start(FIR_KERNEL_BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < DELAY_LINE_BENCHMARK_SAMPLE_COUNT; n++) {
+      filter_addNewInput((n & 1) ? 1.0 : -1.0);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      filter_firFilter();
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+        filter_iirFilter(i);
+    }
+    intervalTimer_stop(FIR_KERNEL_BENCHMARK_TIMER);
+    double nanoseconds =
+        intervalTimer_getTotalDurationInSeconds(FIR_KERNEL_BENCHMARK_TIMER) *
+        NANOSECONDS_PER_SECOND /
+        (DELAY_LINE_BENCHMARK_SAMPLE_COUNT / FILTER_FIR_DECIMATION_FACTOR);
+    if (pass == 0)
+      queueNanoseconds = nanoseconds;
+    printf("%-10s %8.1lf ns per decimated sample (FIR and filters, %.1lfx)\n",
+           pass ? "delay line" : "queue", nanoseconds,
+           queueNanoseconds / nanoseconds);
+  }
+  filter_init();
+}
+
+/*******************************************************************************
+***** Frequency plan test
+*******************************************************************************/
+
+// Largest relative difference from the MATLAB coefficients.
+#define FREQUENCY_PLAN_MAX_RELATIVE_ERROR 1.0E-10
+// The gain at the player frequency and 100 Hz to either side of it.
+#define FREQUENCY_PLAN_MIN_PASSBAND_GAIN 0.95
+#define FREQUENCY_PLAN_MAX_STOPBAND_GAIN 0.01
+#define FREQUENCY_PLAN_STOPBAND_OFFSET_IN_HZ 100.0
+#define LARGE_PLAN_CHANNEL_COUNT FREQUENCY_PLAN_MAX_CHANNEL_COUNT
+#define LARGE_PLAN_SHORTEST_PERIOD 21 // 4762 Hz, the highest that fits.
+
+// The FIR coefficients that MATLAB's fir1(80, 0.108, 'noscale') gives, which
+// filter.c used to hard-code.
+static const double filterTest_matlabFirCoefficients[] = {
+5.3751585173668532e-04, 4.1057821244099187e-04, 2.3029811615433415e-04, -1.0022421255268634e-05,
+-3.1239220025873498e-04, -6.6675539469892989e-04, -1.0447674325821804e-03, -1.3967861519587053e-03,
+-1.6537303925483089e-03, -1.7346382015025667e-03, -1.5596484449522630e-03, -1.0669170920384048e-03,
+-2.3088291222664008e-04, 9.2146384892950099e-04, 2.2999023467067978e-03, 3.7491095163012366e-03,
+5.0578112742500408e-03, 5.9796411037508039e-03, 6.2645305736409576e-03, 5.6975395969924630e-03,
+4.1403678436423832e-03, 1.5696670848600943e-03, -1.8940691237627923e-03, -5.9726960144609528e-03,
+-1.0235869785695425e-02, -1.4127694707478473e-02, -1.7013744396319821e-02, -1.8244737113263923e-02,
+-1.7230507462687290e-02, -1.3515937014932726e-02, -6.8495092580338254e-03, 2.7646568253820039e-03,
+1.5039019355364032e-02, 2.9404269200373489e-02, 4.5042275861018187e-02, 6.0948410493762414e-02,
+7.6017645500231018e-02, 8.9145705550443280e-02, 9.9334411853457705e-02, 1.0578952596388017e-01,
+1.0800000000000000e-01, 1.0578952596388017e-01, 9.9334411853457705e-02, 8.9145705550443280e-02,
+7.6017645500231018e-02, 6.0948410493762414e-02, 4.5042275861018187e-02, 2.9404269200373489e-02,
+1.5039019355364032e-02, 2.7646568253820039e-03, -6.8495092580338254e-03, -1.3515937014932726e-02,
+-1.7230507462687290e-02, -1.8244737113263923e-02, -1.7013744396319821e-02, -1.4127694707478473e-02,
+-1.0235869785695425e-02, -5.9726960144609528e-03, -1.8940691237627923e-03, 1.5696670848600943e-03,
+4.1403678436423832e-03, 5.6975395969924630e-03, 6.2645305736409576e-03, 5.9796411037508039e-03,
+5.0578112742500408e-03, 3.7491095163012366e-03, 2.2999023467067978e-03, 9.2146384892950099e-04,
+-2.3088291222664008e-04, -1.0669170920384048e-03, -1.5596484449522630e-03, -1.7346382015025667e-03,
+-1.6537303925483089e-03, -1.3967861519587053e-03, -1.0447674325821804e-03, -6.6675539469892989e-04,
+-3.1239220025873498e-04, -1.0022421255268634e-05, 2.3029811615433415e-04, 4.1057821244099187e-04,
+5.3751585173668532e-04};
+
+// The IIR coefficients that MATLAB's butter() gives for the default plan,
+// which filter.c used to hard-code.
+static const double
+    filterTest_matlabIirACoefficients[FILTER_FREQUENCY_COUNT]
+                                     [FREQUENCY_PLAN_BANDPASS_ORDER] = {
+{-5.9637727070164059e+00, 1.9125339333078287e+01, -4.0341474540744301e+01, 6.1537466875369077e+01, -7.0019717951472558e+01, 6.0298814235239249e+01, -3.8733792862566574e+01, 1.7993533279581207e+01, -5.4979061224868158e+00, 9.0332828533800469e-01},
+{-4.6377947119071408e+00, 1.3502215749461552e+01, -2.6155952405269698e+01, 3.8589668330738235e+01, -4.3038990303252490e+01, 3.7812927599536991e+01, -2.5113598088113683e+01, 1.2703182701888030e+01, -4.2755083391143280e+00, 9.0332828533799747e-01},
+{-3.0591317915750937e+00, 8.6417489609637492e+00, -1.4278790253808838e+01, 2.1302268283304294e+01, -2.2193853972079211e+01, 2.0873499791105424e+01, -1.3709764520609379e+01, 8.1303553577931567e+00, -2.8201643879900473e+00, 9.0332828533799880e-01},
+{-1.4071749185996751e+00, 5.6904141470697542e+00, -5.7374718273676306e+00, 1.1958028362868905e+01, -8.5435280598354630e+00, 1.1717345583835968e+01, -5.5088290876998647e+00, 5.3536787286077674e+00, -1.2972519209655595e+00, 9.0332828533800047e-01},
+{8.2010906117760318e-01, 5.1673756579268604e+00, 3.2580350909220925e+00, 1.0392903763919193e+01, 4.8101776408669084e+00, 1.0183724507092508e+01, 3.1282000712126754e+00, 4.8615933365571991e+00, 7.5604535083144919e-01, 9.0332828533800047e-01},
+{2.7080869856154530e+00, 7.8319071217995795e+00, 1.2201607990980769e+01, 1.8651500443681677e+01, 1.8758157568004620e+01, 1.8276088095999114e+01, 1.1715361303018966e+01, 7.3684394621254015e+00, 2.4965418284512091e+00, 9.0332828533801224e-01},
+{4.9479835250075892e+00, 1.4691607003177602e+01, 2.9082414772101060e+01, 4.3179839108869331e+01, 4.8440791644688879e+01, 4.2310703962394342e+01, 2.7923434247706432e+01, 1.3822186510471010e+01, 4.5614664160654357e+00, 9.0332828533799958e-01},
+{6.1701893352279864e+00, 2.0127225876810336e+01, 4.2974193398071691e+01, 6.5958045321253465e+01, 7.5230437667866624e+01, 6.4630411355739881e+01, 4.1261591079244141e+01, 1.8936128791950541e+01, 5.6881982915180327e+00, 9.0332828533799836e-01},
+{7.4092912870072398e+00, 2.6857944460290135e+01, 6.1578787811202247e+01, 9.8258255839887340e+01, 1.1359460153696304e+02, 9.6280452143026153e+01, 5.9124742025776442e+01, 2.5268527576524235e+01, 6.8305064480743178e+00, 9.0332828533800158e-01},
+{8.5743055776347692e+00, 3.4306584753117903e+01, 8.4035290411037124e+01, 1.3928510844056831e+02, 1.6305115418161643e+02, 1.3648147221895812e+02, 8.0686288623299902e+01, 3.2276361903872186e+01, 7.9045143816244918e+00, 9.0332828533799903e-01}
+};
+
+static const double
+    filterTest_matlabIirBCoefficients[FILTER_FREQUENCY_COUNT]
+                                     [FREQUENCY_PLAN_BANDPASS_ORDER + 1] = {
+{9.0928661148176830e-10, 0.0000000000000000e+00, -4.5464330574088414e-09, 0.0000000000000000e+00, 9.0928661148176828e-09, 0.0000000000000000e+00, -9.0928661148176828e-09, 0.0000000000000000e+00, 4.5464330574088414e-09, 0.0000000000000000e+00, -9.0928661148176830e-10},
+{9.0928661148203093e-10, 0.0000000000000000e+00, -4.5464330574101550e-09, 0.0000000000000000e+00, 9.0928661148203099e-09, 0.0000000000000000e+00, -9.0928661148203099e-09, 0.0000000000000000e+00, 4.5464330574101550e-09, 0.0000000000000000e+00, -9.0928661148203093e-10},
+{9.0928661148196858e-10, 0.0000000000000000e+00, -4.5464330574098431e-09, 0.0000000000000000e+00, 9.0928661148196862e-09, 0.0000000000000000e+00, -9.0928661148196862e-09, 0.0000000000000000e+00, 4.5464330574098431e-09, 0.0000000000000000e+00, -9.0928661148196858e-10},
+{9.0928661148203424e-10, 0.0000000000000000e+00, -4.5464330574101715e-09, 0.0000000000000000e+00, 9.0928661148203430e-09, 0.0000000000000000e+00, -9.0928661148203430e-09, 0.0000000000000000e+00, 4.5464330574101715e-09, 0.0000000000000000e+00, -9.0928661148203424e-10},
+{9.0928661148203041e-10, 0.0000000000000000e+00, -4.5464330574101516e-09, 0.0000000000000000e+00, 9.0928661148203033e-09, 0.0000000000000000e+00, -9.0928661148203033e-09, 0.0000000000000000e+00, 4.5464330574101516e-09, 0.0000000000000000e+00, -9.0928661148203041e-10},
+{9.0928661148164309e-10, 0.0000000000000000e+00, -4.5464330574082152e-09, 0.0000000000000000e+00, 9.0928661148164304e-09, 0.0000000000000000e+00, -9.0928661148164304e-09, 0.0000000000000000e+00, 4.5464330574082152e-09, 0.0000000000000000e+00, -9.0928661148164309e-10},
+{9.0928661148193684e-10, 0.0000000000000000e+00, -4.5464330574096843e-09, 0.0000000000000000e+00, 9.0928661148193686e-09, 0.0000000000000000e+00, -9.0928661148193686e-09, 0.0000000000000000e+00, 4.5464330574096843e-09, 0.0000000000000000e+00, -9.0928661148193684e-10},
+{9.0928661148192133e-10, 0.0000000000000000e+00, -4.5464330574096065e-09, 0.0000000000000000e+00, 9.0928661148192131e-09, 0.0000000000000000e+00, -9.0928661148192131e-09, 0.0000000000000000e+00, 4.5464330574096065e-09, 0.0000000000000000e+00, -9.0928661148192133e-10},
+{9.0928661148181700e-10, 0.0000000000000000e+00, -4.5464330574090846e-09, 0.0000000000000000e+00, 9.0928661148181692e-09, 0.0000000000000000e+00, -9.0928661148181692e-09, 0.0000000000000000e+00, 4.5464330574090846e-09, 0.0000000000000000e+00, -9.0928661148181700e-10},
+{9.0928661148189248e-10, 0.0000000000000000e+00, -4.5464330574094626e-09, 0.0000000000000000e+00, 9.0928661148189252e-09, 0.0000000000000000e+00, -9.0928661148189252e-09, 0.0000000000000000e+00, 4.5464330574094626e-09, 0.0000000000000000e+00, -9.0928661148189248e-10}
+};
+
+// Returns |H| of the direct-form filter b/a at frequency (Hz) at the
+// decimated sample rate.
+static double filterTest_iirGain(const double b[], const double a[],
+                                 double frequency) {
+  double complex zInverse =
+      cexp(-I * 2.0 * M_PI * frequency / FREQUENCY_PLAN_SAMPLE_FREQUENCY_IN_HZ);
+  double complex numerator = 0.0;
+  double complex denominator = 1.0;
+  double complex power = 1.0;
+  for (uint16_t i = 0; i <= FREQUENCY_PLAN_BANDPASS_ORDER; i++) {
+    numerator += b[i] * power;
+    power *= zInverse;
+    if (i < FREQUENCY_PLAN_BANDPASS_ORDER)
+      denominator += a[i] * power;
+  }
+  return cabs(numerator / denominator);
+}
+
+// Checks that the coefficient tables generated at build time for the default
+// plan match MATLAB and that frequencyPlan.c synthesizes the same filters at
+// run time, then that a 32-frequency plan gives 32 bandpass filters that
+// pass their own frequency, reject 100 Hz away, and factor into biquads.
+// Finally checks that plans that cannot be synthesized are rejected.
+bool filterTest_runFrequencyPlanTest(bool printMessageFlag) {
+  bool success = true;
+  double worstError = 0.0;
+  filter_init();
+  success &= frequencyPlan_isDefault();
+  const double *fir = filter_getFirCoefficientArray();
+  for (uint32_t i = 0; i < filter_getFirCoefficientCount(); i++)
+    worstError = fmax(worstError,
+                      fabs(fir[i] - filterTest_matlabFirCoefficients[i]) /
+                          fabs(filterTest_matlabFirCoefficients[i]));
+  double worstSynthesisError = 0.0;
+  for (uint16_t filter = 0; filter < FILTER_FREQUENCY_COUNT; filter++) {
+    const double *a = filter_getIirACoefficientArray(filter);
+    const double *b = filter_getIirBCoefficientArray(filter);
+    double synthesizedA[FREQUENCY_PLAN_BANDPASS_ORDER];
+    double synthesizedB[FREQUENCY_PLAN_BANDPASS_ORDER + 1];
+    frequencyPlan_synthesizeBandpass(filter_frequencyTickTable[filter],
+                                     synthesizedB, synthesizedA);
+    for (uint16_t i = 0; i <= FREQUENCY_PLAN_BANDPASS_ORDER; i++) {
+      worstSynthesisError =
+          fmax(worstSynthesisError, fabs(synthesizedB[i] - b[i]) / fabs(b[0]));
+      if (i < FREQUENCY_PLAN_BANDPASS_ORDER)
+        worstSynthesisError = fmax(worstSynthesisError,
+                                   fabs(synthesizedA[i] - a[i]) / fabs(a[i]));
+    }
+    for (uint16_t i = 0; i <= FREQUENCY_PLAN_BANDPASS_ORDER; i++) {
+      double expected = filterTest_matlabIirBCoefficients[filter][i];
+      double error = fabs(b[i] - expected);
+      if (expected != 0.0)
+        error /= fabs(expected);
+      worstError = fmax(worstError, error);
+      if (i == FREQUENCY_PLAN_BANDPASS_ORDER)
+        continue;
+      expected = filterTest_matlabIirACoefficients[filter][i];
+      worstError = fmax(worstError, fabs(a[i] - expected) / fabs(expected));
+    }
+  }
+  success &= worstError < FREQUENCY_PLAN_MAX_RELATIVE_ERROR &&
+             worstSynthesisError < FREQUENCY_PLAN_MAX_RELATIVE_ERROR;
+  if (printMessageFlag)
+    printf("default plan: largest relative difference from MATLAB %.2e, "
+           "from run-time synthesis %.2e\n",
+           worstError, worstSynthesisError);
+
+  uint16_t periods[LARGE_PLAN_CHANNEL_COUNT];
+  for (uint16_t i = 0; i < LARGE_PLAN_CHANNEL_COUNT; i++)
+    periods[i] = LARGE_PLAN_SHORTEST_PERIOD + i;
+  success &= frequencyPlan_set(periods, LARGE_PLAN_CHANNEL_COUNT);
+  filter_init();
+  success &= filter_getFrequencyCount() == LARGE_PLAN_CHANNEL_COUNT;
+  double worstPassband = INFINITY;
+  double worstStopband = 0.0;
+  for (uint16_t filter = 0; filter < filter_getFrequencyCount(); filter++) {
+    const double *a = filter_getIirACoefficientArray(filter);
+    const double *b = filter_getIirBCoefficientArray(filter);
+    double center = round(FILTER_SAMPLE_FREQUENCY_IN_KHZ * 1000.0 /
+                          frequencyPlan_getTickPeriod(filter));
+    worstPassband = fmin(worstPassband, filterTest_iirGain(b, a, center));
+    for (int16_t side = -1; side <= 1; side += 2)
+      worstStopband = fmax(
+          worstStopband,
+          filterTest_iirGain(b, a,
+                             center + side * FREQUENCY_PLAN_STOPBAND_OFFSET_IN_HZ));
+  }
+  bool factored = filter_setIirStructure(FILTER_IIR_BIQUAD) == FILTER_IIR_BIQUAD;
+  success &= worstPassband > FREQUENCY_PLAN_MIN_PASSBAND_GAIN &&
+             worstStopband < FREQUENCY_PLAN_MAX_STOPBAND_GAIN && factored;
+  if (printMessageFlag)
+    printf("%d-frequency plan: gain %.4lf or more at the player frequencies, "
+           "%.2e or less 100 Hz away, biquads %s\n",
+           LARGE_PLAN_CHANNEL_COUNT, worstPassband, worstStopband,
+           factored ? "ok" : "failed");
+
+  uint16_t tooShort = LARGE_PLAN_SHORTEST_PERIOD - 1;
+  success &= !frequencyPlan_set(&tooShort, 1);
+  success &= !frequencyPlan_set(periods, 0);
+  success &= !frequencyPlan_set(periods, FREQUENCY_PLAN_MAX_CHANNEL_COUNT + 1);
+  success &= frequencyPlan_getChannelCount() == LARGE_PLAN_CHANNEL_COUNT;
+
+  frequencyPlan_set(filter_frequencyTickTable, FILTER_FREQUENCY_COUNT);
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runFrequencyPlanTest %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+/*******************************************************************************
+***** IIR bank test
+*******************************************************************************/
+
+#define IIR_BANK_TEST_SAMPLE_COUNT 20000
+#define IIR_BANK_TEST_OUTPUT_COUNT                                             \
+  (IIR_BANK_TEST_SAMPLE_COUNT / FILTER_FIR_DECIMATION_FACTOR)
+#define IIR_BANK_BENCHMARK_SAMPLE_COUNT 200000
+
+static double iirBankTestPowerValues[IIR_BANK_TEST_OUTPUT_COUNT]
+                                    [FILTER_FREQUENCY_COUNT];
+
+// Runs the biquad filters and power one filter at a time, then through
+// filter_iirFilterBank(), on the same random input. The bank does the same
+// arithmetic, so every output and power value must match bit for bit. Then
+// prints the time per decimated sample of both.
+bool filterTest_runIirBankTest(bool printMessageFlag) {
+  uint32_t mismatchCount = 0;
+  for (uint32_t bank = 0; bank < 2; bank++) {
+    filter_initWithFirKernel(FILTER_FIR_KERNEL_BEST);
+    if (filter_setIirStructure(FILTER_IIR_BIQUAD) != FILTER_IIR_BIQUAD) {
+      filter_init();
+      return false;
+    }
+    srand(0);
+    for (uint32_t n = 0; n < IIR_BANK_TEST_SAMPLE_COUNT; n++) {
+      filter_addNewInput(2.0 * filterTest_randomValue0To1() - 1.0);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      uint32_t output = n / FILTER_FIR_DECIMATION_FACTOR;
+      bool first = output == 0;
+      filter_firFilter();
+      if (bank) {
+        filter_iirFilterBank(first);
+      } else {
+        for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+          filter_iirFilter(i);
+          filter_computePower(i, first, false);
+        }
+      }
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+        double power = filter_getCurrentPowerValue(i);
+        if (!bank)
+          iirBankTestPowerValues[output][i] = power;
+        else if (power != iirBankTestPowerValues[output][i])
+          mismatchCount++;
+      }
+    }
+  }
+
+  double filterNanoseconds = 0.0;
+  for (uint32_t bank = 0; bank < 2; bank++) {
+    filter_initWithFirKernel(FILTER_FIR_KERNEL_BEST);
+    filter_setIirStructure(FILTER_IIR_BIQUAD);
+    intervalTimer_init(FIR_KERNEL_BENCHMARK_TIMER);
+    intervalTimer_start(FIR_KERNEL_BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < IIR_BANK_BENCHMARK_SAMPLE_COUNT; n++) {
+      filter_addNewInput((n & 1) ? 1.0 : -1.0);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      bool first = n + 1 == FILTER_FIR_DECIMATION_FACTOR;
+      filter_firFilter();
+      if (bank) {
+        filter_iirFilterBank(first);
+      } else {
+        for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+          filter_iirFilter(i);
+          filter_computePower(i, first, false);
+        }
+      }
+    }
+    intervalTimer_stop(FIR_KERNEL_BENCHMARK_TIMER);
+    double nanoseconds =
+        intervalTimer_getTotalDurationInSeconds(FIR_KERNEL_BENCHMARK_TIMER) *
+        NANOSECONDS_PER_SECOND /
+        (IIR_BANK_BENCHMARK_SAMPLE_COUNT / FILTER_FIR_DECIMATION_FACTOR);
+    if (!bank)
+      filterNanoseconds = nanoseconds;
+    printf("biquad %-11s %8.1lf ns per decimated sample (FIR, filters and "
+           "power, %.1lfx)\n",
+           bank ? "bank" : "per filter", nanoseconds,
+           filterNanoseconds / nanoseconds);
+  }
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runIirBankTest %s (%d mismatched power values)\n",
+           mismatchCount ? "failed" : "passed", mismatchCount);
+  return mismatchCount == 0;
+}
+
+/*******************************************************************************
+***** Power tracker test
+*******************************************************************************/
+
+#define POWER_TRACKER_TEST_WINDOW 2000 // Same as OUTPUT_QUEUE_SIZE.
+// One hour of decimated samples at 10 kHz.
+#define POWER_TRACKER_TEST_SAMPLE_COUNT (3600UL * 10000UL)
+// Loud bursts followed by quiet stretches, which is what makes the cancellation
+// in prev - oldest^2 + newest^2 lose precision.
+#define POWER_TRACKER_TEST_BURST_PERIOD 20000
+#define POWER_TRACKER_TEST_BURST_LENGTH 2000
+#define POWER_TRACKER_TEST_LOUD_AMPLITUDE 1.0
+#define POWER_TRACKER_TEST_QUIET_AMPLITUDE 1.0E-3
+#define POWER_TRACKER_TEST_FILTER_SAMPLE_COUNT 100000
+// Every square is rounded to single precision (within 2^-24 of it) and to a
+// multiple of 2^-44.
+#define POWER_TRACKER_TEST_MAX_ERROR(power)                                    \
+  ((power) / (1 << 24) + POWER_TRACKER_TEST_WINDOW / POWER_TRACKER_SCALE)
+
+static float powerTrackerTestSquares[POWER_TRACKER_TEST_WINDOW];
+static double powerTrackerTestWindow[POWER_TRACKER_TEST_WINDOW];
+static const uint32_t powerTrackerTestShortWindows[] = {1, 250, 1999};
+#define POWER_TRACKER_TEST_SHORT_WINDOW_COUNT                                  \
+  (sizeof(powerTrackerTestShortWindows) /                                      \
+   sizeof(powerTrackerTestShortWindows[0]))
+static double powerTrackerTestPowerValues[POWER_TRACKER_TEST_FILTER_SAMPLE_COUNT /
+                                          FILTER_FIR_DECIMATION_FACTOR]
+                                         [FILTER_FREQUENCY_COUNT];
+
+// Runs an hour of bursty input through a power tracker and through the
+// double-precision prev - oldest^2 + newest^2 update, and compares both with
+// the power of the final window. Then runs the filters with each power method
+// and checks that the tracked power stays within rounding of the reference.
+bool filterTest_runPowerTrackerTest(bool printMessageFlag) {
+  bool success = true;
+  powerTracker_t tracker;
+  powerTracker_init(&tracker, powerTrackerTestSquares,
+                    POWER_TRACKER_TEST_WINDOW);
+  powerTracker_setShortWindows(&tracker, powerTrackerTestShortWindows,
+                               POWER_TRACKER_TEST_SHORT_WINDOW_COUNT);
+  memset(powerTrackerTestWindow, 0, sizeof(powerTrackerTestWindow));
+  double incrementalPower = 0.0;
+  uint32_t index = 0;
+  srand(0);
+  for (uint32_t n = 0; n < POWER_TRACKER_TEST_SAMPLE_COUNT; n++) {
+    double amplitude =
+        (n % POWER_TRACKER_TEST_BURST_PERIOD) < POWER_TRACKER_TEST_BURST_LENGTH
+            ? POWER_TRACKER_TEST_LOUD_AMPLITUDE
+            : POWER_TRACKER_TEST_QUIET_AMPLITUDE;
+    double value = amplitude * (2.0 * filterTest_randomValue0To1() - 1.0);
+    double oldest = powerTrackerTestWindow[index];
+    incrementalPower = incrementalPower - oldest * oldest + value * value;
+    powerTrackerTestWindow[index] = value;
+    if (++index == POWER_TRACKER_TEST_WINDOW)
+      index = 0;
+    powerTracker_add(&tracker, value);
+  }
+  double exactPower = 0.0;
+  int64_t squareSum = 0;
+  for (uint32_t i = 0; i < POWER_TRACKER_TEST_WINDOW; i++) {
+    exactPower += powerTrackerTestWindow[i] * powerTrackerTestWindow[i];
+    squareSum += powerTracker_toFixed(powerTrackerTestSquares[i]);
+  }
+  double trackerError = fabs(powerTracker_getPower(&tracker) - exactPower);
+  // The short windows must equal the sum of their newest squares, exactly.
+  for (uint32_t w = 0; w < POWER_TRACKER_TEST_SHORT_WINDOW_COUNT; w++) {
+    int64_t shortSum = 0;
+    for (uint32_t i = 1; i <= powerTrackerTestShortWindows[w]; i++)
+      shortSum += powerTracker_toFixed(
+          powerTrackerTestSquares[(tracker.index + POWER_TRACKER_TEST_WINDOW -
+                                   i) %
+                                  POWER_TRACKER_TEST_WINDOW]);
+    if (shortSum != tracker.shortWindowSums[w])
+      success = false;
+  }
+  // The running sum must equal the sum of the squares it holds, exactly.
+  if (squareSum != tracker.sum ||
+      trackerError > POWER_TRACKER_TEST_MAX_ERROR(exactPower))
+    success = false;
+  if (printMessageFlag)
+    printf("power after one hour %.6le: tracker error %.2le (relative %.2le), "
+           "incremental error %.2le (relative %.2le)\n",
+           exactPower, trackerError, trackerError / exactPower,
+           fabs(incrementalPower - exactPower),
+           fabs(incrementalPower - exactPower) / exactPower);
+
+  for (filter_powerMethod_t method = FILTER_POWER_INCREMENTAL;
+       method <= FILTER_POWER_TRACKER; method++) {
+    filter_initWithFirKernel(FILTER_FIR_KERNEL_BEST);
+    filter_setIirStructure(FILTER_IIR_BIQUAD);
+    filter_setPowerMethod(method);
+    // The trackers replace the output queues, which must not be allocated.
+    if ((filter_getIirOutputQueue(0)->data == NULL) !=
+        (method == FILTER_POWER_TRACKER))
+      success = false;
+    srand(0);
+    for (uint32_t n = 0; n < POWER_TRACKER_TEST_FILTER_SAMPLE_COUNT; n++) {
+      filter_addNewInput(2.0 * filterTest_randomValue0To1() - 1.0);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      uint32_t output = n / FILTER_FIR_DECIMATION_FACTOR;
+      filter_firFilter();
+      filter_iirFilterBank(output == 0);
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+        double power = filter_getCurrentPowerValue(i);
+        if (method == FILTER_POWER_INCREMENTAL)
+          powerTrackerTestPowerValues[output][i] = power;
+        else if (fabs(power - powerTrackerTestPowerValues[output][i]) >
+                 POWER_TRACKER_TEST_MAX_ERROR(power) +
+                     power * TEST_FILTER_FLOATING_POINT_EPSILON)
+          success = false;
+      }
+    }
+  }
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runPowerTrackerTest %s\n",
+           success ? "passed" : "failed");
+  return success;
+}
+
+/*******************************************************************************
+***** IIR structure comparison
+*******************************************************************************/
+
+#define IIR_STRUCTURE_COUNT (FILTER_IIR_SLIDING_DFT + 1)
+#define IIR_STRUCTURE_BENCHMARK_SAMPLE_COUNT 200000
+// Minimum ratio of the hit power to the median power, in dB: well above the
+// detector's fudge factor of 190 (22.8 dB).
+#define IIR_STRUCTURE_MIN_SELECTIVITY_DB 30.0
+
+static const char *filterTest_iirStructureName(filter_iirStructure_t structure) {
+  switch (structure) {
+  case FILTER_IIR_DIRECT_FORM:
+    return "direct form";
+  case FILTER_IIR_DELAY_LINE:
+    return "delay line";
+  case FILTER_IIR_BIQUAD:
+    return "biquad";
+  default:
+    return "sliding DFT";
+  }
+}
+
+// Runs filter_addNewInput() through filter_computePower() the way detector()
+// does, with the fastest FIR kernel, for one pulse-width of a square wave at
+// each player frequency. Every structure must detect the right frequency with
+// a large margin; the power at the hit frequency and the selectivity (hit power
+// over median power) are printed for comparison. Then prints the time per
+// decimated sample of each structure.
+bool filterTest_runIirStructureComparison(bool printMessageFlag) {
+  bool success = true;
+  for (uint16_t freq = 0; freq < FILTER_FREQUENCY_COUNT; freq++) {
+    uint16_t period = filter_frequencyTickTable[freq];
+    for (filter_iirStructure_t structure = FILTER_IIR_DIRECT_FORM;
+         structure < IIR_STRUCTURE_COUNT; structure++) {
+      filter_initWithFirKernel(FILTER_FIR_KERNEL_BEST);
+      filter_setIirStructure(structure);
+      bool first = true;
+      for (uint32_t n = 0; n < FILTER_TEST_PULSE_WIDTH_LENGTH; n++) {
+        filter_addNewInput(computeFilterInput(n % period, period));
+        if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+          continue;
+        filter_firFilter();
+        for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+          filter_iirFilter(i);
+          filter_computePower(i, first, false);
+        }
+        first = false;
+      }
+      double power[FILTER_FREQUENCY_COUNT];
+      double sorted[FILTER_FREQUENCY_COUNT];
+      filter_getCurrentPowerValues(power);
+      memcpy(sorted, power, sizeof(sorted));
+      qsort(sorted, FILTER_FREQUENCY_COUNT, sizeof(sorted[0]),
+            filterTest_compareDoubles);
+      double selectivity =
+          10.0 * log10(power[freq] / sorted[FIXED_TEST_MEDIAN_INDEX]);
+      int16_t hit = filterTest_hitDecision(power);
+      if (hit != freq || selectivity < IIR_STRUCTURE_MIN_SELECTIVITY_DB)
+        success = false;
+      if (printMessageFlag)
+        printf("frequency %d %-11s: hit on %2d, power %8.1lf, selectivity "
+               "%5.1lf dB\n",
+               freq, filterTest_iirStructureName(structure), hit, power[freq],
+               selectivity);
+    }
+  }
+
+  for (filter_iirStructure_t structure = FILTER_IIR_DIRECT_FORM;
+       structure < IIR_STRUCTURE_COUNT; structure++) {
+    filter_initWithFirKernel(FILTER_FIR_KERNEL_BEST);
+    filter_setIirStructure(structure);
+    intervalTimer_init(FIR_KERNEL_BENCHMARK_TIMER);
+    intervalTimer_start(FIR_KERNEL_BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < IIR_STRUCTURE_BENCHMARK_SAMPLE_COUNT; n++) {
+      filter_addNewInput((n & 1) ? 1.0 : -1.0);
+      if ((n + 1) % FILTER_FIR_DECIMATION_FACTOR)
+        continue;
+      filter_firFilter();
+      for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+        filter_iirFilter(i);
+        filter_computePower(i, n + 1 == FILTER_FIR_DECIMATION_FACTOR, false);
+      }
+    }
+    intervalTimer_stop(FIR_KERNEL_BENCHMARK_TIMER);
+    printf("%-11s %8.1lf ns per decimated sample (FIR, filters and power)\n",
+           filterTest_iirStructureName(structure),
+           intervalTimer_getTotalDurationInSeconds(FIR_KERNEL_BENCHMARK_TIMER) *
+               NANOSECONDS_PER_SECOND /
+               (IIR_STRUCTURE_BENCHMARK_SAMPLE_COUNT /
+                FILTER_FIR_DECIMATION_FACTOR));
+  }
+  filter_init();
+  if (printMessageFlag)
+    printf("filterTest_runIirStructureComparison %s\n",
+           success ? "passed" : "failed");
+  return success;
+}
+
 // Copies powerValues to currentPowerValues, the same array
 // that is used to hold the values after power has been computed
 // by filter_computePower().
@@ -980,11 +2332,42 @@ bool filter_runTest(void) {
   bool success = true; // Be optimistic.
   filter_init();       // Always must init stuff.
   filterTest_init();   // More init stuff.
+  // Compare the synthesized IIR coefficients with the MATLAB design.
+  success &= filterTest_runFrequencyPlanTest(PRINT_INFO_MESSAGES);
+  // Compare the fixed-point engine with the double-precision filters.
+  success &= filterTest_runFixedPointTest(PRINT_INFO_MESSAGES);
+#ifdef FILTER_FIXED_POINT
+  // The remaining tests check the double-precision engine and its FIR kernels,
+  // which the fixed-point engine does not use.
+  return success;
+#endif
+  // Compare the filters, in the sample precision of the build, with the
+  // double-precision model.
+  success &= filterTest_runPrecisionTest(PRINT_INFO_MESSAGES);
+  // Compare the vectorized FIR kernels with the double-precision FIR.
+  success &= filterTest_runFirKernelTest(PRINT_INFO_MESSAGES);
+  success &= filterTest_runFirFoldingTest(PRINT_INFO_MESSAGES);
+  filterTest_runFirKernelBenchmark();
+  filterTest_runFirFoldingBenchmark();
+  // Compare the delay-line filters with the queue-backed filters.
+  success &= filterTest_runDelayLineTest(PRINT_INFO_MESSAGES);
+  filterTest_runDelayLineBenchmark();
+  // Compare the CIC front end with the FIR.
+  success &= filterTest_runCicFrontEndTest(PRINT_INFO_MESSAGES);
+  // Compare the biquad IIR filters with the direct-form IIR filters.
+  success &= filterTest_runBiquadTest(PRINT_INFO_MESSAGES);
+  // Compare the lockstep biquad bank with the filters run one at a time.
+  success &= filterTest_runIirBankTest(PRINT_INFO_MESSAGES);
+  // Compare the drift-free power tracker with the incremental power.
+  success &= filterTest_runPowerTrackerTest(PRINT_INFO_MESSAGES);
+  // Compare accuracy and speed of all of the IIR structures.
+  success &= filterTest_runIirStructureComparison(PRINT_INFO_MESSAGES);
   // Confirm that the FIR coefficients are properly aligned with the incoming
   // data.
   success &= filterTest_runFirAlignmentTest(PRINT_INFO_MESSAGES);
   // Confirm that the FIR properly computes its output.
   success &= filterTest_runFirArithmeticTest(PRINT_INFO_MESSAGES);
+#ifndef FILTER_SINGLE_PRECISION // No direct-form filters, see filter.h.
   // Confirm that the IIR A coefficients are properly aligned with the incoming
   // data.
   success &= filterTest_runIirAAlignmentTest(TEST_IIR_FILTER_NUMBER,
@@ -993,6 +2376,7 @@ bool filter_runTest(void) {
   // data.
   success &= filterTest_runIirBAlignmentTest(TEST_IIR_FILTER_NUMBER,
                                              PRINT_INFO_MESSAGES);
+#endif
   // Verifies correct functionality of the power computation.
   success &= filterTest_runPowerTest();
   // Plots the frequency response of the FIR filter against all user and other
@@ -50,7 +50,8 @@ const static uint16_t histogram_defaultBarColors[HISTOGRAM_MAX_BAR_COUNT] = {
     DISPLAY_GREEN,   DISPLAY_CYAN,   DISPLAY_MAGENTA, DISPLAY_YELLOW,
     DISPLAY_WHITE,   DISPLAY_BLUE,   DISPLAY_RED,     DISPLAY_GREEN,
     DISPLAY_BLUE,    DISPLAY_RED,    DISPLAY_GREEN,   DISPLAY_CYAN,
-    DISPLAY_MAGENTA};
+    DISPLAY_MAGENTA, DISPLAY_YELLOW, DISPLAY_WHITE,   DISPLAY_BLUE,
+    DISPLAY_RED,     DISPLAY_GREEN,  DISPLAY_CYAN,    DISPLAY_MAGENTA};
 static uint16_t histogram_barColors[HISTOGRAM_MAX_BAR_COUNT];
 // Default colors for the white dynamic labels.
 const static uint16_t
@@ -61,7 +62,8 @@ const static uint16_t
         DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE,
         DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE,
         DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE,
-        DISPLAY_WHITE};
+        DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE,
+        DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE, DISPLAY_WHITE};
 static uint16_t histogram_barTopLabelColors[HISTOGRAM_MAX_BAR_COUNT];
 // Default labels for the histogram bars.
 // These labels do not change during operation.
@@ -71,7 +73,9 @@ const static char histogram_defaultLabel[HISTOGRAM_MAX_BAR_COUNT]
                                             {"5"}, {"6"}, {"7"}, {"8"}, {"9"},
                                             {"A"}, {"B"}, {"C"}, {"D"}, {"E"},
                                             {"F"}, {"G"}, {"H"}, {"I"}, {"J"},
-                                            {"K"}, {"L"}, {"M"}, {"N"}, {"O"}};
+                                            {"K"}, {"L"}, {"M"}, {"N"}, {"O"},
+                                            {"P"}, {"Q"}, {"R"}, {"S"}, {"T"},
+                                            {"U"}, {"V"}};
 static char histogram_label[HISTOGRAM_MAX_BAR_COUNT]
                            [HISTOGRAM_MAX_BAR_LABEL_WIDTH];
 
@@ -370,12 +374,13 @@ void histogram_normalizePowerValues(double normalizedValues[],
     normalizedValues[i] = origValues[i] / maxValue;
 }
 
-// Used to plot the power response for user frequencies 0-9.
+// Used to plot the power response for every user frequency in the frequency
+// plan.
 void histogram_plotUserFrequencyPower(double powerValues[]) {
-  double normalizedPowerValues[FILTER_FREQUENCY_COUNT];
+  double normalizedPowerValues[FILTER_MAX_FREQUENCY_COUNT];
   histogram_normalizePowerValues(normalizedPowerValues, powerValues,
-                                 FILTER_FREQUENCY_COUNT);
-  for (int i = 0; i < FILTER_FREQUENCY_COUNT;
+                                 filter_getFrequencyCount());
+  for (int i = 0; i < filter_getFrequencyCount();
        i++) { // Update across all filters.
     // The height of the histogram bar depends upon the normalized value.
     histogram_data_t histogramBarValue =
@@ -399,7 +404,7 @@ void histogram_plotUserFrequencyPower(double powerValues[]) {
       printf("Provided normalizedPowerValue[%d]:%lf\n", i,
              normalizedPowerValues[i]);
       printf("Dumping current and normalized power values.\n");
-      for (int tmp_i = 0; tmp_i < FILTER_FREQUENCY_COUNT; tmp_i++) {
+      for (int tmp_i = 0; tmp_i < filter_getFrequencyCount(); tmp_i++) {
         printf("currentPowerValue[%d]:%lf\n", tmp_i,
                filter_getCurrentPowerValue(tmp_i));
         printf("normalizedPowerValue[%d]:%lf\n", tmp_i,
@@ -416,23 +421,24 @@ void histogram_computeNormalizedHitValues(double normalizedHitValues[],
   // First, find the indicies of the min. and max. value in the
   // currentPowerValue array.
   uint16_t maxIndex = 0;
-  for (int i = 0; i < FILTER_FREQUENCY_COUNT; i++) {
+  for (int i = 0; i < filter_getFrequencyCount(); i++) {
     if (hitArray[i] > hitArray[maxIndex])
       maxIndex = i;
   }
   double maxHitValue = (double)hitArray[maxIndex];
   // Normalize everything between 0.0 and 1.0.
-  for (int i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+  for (int i = 0; i < filter_getFrequencyCount(); i++)
     normalizedHitValues[i] = (double)hitArray[i] / maxHitValue;
 }
 
-// Used to plot hits for frequencies 0-9.
+// Used to plot hits for every frequency in the frequency plan.
 void histogram_plotUserHits(uint16_t hitCounts[]) {
-  double normalizedHitValues[FILTER_FREQUENCY_COUNT]; // Store normalized values
-                                                      // here for the histogram.
+  double normalizedHitValues[FILTER_MAX_FREQUENCY_COUNT]; // Store normalized
+                                                          // values here for the
+                                                          // histogram.
   histogram_computeNormalizedHitValues(
       normalizedHitValues, hitCounts); // Get the normalized hit values.
-  for (int i = 0; i < FILTER_FREQUENCY_COUNT;
+  for (int i = 0; i < filter_getFrequencyCount();
        i++) { // Iterate through the results for each channel.
     char label[HISTOGRAM_BAR_TOP_MAX_LABEL_WIDTH_IN_CHARS]; // Get a buffer for
                                                             // the label.
@@ -43,7 +43,8 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 //#define HISTOGRAM_MAX_BAR_COUNT 10		// You can have up to 10 bars on
 // your histogram.
 #define HISTOGRAM_MAX_BAR_COUNT                                                \
-  25 // You can have up to 25 bars on your histogram.
+  32 // You can have up to 32 bars on your histogram, one per player frequency
+     // of the largest frequency plan.
 ///#define HISTOGRAM_BAR_COUNT 10				// This is the
 /// number of histogram bars that you want.
 //#define HISTOGRAM_BAR_X_GAP 5					// This is the
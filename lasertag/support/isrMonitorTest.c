@@ -0,0 +1,161 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "buffer.h"
+#include "interrupts.h"
+#include "intervalTimer.h"
+#include "isrMonitor.h"
+
+#define NOT_OVERWRITTEN false
+#define OVERWRITTEN true
+#define TYPICAL_LATENCY 10
+#define TYPICAL_DURATION 200
+#define OVERRUN_LATENCY (loadValue / 2)
+#define OVERRUN_DURATION (loadValue / 2 + loadValue / 10)
+#define RAMP_DRAIN_TICKS 16 // The main loop drains the log this often.
+#define MAX_WORST_CASE_EVENTS 64
+#define BENCHMARK_TICK_COUNT 10000000
+#define BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define NANOSECONDS_PER_SECOND 1.0E9
+
+static uint32_t loadValue;
+
+// Records an ISR that started latency counts after its interrupt and ran for
+// duration counts (less than a period), across the reload of the counter if it
+// ran into the next tick.
+static void recordIsr(uint32_t latency, uint32_t duration, bool overwritten) {
+  uint32_t entryCounter = loadValue - latency;
+  uint32_t exitCounter = entryCounter >= duration
+                             ? entryCounter - duration
+                             : entryCounter + loadValue + 1 - duration;
+  isrMonitor_recordIsr(entryCounter, exitCounter, overwritten);
+}
+
+static bool popEvent(isrMonitor_eventType_t type, uint32_t tick) {
+  isrMonitor_event_t event;
+  return isrMonitor_popEvent(&event) && event.type == type && event.tick == tick;
+}
+
+// Two ordinary ticks, an overrun and a run of overwrites, checked event by
+// event.
+static bool runEventTest(void) {
+  isrMonitor_init();
+  isrMonitor_statistics_t statistics;
+  isrMonitor_getStatistics(&statistics);
+  loadValue = statistics.periodCounts - 1;
+  bool success = true;
+  recordIsr(TYPICAL_LATENCY, TYPICAL_DURATION, NOT_OVERWRITTEN);
+  success &= popEvent(ISR_MONITOR_WORST_LATENCY, 1);
+  success &= popEvent(ISR_MONITOR_WORST_DURATION, 1);
+  recordIsr(TYPICAL_LATENCY, TYPICAL_DURATION, NOT_OVERWRITTEN);
+  // Starts half a period late and ends a tenth of a period into the next tick.
+  recordIsr(OVERRUN_LATENCY, OVERRUN_DURATION, NOT_OVERWRITTEN);
+  success &= popEvent(ISR_MONITOR_DEADLINE_MISSED, 3);
+  success &= popEvent(ISR_MONITOR_WORST_LATENCY, 3);
+  success &= popEvent(ISR_MONITOR_WORST_DURATION, 3);
+  for (uint32_t tick = 4; tick <= 10; tick++)
+    recordIsr(TYPICAL_LATENCY, TYPICAL_DURATION, tick != 7);
+  success &= popEvent(ISR_MONITOR_BUFFER_OVERWRITE, 4);
+  success &= popEvent(ISR_MONITOR_BUFFER_OVERWRITE, 8);
+  isrMonitor_event_t event;
+  success &= !isrMonitor_popEvent(&event);
+  isrMonitor_getStatistics(&statistics);
+  success &= statistics.tickCount == 10 && statistics.missedDeadlineCount == 1 &&
+             statistics.overwrittenSampleCount == 6 &&
+             statistics.lostEventCount == 0 &&
+             statistics.minLatency == TYPICAL_LATENCY &&
+             statistics.maxLatency == OVERRUN_LATENCY &&
+             statistics.maxDuration == OVERRUN_DURATION;
+  printf("isrMonitor event test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Latencies that grow by one count every tick are logged logarithmically, and
+// overruns that are not drained fill the log and are then counted as lost.
+static bool runLogTest(void) {
+  isrMonitor_init();
+  uint32_t worstCaseEvents = 0;
+  isrMonitor_event_t event;
+  for (uint32_t latency = 0; latency < loadValue - TYPICAL_DURATION; latency++) {
+    recordIsr(latency, TYPICAL_DURATION, NOT_OVERWRITTEN);
+    if (latency % RAMP_DRAIN_TICKS == 0)
+      while (isrMonitor_popEvent(&event))
+        worstCaseEvents++;
+  }
+  while (isrMonitor_popEvent(&event))
+    worstCaseEvents++;
+  bool success = worstCaseEvents < MAX_WORST_CASE_EVENTS;
+  // The first overrun is also the worst duration so far, drained here so
+  // that the log then fills with deadline misses only.
+  recordIsr(OVERRUN_LATENCY, OVERRUN_DURATION, NOT_OVERWRITTEN);
+  while (isrMonitor_popEvent(&event))
+    ;
+  uint32_t overrunCount = 2 * ISR_MONITOR_EVENT_LOG_SIZE;
+  for (uint32_t i = 0; i < overrunCount; i++)
+    recordIsr(OVERRUN_LATENCY, OVERRUN_DURATION, NOT_OVERWRITTEN);
+  uint32_t loggedCount = 0;
+  while (isrMonitor_popEvent(&event))
+    loggedCount++;
+  isrMonitor_statistics_t statistics;
+  isrMonitor_getStatistics(&statistics);
+  success &= loggedCount == ISR_MONITOR_EVENT_LOG_SIZE &&
+             statistics.missedDeadlineCount == overrunCount + 1 &&
+             statistics.lostEventCount == overrunCount - loggedCount;
+  printf("isrMonitor log test %s (%u worst cases logged over %u ticks, %u "
+         "overruns lost)\n",
+         success ? "passed" : "failed", worstCaseEvents,
+         loadValue - TYPICAL_DURATION, statistics.lostEventCount);
+  return success;
+}
+
+// buffer_pushover() reports an overwrite only for values that were not popped.
+static bool runBufferTest(void) {
+  buffer_init();
+  bool overwritten = false;
+  for (uint32_t i = 0; i < buffer_size(); i++)
+    overwritten |= buffer_pushover(i);
+  bool success = !overwritten && buffer_pushover(0);
+  buffer_data_t value;
+  success &= buffer_popBlock(&value, 1) == 1;
+  success &= !buffer_pushover(0) && buffer_pushover(0);
+  printf("isrMonitor buffer overwrite test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Times the monitor's part of an ordinary tick: two reads of the private timer
+// counter and the bookkeeping.
+static void runBenchmark(void) {
+  isrMonitor_init();
+  intervalTimer_init(BENCHMARK_TIMER);
+  intervalTimer_start(BENCHMARK_TIMER);
+  for (uint32_t n = 0; n < BENCHMARK_TICK_COUNT; n++) {
+    uint32_t entryCounter = interrupts_getPrivateTimerCounterValue();
+    isrMonitor_recordIsr(entryCounter, interrupts_getPrivateTimerCounterValue(),
+                         NOT_OVERWRITTEN);
+  }
+  intervalTimer_stop(BENCHMARK_TIMER);
+  isrMonitor_event_t event;
+  while (isrMonitor_popEvent(&event))
+    ;
+  printf("isrMonitor %.2lf ns per tick\n",
+         intervalTimer_getTotalDurationInSeconds(BENCHMARK_TIMER) *
+             NANOSECONDS_PER_SECOND / BENCHMARK_TICK_COUNT);
+}
+
+// Checks the totals and the event log, then times the monitor.
+bool isrMonitor_runTest(void) {
+  bool success = runEventTest();
+  success &= runLogTest();
+  success &= runBufferTest();
+  runBenchmark();
+  return success;
+}
@@ -0,0 +1,21 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef ISRMONITORTEST_H_
+#define ISRMONITORTEST_H_
+
+#include <stdbool.h>
+
+// Feeds the monitor ISR timings with known overruns, worst cases and buffer
+// overwrites and checks the totals and the event log, including a full log,
+// then times the per-tick cost of the monitor. Returns false if any total or
+// event is wrong.
+bool isrMonitor_runTest(void);
+
+#endif /* ISRMONITORTEST_H_ */
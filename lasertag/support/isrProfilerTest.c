@@ -0,0 +1,113 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "intervalTimer.h"
+#include "isrProfiler.h"
+
+#ifdef ISR_PROFILER
+#define CALL_COUNT 10000
+#define OUTLIER_COUNT 100 // The 1% above the 99th percentile.
+#define OUTLIER_COUNT_VALUE 50000
+#define BIN_RESOLUTION 1.125 // Eight bins per power of two.
+#define BENCHMARK_CALL_COUNT 10000000
+#define BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define NANOSECONDS_PER_SECOND 1.0E9
+
+// The counts of one function's calls: a ramp from base, then the outliers.
+static uint32_t callCountValue(uint32_t base, uint32_t step, uint32_t call) {
+  if (call >= CALL_COUNT - OUTLIER_COUNT)
+    return OUTLIER_COUNT_VALUE;
+  return base + step * call;
+}
+
+// Records CALL_COUNT calls per function, with ramps of different scales so
+// that the small, exact bins and the power-of-two bins are both covered, and
+// checks the statistics against the recorded values. isrProfiler_init() has
+// not run, so the read overhead is 0 and the counts are kept as recorded.
+static bool runStatisticsTest(void) {
+  bool success = true;
+  isrProfiler_reset();
+  for (uint16_t function = 0; function < ISR_PROFILER_FUNCTION_COUNT;
+       function++) {
+    uint32_t base = function;
+    uint32_t step = function + 1;
+    double sum = 0.0;
+    for (uint32_t call = 0; call < CALL_COUNT; call++) {
+      uint32_t count = callCountValue(base, step, call);
+      isrProfiler_record(function, count);
+      sum += count;
+    }
+    // 99% of the calls are at or below the last value of the ramp.
+    uint32_t p99 = callCountValue(base, step, CALL_COUNT - OUTLIER_COUNT - 1);
+    isrProfiler_statistics_t statistics;
+    isrProfiler_getStatistics(function, &statistics);
+    bool passed = statistics.callCount == CALL_COUNT &&
+                  statistics.min == base &&
+                  statistics.max == OUTLIER_COUNT_VALUE &&
+                  statistics.mean == sum / CALL_COUNT &&
+                  statistics.p99 >= p99 && statistics.p99 <= p99 * BIN_RESOLUTION;
+    printf("%-17s min %u mean %.1f p99 %u (exact %u) max %u %s\n",
+           isrProfiler_getName(function), statistics.min, statistics.mean,
+           statistics.p99, p99, statistics.max, passed ? "passed" : "failed");
+    success &= passed;
+  }
+  return success;
+}
+
+static volatile uint32_t sink;
+
+static void __attribute__((noinline)) emptyTick(void) { sink++; }
+
+// Times a bare call and the same call wrapped the way ISR_PROFILER_MEASURE
+// wraps the tick calls in isr_function().
+static void runBenchmark(void) {
+  isrProfiler_init();
+  double bareNanoseconds = 0.0;
+  for (uint16_t pass = 0; pass < 2; pass++) {
+    intervalTimer_init(BENCHMARK_TIMER);
+    intervalTimer_start(BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < BENCHMARK_CALL_COUNT; n++) {
+      if (pass == 0) {
+        emptyTick();
+      } else {
+        uint32_t start = isrProfiler_readCounter();
+        emptyTick();
+        isrProfiler_record(ISR_PROFILER_SOUND,
+                           isrProfiler_readCounter() - start);
+      }
+    }
+    intervalTimer_stop(BENCHMARK_TIMER);
+    double nanoseconds =
+        intervalTimer_getTotalDurationInSeconds(BENCHMARK_TIMER) *
+        NANOSECONDS_PER_SECOND / BENCHMARK_CALL_COUNT;
+    if (pass == 0)
+      bareNanoseconds = nanoseconds;
+    printf("%-12s %5.2lf ns per call (%.2lf ns instrumentation)\n",
+           pass ? "instrumented" : "bare", nanoseconds,
+           nanoseconds - bareNanoseconds);
+  }
+  isrProfiler_print();
+}
+
+#endif
+
+// Checks the statistics, then times the instrumentation. isrProfiler.c is only
+// built with ISR_PROFILER, so the other builds have nothing to test.
+bool isrProfiler_runTest(void) {
+#ifdef ISR_PROFILER
+  bool success = runStatisticsTest();
+  runBenchmark();
+  return success;
+#else
+  return true;
+#endif
+}
@@ -0,0 +1,20 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef ISRPROFILERTEST_H_
+#define ISRPROFILERTEST_H_
+
+#include <stdbool.h>
+
+// Records known call costs and checks the minimum, mean, maximum and 99th
+// percentile that the profiler reports, then times the instrumentation of one
+// call. Returns false if a statistic is off by more than a histogram bin.
+bool isrProfiler_runTest(void);
+
+#endif /* ISRPROFILERTEST_H_ */
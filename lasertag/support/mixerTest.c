@@ -0,0 +1,223 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "intervalTimer.h"
+#include "mixer.h"
+#include "sound.h"
+
+#define TEST_SOUND_LENGTH 100
+#define TEST_SOUND_COUNT (MIXER_VOICE_COUNT + 2)
+#define OFFSET_BINARY_ZERO 0x8000
+#define HALF_VOLUME (MIXER_FULL_VOLUME / 2 + 1) // 0.5 in Q15.
+#define Q15_SHIFT 15
+#define LOW_PRIORITY 0
+#define HIGH_PRIORITY 1
+#define BENCHMARK_SOUND_LENGTH 48000 // A multiple of the mix-ahead count.
+#define BENCHMARK_SAMPLE_COUNT 10000000
+#define BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define NANOSECONDS_PER_SECOND 1.0E9
+#define SAMPLES_PER_ISR_TICK 0.48 // 48 kHz audio, 100 kHz ticks.
+
+static uint16_t testSamples[TEST_SOUND_COUNT][TEST_SOUND_LENGTH];
+static mixer_sound_t testSounds[TEST_SOUND_COUNT];
+static uint16_t benchmarkSamples[BENCHMARK_SOUND_LENGTH];
+static uint8_t benchmarkAdpcm[BENCHMARK_SOUND_LENGTH / ADPCM_SAMPLES_PER_BYTE];
+static mixer_sound_t benchmarkSounds[MIXER_VOICE_COUNT];
+
+// Registers sounds that hold one value each, at the given priorities.
+static void registerSounds(const int16_t values[], const uint8_t priorities[]) {
+  mixer_init();
+  for (uint16_t i = 0; i < TEST_SOUND_COUNT; i++) {
+    for (uint16_t k = 0; k < TEST_SOUND_LENGTH; k++)
+      testSamples[i][k] = (uint16_t)(values[i] + OFFSET_BINARY_ZERO);
+    mixer_register(&testSounds[i], testSamples[i], TEST_SOUND_LENGTH,
+                   priorities[i]);
+  }
+}
+
+static int16_t renderOne(void) {
+  int16_t sample;
+  mixer_render(&sample, 1);
+  return sample;
+}
+
+// Sums, volumes, saturation and the end of a sound.
+static bool runMixTest(void) {
+  const int16_t values[TEST_SOUND_COUNT] = {1000,  -300,  20000,
+                                            20000, -30000, -30000};
+  const uint8_t priorities[TEST_SOUND_COUNT] = {0};
+  registerSounds(values, priorities);
+  bool success = renderOne() == 0 && !mixer_isBusy();
+  mixer_play(&testSounds[0], MIXER_FULL_VOLUME);
+  mixer_play(&testSounds[1], HALF_VOLUME);
+  success &= mixer_isBusy();
+  // 1000 * 32767 / 32768 rounds down to 999.
+  success &= renderOne() == 999 - 150;
+  mixer_setVolume(&testSounds[0], HALF_VOLUME);
+  success &= renderOne() == 500 - 150;
+  // Halfway through, the pair goes off the top and then the bottom.
+  int16_t out[TEST_SOUND_LENGTH];
+  mixer_render(out, TEST_SOUND_LENGTH / 2 - 2);
+  mixer_play(&testSounds[2], MIXER_FULL_VOLUME);
+  mixer_play(&testSounds[3], MIXER_FULL_VOLUME);
+  success &= renderOne() == INT16_MAX;
+  mixer_stop(&testSounds[2]);
+  mixer_stop(&testSounds[3]);
+  mixer_play(&testSounds[4], MIXER_FULL_VOLUME);
+  mixer_play(&testSounds[5], MIXER_FULL_VOLUME);
+  success &= renderOne() == INT16_MIN;
+  mixer_stop(&testSounds[4]);
+  mixer_stop(&testSounds[5]);
+  // The first two end with their last sample, and the mix goes silent.
+  mixer_render(out, TEST_SOUND_LENGTH / 2 - 2);
+  success &= out[TEST_SOUND_LENGTH / 2 - 3] == 500 - 150;
+  success &= !mixer_isPlaying(&testSounds[0]) && !mixer_isBusy();
+  success &= renderOne() == 0;
+  printf("mixer mix test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Fills the voices with low-priority sounds and checks which voice each new
+// sound takes.
+static bool runVoiceStealingTest(void) {
+  const int16_t values[TEST_SOUND_COUNT] = {1, 2, 4, 8, 16, 32};
+  const uint8_t priorities[TEST_SOUND_COUNT] = {
+      LOW_PRIORITY, LOW_PRIORITY,  LOW_PRIORITY,
+      LOW_PRIORITY, HIGH_PRIORITY, LOW_PRIORITY};
+  registerSounds(values, priorities);
+  bool success = true;
+  for (uint16_t i = 0; i < MIXER_VOICE_COUNT; i++) {
+    mixer_play(&testSounds[i], MIXER_FULL_VOLUME);
+    renderOne(); // Sound 0 has played longest.
+  }
+  success &= renderOne() == 1 + 2 + 4 + 8 - 4; // Rounded down one each.
+  // The high-priority sound takes the voice of the oldest low one.
+  mixer_play(&testSounds[4], MIXER_FULL_VOLUME);
+  success &= renderOne() == 2 + 4 + 8 + 16 - 4;
+  success &= !mixer_isPlaying(&testSounds[0]);
+  // A low-priority sound takes the oldest low one, sound 1.
+  mixer_play(&testSounds[5], MIXER_FULL_VOLUME);
+  success &= renderOne() == 4 + 8 + 16 + 32 - 4;
+  success &= !mixer_isPlaying(&testSounds[1]);
+  // Playing a sound again restarts it on its own voice.
+  mixer_play(&testSounds[2], MIXER_FULL_VOLUME);
+  success &= renderOne() == 4 + 8 + 16 + 32 - 4;
+  success &= mixer_isPlaying(&testSounds[3]);
+  printf("mixer voice stealing test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// A low-priority sound that finds every voice playing something more
+// important is dropped.
+static bool runDropTest(void) {
+  const int16_t values[TEST_SOUND_COUNT] = {1, 2, 4, 8, 16, 32};
+  const uint8_t priorities[TEST_SOUND_COUNT] = {
+      HIGH_PRIORITY, HIGH_PRIORITY, HIGH_PRIORITY,
+      HIGH_PRIORITY, LOW_PRIORITY,  LOW_PRIORITY};
+  registerSounds(values, priorities);
+  for (uint16_t i = 0; i < MIXER_VOICE_COUNT; i++)
+    mixer_play(&testSounds[i], MIXER_FULL_VOLUME);
+  mixer_play(&testSounds[4], MIXER_FULL_VOLUME);
+  bool success = mixer_isPlaying(&testSounds[4]);
+  success &= renderOne() == 1 + 2 + 4 + 8 - 4;
+  success &= !mixer_isPlaying(&testSounds[4]);
+  mixer_stopAll();
+  success &= !mixer_isBusy() && renderOne() == 0;
+  printf("mixer drop test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// IMA-ADPCM codes 7, 7, 7, 7, 0, 7, 8 and 15, and what encodeAdpcm.py decodes
+// from them.
+static const uint8_t adpcmCodes[] = {0x77, 0x77, 0x70, 0xf8};
+static const int16_t adpcmDecoded[] = {11, 41, 104, 240, 259, 525, 487, -34};
+#define ADPCM_TEST_LENGTH (sizeof(adpcmDecoded) / sizeof(adpcmDecoded[0]))
+
+// Decodes an IMA-ADPCM sound across renders that split its bytes, and plays
+// the silence that sound.c pads with.
+static bool runAdpcmTest(void) {
+  static const uint8_t silence[TEST_SOUND_LENGTH / ADPCM_SAMPLES_PER_BYTE];
+  mixer_init();
+  mixer_registerAdpcm(&testSounds[0], adpcmCodes, ADPCM_TEST_LENGTH,
+                      LOW_PRIORITY);
+  mixer_registerAdpcm(&testSounds[1], silence, TEST_SOUND_LENGTH,
+                      LOW_PRIORITY);
+  bool success = true;
+  // Twice, to check that a replay starts the decoder over.
+  for (uint16_t pass = 0; pass < 2; pass++) {
+    mixer_play(&testSounds[0], MIXER_FULL_VOLUME);
+    mixer_play(&testSounds[1], MIXER_FULL_VOLUME);
+    int16_t out[ADPCM_TEST_LENGTH];
+    mixer_render(out, 3);
+    mixer_render(&out[3], ADPCM_TEST_LENGTH - 3);
+    for (uint16_t k = 0; k < ADPCM_TEST_LENGTH; k++)
+      success &= out[k] == (adpcmDecoded[k] * MIXER_FULL_VOLUME) >> Q15_SHIFT;
+    success &= !mixer_isPlaying(&testSounds[0]);
+    // The rest of the silence.
+    int16_t rest[TEST_SOUND_LENGTH - ADPCM_TEST_LENGTH];
+    mixer_render(rest, TEST_SOUND_LENGTH - ADPCM_TEST_LENGTH);
+    for (uint16_t k = 0; k < TEST_SOUND_LENGTH - ADPCM_TEST_LENGTH; k++)
+      success &= rest[k] == 0;
+    success &= !mixer_isBusy();
+  }
+  printf("mixer ADPCM test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Times sound_tick()'s request, SOUND_MIX_AHEAD_SAMPLE_COUNT output samples,
+// with every voice busy playing 16-bit samples or IMA-ADPCM. The IMA-ADPCM
+// codes are random, which is the worst case for the decoder's branches.
+static void runBenchmark(bool adpcm) {
+  mixer_init();
+  for (uint32_t k = 0; k < BENCHMARK_SOUND_LENGTH; k++)
+    benchmarkSamples[k] = (uint16_t)(k * 7919);
+  for (uint32_t k = 0; k < BENCHMARK_SOUND_LENGTH / ADPCM_SAMPLES_PER_BYTE; k++)
+    benchmarkAdpcm[k] = (uint8_t)(k * 7919);
+  for (uint16_t v = 0; v < MIXER_VOICE_COUNT; v++) {
+    if (adpcm)
+      mixer_registerAdpcm(&benchmarkSounds[v], benchmarkAdpcm,
+                          BENCHMARK_SOUND_LENGTH, LOW_PRIORITY);
+    else
+      mixer_register(&benchmarkSounds[v], benchmarkSamples,
+                     BENCHMARK_SOUND_LENGTH, LOW_PRIORITY);
+  }
+  int16_t out[SOUND_MIX_AHEAD_SAMPLE_COUNT];
+  volatile int16_t sink = 0;
+  intervalTimer_init(BENCHMARK_TIMER);
+  intervalTimer_start(BENCHMARK_TIMER);
+  for (uint32_t n = 0; n < BENCHMARK_SAMPLE_COUNT;
+       n += SOUND_MIX_AHEAD_SAMPLE_COUNT) {
+    if (n % BENCHMARK_SOUND_LENGTH == 0)
+      for (uint16_t v = 0; v < MIXER_VOICE_COUNT; v++)
+        mixer_play(&benchmarkSounds[v], MIXER_FULL_VOLUME);
+    mixer_render(out, SOUND_MIX_AHEAD_SAMPLE_COUNT);
+    sink += out[0];
+  }
+  intervalTimer_stop(BENCHMARK_TIMER);
+  double nanoseconds = intervalTimer_getTotalDurationInSeconds(BENCHMARK_TIMER) *
+                       NANOSECONDS_PER_SECOND / BENCHMARK_SAMPLE_COUNT;
+  printf("mixer %d %s voices: %.2lf ns per output sample, %.2lf ns per ISR "
+         "tick\n",
+         MIXER_VOICE_COUNT, adpcm ? "ADPCM" : "16-bit", nanoseconds,
+         nanoseconds * SAMPLES_PER_ISR_TICK);
+}
+
+// Checks the mixes and the voices, then times the mix.
+bool mixer_runTest(void) {
+  bool success = runMixTest();
+  success &= runVoiceStealingTest();
+  success &= runDropTest();
+  success &= runAdpcmTest();
+  runBenchmark(false);
+  runBenchmark(true);
+  return success;
+}
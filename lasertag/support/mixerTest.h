@@ -0,0 +1,22 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef MIXERTEST_H_
+#define MIXERTEST_H_
+
+#include <stdbool.h>
+
+// Mixes constant test sounds and checks the sums, the volumes, the saturation,
+// the end of a sound and which voice a new sound takes when all are busy, and
+// decodes a short IMA-ADPCM sound. Then times the mix the way sound_tick() asks
+// for it, from 16-bit and from IMA-ADPCM sounds.
+// Returns false if any output sample or voice is wrong.
+bool mixer_runTest(void);
+
+#endif /* MIXERTEST_H_ */
@@ -0,0 +1,183 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intervalTimer.h"
+#include "powerSelect.h"
+
+#define TIE_VALUE_COUNT 3 // Inputs drawn from {0, 1, 2} cover every tie pattern.
+#define MEDIAN_INDEX(count) (((count) - 1) / 2)
+#define QUICKSELECT_MAX_COUNT 32
+#define QUICKSELECT_INPUTS_PER_COUNT 10000
+#define BENCHMARK_SET_COUNT 1024
+#define BENCHMARK_PASS_COUNT 1000
+#define BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define NANOSECONDS_PER_SECOND 1.0E9
+
+static double benchmarkValues[BENCHMARK_SET_COUNT][POWER_SELECT_NETWORK_COUNT];
+static volatile double benchmarkSink;
+
+// The detector's original selection: an insertion sort of the indices by
+// value, ascending and stable. The largest is the last index, the median the
+// one at MEDIAN_INDEX().
+static void referenceSort(const double values[], uint16_t count,
+                          uint16_t sorted[]) {
+  sorted[0] = 0;
+  for (uint16_t insert = 1; insert < count; insert++) {
+    sorted[insert] = insert;
+    for (int16_t compare = insert - 1; compare >= 0; compare--) {
+      if (values[insert] >= values[sorted[compare]])
+        break;
+      sorted[compare + 1] = sorted[compare];
+      sorted[compare] = insert;
+    }
+  }
+}
+
+// Compares both kernels with the reference on one input of count values.
+// Prints the first few mismatches.
+static bool checkValues(const double values[], uint16_t count,
+                        uint32_t *mismatchCount) {
+  uint16_t sorted[QUICKSELECT_MAX_COUNT];
+  double scratch[QUICKSELECT_MAX_COUNT];
+  referenceSort(values, count, sorted);
+  memcpy(scratch, values, count * sizeof(scratch[0]));
+  uint16_t maxIndex = powerSelect_maxIndex(values, count);
+  double median = powerSelect_median(scratch, count);
+  if (maxIndex == sorted[count - 1] &&
+      median == values[sorted[MEDIAN_INDEX(count)]])
+    return true;
+  if ((*mismatchCount)++ < 5) {
+    printf("powerSelect mismatch on");
+    for (uint16_t i = 0; i < count; i++)
+      printf(" %g", values[i]);
+    printf(": max index %d (expected %d), median %g (expected %g)\n", maxIndex,
+           sorted[count - 1], median, values[sorted[MEDIAN_INDEX(count)]]);
+  }
+  return false;
+}
+
+// Every ordering of 0..9, generated with Heap's algorithm.
+static uint32_t checkAllPermutations(uint32_t *mismatchCount) {
+  double values[POWER_SELECT_NETWORK_COUNT];
+  uint16_t counters[POWER_SELECT_NETWORK_COUNT] = {0};
+  uint32_t checked = 1;
+  for (uint16_t i = 0; i < POWER_SELECT_NETWORK_COUNT; i++)
+    values[i] = i;
+  checkValues(values, POWER_SELECT_NETWORK_COUNT, mismatchCount);
+  uint16_t i = 1;
+  while (i < POWER_SELECT_NETWORK_COUNT) {
+    if (counters[i] < i) {
+      uint16_t j = (i & 1) ? counters[i] : 0;
+      double swap = values[j];
+      values[j] = values[i];
+      values[i] = swap;
+      checkValues(values, POWER_SELECT_NETWORK_COUNT, mismatchCount);
+      checked++;
+      counters[i]++;
+      i = 1;
+    } else {
+      counters[i++] = 0;
+    }
+  }
+  return checked;
+}
+
+// Every input of ten values from {0, 1, 2}.
+static uint32_t checkAllTies(uint32_t *mismatchCount) {
+  uint32_t combinationCount = 1;
+  for (uint16_t i = 0; i < POWER_SELECT_NETWORK_COUNT; i++)
+    combinationCount *= TIE_VALUE_COUNT;
+  for (uint32_t combination = 0; combination < combinationCount;
+       combination++) {
+    double values[POWER_SELECT_NETWORK_COUNT];
+    uint32_t digits = combination;
+    for (uint16_t i = 0; i < POWER_SELECT_NETWORK_COUNT; i++) {
+      values[i] = digits % TIE_VALUE_COUNT;
+      digits /= TIE_VALUE_COUNT;
+    }
+    checkValues(values, POWER_SELECT_NETWORK_COUNT, mismatchCount);
+  }
+  return combinationCount;
+}
+
+// Random inputs with ties for every other count, which go through
+// quickselect.
+static uint32_t checkQuickselect(uint32_t *mismatchCount) {
+  uint32_t checked = 0;
+  srand(1);
+  for (uint16_t count = 1; count <= QUICKSELECT_MAX_COUNT; count++) {
+    for (uint32_t n = 0; n < QUICKSELECT_INPUTS_PER_COUNT; n++) {
+      double values[QUICKSELECT_MAX_COUNT];
+      for (uint16_t i = 0; i < count; i++)
+        values[i] = rand() % count;
+      checkValues(values, count, mismatchCount);
+      checked++;
+    }
+  }
+  return checked;
+}
+
+// Times the reference sort and the kernels over random power values, the way
+// find_hit() uses them, and prints the cost per call.
+static void runBenchmark(void) {
+  srand(1);
+  for (uint32_t set = 0; set < BENCHMARK_SET_COUNT; set++)
+    for (uint16_t i = 0; i < POWER_SELECT_NETWORK_COUNT; i++)
+      benchmarkValues[set][i] = (double)rand() / RAND_MAX;
+  double referenceNanoseconds = 0.0;
+  for (uint16_t pass = 0; pass < 2; pass++) {
+    intervalTimer_init(BENCHMARK_TIMER);
+    intervalTimer_start(BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < BENCHMARK_PASS_COUNT; n++) {
+      for (uint32_t set = 0; set < BENCHMARK_SET_COUNT; set++) {
+        const double *values = benchmarkValues[set];
+        if (pass == 0) {
+          uint16_t sorted[POWER_SELECT_NETWORK_COUNT];
+          referenceSort(values, POWER_SELECT_NETWORK_COUNT, sorted);
+          benchmarkSink =
+              values[sorted[POWER_SELECT_NETWORK_COUNT - 1]] -
+              values[sorted[MEDIAN_INDEX(POWER_SELECT_NETWORK_COUNT)]];
+        } else {
+          double scratch[POWER_SELECT_NETWORK_COUNT];
+          memcpy(scratch, values, sizeof(scratch));
+          benchmarkSink =
+              values[powerSelect_maxIndex(values, POWER_SELECT_NETWORK_COUNT)] -
+              powerSelect_median(scratch, POWER_SELECT_NETWORK_COUNT);
+        }
+      }
+    }
+    intervalTimer_stop(BENCHMARK_TIMER);
+    double nanoseconds =
+        intervalTimer_getTotalDurationInSeconds(BENCHMARK_TIMER) *
+        NANOSECONDS_PER_SECOND / (BENCHMARK_PASS_COUNT * BENCHMARK_SET_COUNT);
+    if (pass == 0)
+      referenceNanoseconds = nanoseconds;
+    printf("%-16s %6.1lf ns per max and median (%.1fx)\n",
+           pass ? "selection" : "insertion sort", nanoseconds,
+           referenceNanoseconds / nanoseconds);
+  }
+}
+
+// Checks both kernels against the reference sort exhaustively, then times
+// them.
+bool powerSelect_runTest(void) {
+  uint32_t mismatchCount = 0;
+  uint32_t checked = checkAllPermutations(&mismatchCount);
+  checked += checkAllTies(&mismatchCount);
+  checked += checkQuickselect(&mismatchCount);
+  printf("powerSelect: %u inputs checked, %u mismatches\n", checked,
+         mismatchCount);
+  runBenchmark();
+  return mismatchCount == 0;
+}
@@ -0,0 +1,22 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef POWERSELECTTEST_H_
+#define POWERSELECTTEST_H_
+
+#include <stdbool.h>
+
+// Checks powerSelect_maxIndex() and powerSelect_median() against the insertion
+// sort that the detector used before, over every ordering of ten distinct
+// values, every input of ten drawn from three values (all of the ways values
+// can tie) and random inputs of 1 to 32 values, then times both on ten values.
+// Returns false if any result differs.
+bool powerSelect_runTest(void);
+
+#endif /* POWERSELECTTEST_H_ */
@@ -327,7 +327,7 @@ static bool queue_pushPopTest(void) {
   double *ncq = (double *)malloc(NON_CIRC_Q_SIZE * sizeof(double));
   for (uint16_t i = 0; i < NON_CIRC_Q_SIZE;
        i++) { // Fill up the non-circular queue with data.
-    ncq[i] = (double)rand();
+    ncq[i] = (queue_data_t)rand(); // Exact in either queue precision.
   }
   // Emulate a simple non-circular queue for testing purposes.
   uint16_t ncqPopIndexPtr = 0;  // The pop-pointer for the non-circular queue.
@@ -497,11 +497,11 @@ bool queue_overwritePushTest(void) {
   double *dataArray1 =
       (double *)malloc((OVERWRITE_PUSH_TEST_QUEUE_SIZE) * sizeof(double));
   for (uint16_t i = 0; i < OVERWRITE_PUSH_TEST_QUEUE_SIZE; i++)
-    dataArray1[i] = (double)rand();
+    dataArray1[i] = (queue_data_t)rand(); // Exact in either queue precision.
   double *dataArray2 =
       (double *)malloc((OVERWRITE_PUSH_TEST_QUEUE_SIZE) * sizeof(double));
   for (uint16_t i = 0; i < OVERWRITE_PUSH_TEST_QUEUE_SIZE; i++)
-    dataArray2[i] = (double)rand();
+    dataArray2[i] = (queue_data_t)rand(); // Exact in either queue precision.
   // Fill the queue with all data values.
   for (uint16_t i = 0; i < OVERWRITE_PUSH_TEST_QUEUE_SIZE; i++) {
     queue_overwritePush(&testQ, dataArray1[i]);
@@ -520,6 +520,16 @@ bool queue_overwritePushTest(void) {
       break;
     }
   }
+  // queue_clear() starts the queue over in the same storage.
+  queue_data_t *storage = testQ.data;
+  queue_clear(&testQ);
+  queue_overwritePush(&testQ, dataArray1[0]);
+  if (testQ.data != storage || queue_elementCount(&testQ) != 1 ||
+      queue_readElementAt(&testQ, 0) != dataArray1[0]) {
+    printf("* Error: queue: %s is incorrect after queue_clear().\n",
+           queue_name(&testQ));
+    testResult = false;
+  }
   // Garbage collect all of the allocated memory.
   queue_garbageCollect(&testQ);
   free(dataArray1);
@@ -527,6 +537,50 @@ bool queue_overwritePushTest(void) {
   return testResult;
 }
 
+#define SPAN_TEST_QUEUE_SIZE 100 // Not a power of two, so the array is larger.
+#define SPAN_TEST_PUSH_COUNT 400
+#define SPAN_TEST_QUEUE_NAME "spanQ"
+// Checks that queue_getSpans() and the unchecked functions see the same
+// contents as queue_readElementAt() while the queue fills and wraps around.
+bool queue_spanTest(void) {
+  bool testResult = true;
+  queue_t testQ;
+  queue_init(&testQ, SPAN_TEST_QUEUE_SIZE, SPAN_TEST_QUEUE_NAME);
+  for (uint32_t pushCount = 0; pushCount <= SPAN_TEST_PUSH_COUNT; pushCount++) {
+    queue_span_t spans[2];
+    uint32_t spanCount = queue_getSpans(&testQ, spans);
+    uint32_t expectedSpanCount = (spans[0].count > 0) + (spans[1].count > 0);
+    if (spanCount != expectedSpanCount ||
+        spans[0].count + spans[1].count != queue_elementCount(&testQ) ||
+        (spans[0].count == 0 && spans[1].count > 0)) {
+      printf("* Error: queue_getSpans(%s) returned spans of %u and %u elements "
+             "for %u elements.\n",
+             queue_name(&testQ), spans[0].count, spans[1].count,
+             queue_elementCount(&testQ));
+      testResult = false;
+      break;
+    }
+    queue_index_t index = 0;
+    for (uint32_t s = 0; s < 2; s++) {
+      for (queue_size_t i = 0; i < spans[s].count; i++, index++) {
+        if (spans[s].data[i] != queue_readElementAt(&testQ, index) ||
+            queue_readElementAtUnchecked(&testQ, index) !=
+                queue_readElementAt(&testQ, index)) {
+          printf("* Error: span element %u of queue: %s is incorrect after %u "
+                 "pushes.\n",
+                 index, queue_name(&testQ), pushCount);
+          testResult = false;
+        }
+      }
+    }
+    if (!testResult)
+      break;
+    queue_overwritePushUnchecked(&testQ, (queue_data_t)pushCount);
+  }
+  queue_garbageCollect(&testQ);
+  return testResult;
+}
+
 #define QUEUE_TEST_MAX_QUEUE_SIZE 100 // Used for the fill/empty tests.
 #define QUEUE_TEST_MAX_LOOP_COUNT                                              \
   10 // All tests will be invoked this many times.
@@ -558,9 +612,9 @@ bool queue_runTest(void) {
            arraySize);
     // Allocate the array.
     double *dataArray =
-        (queue_data_t *)malloc(sizeof(queue_data_t) * arraySize);
+        (double *)malloc(sizeof(double) * arraySize);
     for (uint i = 0; i < arraySize; i++) {
-      dataArray[i] = (double)rand();
+      dataArray[i] = (queue_data_t)rand(); // Exact in either queue precision.
     }
     queue_t testQ; // queue instance used for testing.
     queue_init(&testQ, arraySize, QUEUE_TEST_QUEUE_NAME); // Init the queue.
@@ -628,6 +682,17 @@ bool queue_runTest(void) {
     } else {
       printf("=== Queue: %s failed overwritePush test.\n", queue_name(&testQ));
     }
+    testResult = tempResult
+                     ? testResult
+                     : false; // Logical AND of testResult and tempResult.
+    printf("=== Commencing span test (queue_getSpans() across wrap-around) "
+           "=== \n");
+    tempResult = queue_spanTest();
+    if (tempResult) {
+      printf("=== Queue: %s passed span test.\n", queue_name(&testQ));
+    } else {
+      printf("=== Queue: %s failed span test.\n", queue_name(&testQ));
+    }
     testResult = tempResult
                      ? testResult
                      : false; // Logical AND of testResult and tempResult.
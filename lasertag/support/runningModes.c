@@ -23,6 +23,8 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #include "interrupts.h"
 #include "intervalTimer.h"
 #include "isr.h"
+#include "isrMonitor.h"
+#include "isrProfiler.h"
 #include "lockoutTimer.h"
 #include "runningModes.h"
 #include "switches.h"
@@ -41,10 +43,12 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #define MAX_BUFFER_SIZE 100 // Used for a generic message buffer.
 
 #define DETECTOR_HIT_ARRAY_SIZE                                                \
-  FILTER_FREQUENCY_COUNT // The array contains one location per user frequency.
+  FILTER_MAX_FREQUENCY_COUNT // The array contains one location per user
+                             // frequency.
 
 #define HISTOGRAM_BAR_COUNT                                                    \
-  FILTER_FREQUENCY_COUNT // As many histogram bars as user filter frequencies.
+  filter_getFrequencyCount() // As many histogram bars as user filter
+                             // frequencies.
 
 #define ISR_CUMULATIVE_TIMER INTERVAL_TIMER_TIMER_0 // Used by the ISR.
 #define TOTAL_RUNTIME_TIMER                                                    \
@@ -166,6 +170,13 @@ void runningModes_printRunTimeStatistics(void) {
     display_printDecimalInt(SUGGESTED_REMAINING_ELEMENT_COUNT);
     display_print(" elements.\n\n");
   }
+
+  // The TFT is full, so the ISR overruns and costs go to the console.
+  isrMonitor_printEvents();
+  isrMonitor_printStatistics();
+#ifdef ISR_PROFILER
+  isrProfiler_print();
+#endif
 }
 
 // Group all of the inits together to reduce visual clutter.
@@ -187,8 +198,8 @@ void runningModes_initAll(void) {
 uint16_t runningModes_getFrequencySetting(void) {
   uint16_t switchSetting = switches_read() & 0xF; // Bit-mask the results.
   // Provide a nice default if the slide switches are in error.
-  if (!(switchSetting < FILTER_FREQUENCY_COUNT))
-    return FILTER_FREQUENCY_COUNT - 1;
+  if (!(switchSetting < filter_getFrequencyCount()))
+    return filter_getFrequencyCount() - 1;
   else
     return switchSetting;
 }
@@ -200,9 +211,9 @@ uint16_t runningModes_getFrequencySetting(void) {
 void runningModes_continuous(void) {
   runningModes_initAll(); // All necessary inits are called here.
 
-  bool ignoredFrequencies[FILTER_FREQUENCY_COUNT];
+  bool ignoredFrequencies[FILTER_MAX_FREQUENCY_COUNT];
   // setup the ignore frequencies array so you don't ignore any frequency.
-  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+  for (uint16_t i = 0; i < filter_getFrequencyCount(); i++)
     ignoredFrequencies[i] = false;
 #ifdef IGNORE_OWN_FREQUENCY
   printf("Ignoring own frequency.\n");
@@ -238,7 +249,7 @@ void runningModes_continuous(void) {
     intervalTimer_stop(MAIN_CUMULATIVE_TIMER);
     // If enough ticks have transpired, update the histogram.
     if (histogramSystemTicks >= SYSTEM_TICKS_PER_HISTOGRAM_UPDATE) {
-      double powerValues[FILTER_FREQUENCY_COUNT]; // Copy the current power
+      double powerValues[FILTER_MAX_FREQUENCY_COUNT]; // Copy the current power
                                                   // values to here.
       filter_getCurrentPowerValues(
           powerValues); // Copy the current power values.
@@ -264,8 +275,8 @@ void runningModes_shooter(void) {
   runningModes_initAll();
 
   // Init the ignored-frequencies so no frequencies are ignored.
-  bool ignoredFrequencies[FILTER_FREQUENCY_COUNT];
-  for (uint16_t i = 0; i < FILTER_FREQUENCY_COUNT; i++)
+  bool ignoredFrequencies[FILTER_MAX_FREQUENCY_COUNT];
+  for (uint16_t i = 0; i < filter_getFrequencyCount(); i++)
     ignoredFrequencies[i] = false;
 #ifdef IGNORE_OWN_FREQUENCY
   printf("Ignoring own frequency.\n");
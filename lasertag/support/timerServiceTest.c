@@ -0,0 +1,214 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intervalTimer.h"
+#include "timerService.h"
+
+#define TEST_TIMER_COUNT TIMER_SERVICE_MAX_TIMER_COUNT
+#define ONE_SHOT 0
+#define RANDOM_TEST_TICK_COUNT 200000
+#define RANDOM_TEST_REQUEST_ODDS 50 // One timer request every 50 ticks or so.
+#define RANDOM_TEST_MAX_DELAY 300
+#define RANDOM_TEST_MAX_PERIOD 100
+#define BENCHMARK_TICK_COUNT 10000000
+#define BENCHMARK_TIMER INTERVAL_TIMER_TIMER_1
+#define NANOSECONDS_PER_SECOND 1.0E9
+#define REFERENCE_MACHINE_COUNT 4 // The lockout, hit-LED, reload, invincibility.
+
+static timerService_timer_t testTimers[TEST_TIMER_COUNT];
+static uint32_t fireCounts[TEST_TIMER_COUNT];
+static uint32_t lastFireTick[TEST_TIMER_COUNT];
+
+// The callbacks have no arguments, so each test timer gets its own.
+#define TEST_CALLBACK(n)                                                       \
+  static void testCallback##n(void) {                                          \
+    fireCounts[n]++;                                                           \
+    lastFireTick[n] = timerService_getTickCount();                             \
+  }
+TEST_CALLBACK(0)
+TEST_CALLBACK(1)
+TEST_CALLBACK(2)
+TEST_CALLBACK(3)
+TEST_CALLBACK(4)
+TEST_CALLBACK(5)
+TEST_CALLBACK(6)
+TEST_CALLBACK(7)
+static const timerService_callback_t testCallbacks[TEST_TIMER_COUNT] = {
+    testCallback0, testCallback1, testCallback2, testCallback3,
+    testCallback4, testCallback5, testCallback6, testCallback7};
+
+// Starts the service with every test timer registered and stopped.
+static void resetTimers(void) {
+  timerService_init();
+  for (uint16_t i = 0; i < TEST_TIMER_COUNT; i++)
+    timerService_register(&testTimers[i], testCallbacks[i]);
+  memset(fireCounts, 0, sizeof(fireCounts));
+  memset(lastFireTick, 0, sizeof(lastFireTick));
+}
+
+static void runTicks(uint32_t count) {
+  for (uint32_t i = 0; i < count; i++)
+    timerService_tick();
+}
+
+// Checks a one-shot, a periodic timer, a restart and a cancel against the
+// ticks on which they should expire.
+static bool runBasicTest(void) {
+  bool success = true;
+  resetTimers();
+  timerService_start(&testTimers[0], 5, ONE_SHOT);
+  timerService_start(&testTimers[1], 3, 4);
+  timerService_start(&testTimers[2], 10, ONE_SHOT);
+  timerService_start(&testTimers[3], 8, ONE_SHOT);
+  runTicks(4);
+  success &= timerService_running(&testTimers[0]) && fireCounts[0] == 0;
+  timerService_start(&testTimers[2], 10, ONE_SHOT); // Restarted at tick 4.
+  timerService_cancel(&testTimers[3]);
+  success &= !timerService_running(&testTimers[3]);
+  runTicks(1);
+  // The one-shot expires on its fifth tick and stops.
+  success &= fireCounts[0] == 1 && lastFireTick[0] == 5;
+  success &= !timerService_running(&testTimers[0]);
+  runTicks(15);
+  success &= fireCounts[0] == 1;
+  // The periodic timer expires on ticks 3, 7, 11, 15 and 19.
+  success &= fireCounts[1] == 5 && lastFireTick[1] == 19;
+  success &= timerService_running(&testTimers[1]);
+  success &= fireCounts[2] == 1 && lastFireTick[2] == 14;
+  success &= fireCounts[3] == 0;
+  timerService_cancel(&testTimers[1]);
+  runTicks(10);
+  success &= fireCounts[1] == 5 && !timerService_running(&testTimers[1]);
+  // The ISR applies a start and expires the timer on the same tick; running
+  // is then the ISR's to clear.
+  timerService_start(&testTimers[0], 1, ONE_SHOT);
+  success &= timerService_running(&testTimers[0]);
+  runTicks(1);
+  success &= fireCounts[0] == 2 && !timerService_running(&testTimers[0]);
+  printf("timerService basic test %s\n", success ? "passed" : "failed");
+  return success;
+}
+
+// Posts random starts and cancels and checks every expiration against a
+// linear scan of the deadlines that the requests imply.
+static bool runRandomTest(void) {
+  uint32_t deadline[TEST_TIMER_COUNT];
+  uint32_t period[TEST_TIMER_COUNT];
+  bool armed[TEST_TIMER_COUNT] = {false};
+  uint32_t expectedCounts[TEST_TIMER_COUNT] = {0};
+  uint32_t mismatchCount = 0;
+  uint32_t expirationCount = 0;
+  resetTimers();
+  srand(1);
+  for (uint32_t tick = 1; tick <= RANDOM_TEST_TICK_COUNT; tick++) {
+    if (rand() % RANDOM_TEST_REQUEST_ODDS == 0) {
+      uint16_t i = rand() % TEST_TIMER_COUNT;
+      if (rand() % 4 == 0) {
+        timerService_cancel(&testTimers[i]);
+        armed[i] = false;
+      } else {
+        uint32_t delay = 1 + rand() % RANDOM_TEST_MAX_DELAY;
+        period[i] = (rand() % 2) ? 0 : 1 + rand() % RANDOM_TEST_MAX_PERIOD;
+        timerService_start(&testTimers[i], delay, period[i]);
+        deadline[i] = tick - 1 + delay;
+        armed[i] = true;
+      }
+    }
+    timerService_tick();
+    for (uint16_t i = 0; i < TEST_TIMER_COUNT; i++) {
+      if (armed[i] && deadline[i] == tick) {
+        expectedCounts[i]++;
+        expirationCount++;
+        if (period[i] > 0)
+          deadline[i] += period[i];
+        else
+          armed[i] = false;
+      }
+      if (fireCounts[i] != expectedCounts[i] ||
+          timerService_running(&testTimers[i]) != armed[i]) {
+        mismatchCount++;
+        expectedCounts[i] = fireCounts[i]; // Report each mismatch once.
+      }
+    }
+  }
+  printf("timerService random test %s (%u expirations, %u mismatches)\n",
+         mismatchCount ? "failed" : "passed", expirationCount, mismatchCount);
+  return mismatchCount == 0;
+}
+
+// The per-tick cost of one of the state machines that the service replaced:
+// two switch statements on every tick, even when idle.
+typedef enum { REFERENCE_INIT, REFERENCE_RUNNING, REFERENCE_IDLE } referenceState_t;
+static volatile referenceState_t referenceStates[REFERENCE_MACHINE_COUNT];
+static volatile uint32_t referenceCounters[REFERENCE_MACHINE_COUNT];
+
+static void referenceTick(uint16_t machine) {
+  switch (referenceStates[machine]) {
+  case REFERENCE_RUNNING:
+    if (referenceCounters[machine] == RANDOM_TEST_MAX_DELAY)
+      referenceStates[machine] = REFERENCE_INIT;
+    break;
+  case REFERENCE_INIT:
+    referenceStates[machine] = REFERENCE_IDLE;
+    break;
+  default:
+    break;
+  }
+  switch (referenceStates[machine]) {
+  case REFERENCE_IDLE:
+    referenceCounters[machine] = 0;
+    break;
+  case REFERENCE_RUNNING:
+    referenceCounters[machine]++;
+    break;
+  default:
+    break;
+  }
+}
+
+// Times the idle tick of the four state machines and of the service with
+// every test timer registered and stopped.
+static void runBenchmark(void) {
+  resetTimers();
+  double referenceNanoseconds = 0.0;
+  for (uint16_t pass = 0; pass < 2; pass++) {
+    intervalTimer_init(BENCHMARK_TIMER);
+    intervalTimer_start(BENCHMARK_TIMER);
+    for (uint32_t n = 0; n < BENCHMARK_TICK_COUNT; n++) {
+      if (pass == 0) {
+        for (uint16_t machine = 0; machine < REFERENCE_MACHINE_COUNT; machine++)
+          referenceTick(machine);
+      } else {
+        timerService_tick();
+      }
+    }
+    intervalTimer_stop(BENCHMARK_TIMER);
+    double nanoseconds =
+        intervalTimer_getTotalDurationInSeconds(BENCHMARK_TIMER) *
+        NANOSECONDS_PER_SECOND / BENCHMARK_TICK_COUNT;
+    if (pass == 0)
+      referenceNanoseconds = nanoseconds;
+    printf("%-20s %5.2lf ns per idle tick (%.1fx)\n",
+           pass ? "timer service" : "four state machines", nanoseconds,
+           referenceNanoseconds / nanoseconds);
+  }
+}
+
+// Checks the expirations, then times the idle tick.
+bool timerService_runTest(void) {
+  bool success = runBasicTest();
+  success &= runRandomTest();
+  runBenchmark();
+  return success;
+}
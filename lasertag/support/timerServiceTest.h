@@ -0,0 +1,21 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef TIMERSERVICETEST_H_
+#define TIMERSERVICETEST_H_
+
+#include <stdbool.h>
+
+// Checks one-shot, periodic, restarted and cancelled timers against the ticks
+// on which they should expire, and random deadlines against a linear scan,
+// then times the tick with every timer idle. Returns false if any timer
+// expires on the wrong tick.
+bool timerService_runTest(void);
+
+#endif /* TIMERSERVICETEST_H_ */
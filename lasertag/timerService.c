@@ -0,0 +1,176 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "timerService.h"
+
+#define NOT_IN_HEAP -1
+
+//the registered timers, scanned only when a request is pending
+static timerService_timer_t *timers[TIMER_SERVICE_MAX_TIMER_COUNT];
+static uint16_t timerCount;
+static volatile bool requestPending;
+
+//armed timers, heap[0] has the earliest deadline
+static timerService_timer_t *heap[TIMER_SERVICE_MAX_TIMER_COUNT];
+static uint16_t heapCount;
+static volatile uint32_t tickCount;
+
+//true if deadline a comes before deadline b, across the wrap of the tick count
+static inline bool before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+//moves heap[index] toward the root until its parent is earlier
+static void siftUp(uint16_t index) {
+    timerService_timer_t *timer = heap[index];
+    while (index > 0) {
+        uint16_t parent = (index - 1) / 2;
+        if (!before(timer->deadline, heap[parent]->deadline))
+            break;
+        heap[index] = heap[parent];
+        heap[index]->heapIndex = index;
+        index = parent;
+    }
+    heap[index] = timer;
+    timer->heapIndex = index;
+}
+
+//moves heap[index] toward the leaves until both children are later
+static void siftDown(uint16_t index) {
+    timerService_timer_t *timer = heap[index];
+    while (true) {
+        uint16_t child = 2 * index + 1;
+        if (child >= heapCount)
+            break;
+        if (child + 1 < heapCount &&
+            before(heap[child + 1]->deadline, heap[child]->deadline))
+            child++;
+        if (!before(heap[child]->deadline, timer->deadline))
+            break;
+        heap[index] = heap[child];
+        heap[index]->heapIndex = index;
+        index = child;
+    }
+    heap[index] = timer;
+    timer->heapIndex = index;
+}
+
+static void insert(timerService_timer_t *timer) {
+    heap[heapCount] = timer;
+    siftUp(heapCount++);
+}
+
+static void removeFromHeap(timerService_timer_t *timer) {
+    uint16_t index = timer->heapIndex;
+    timer->heapIndex = NOT_IN_HEAP;
+    if (index == --heapCount)
+        return;
+    //fill the hole with the last timer, which may belong above or below it
+    timerService_timer_t *moved = heap[heapCount];
+    heap[index] = moved;
+    siftUp(index);
+    siftDown(moved->heapIndex);
+}
+
+//applies the starts and cancels posted since the last tick
+static void applyRequests() {
+    requestPending = false;
+    for (uint16_t i = 0; i < timerCount; i++) {
+        timerService_timer_t *timer = timers[i];
+        //running changes before the request is cleared, so that
+        //timerService_running() never sees the timer between the two states
+        if (timer->cancelRequested) {
+            timer->running = false;
+            timer->cancelRequested = false;
+            if (timer->heapIndex != NOT_IN_HEAP)
+                removeFromHeap(timer);
+        }
+        if (timer->startRequested) {
+            timer->running = true;
+            timer->startRequested = false;
+            if (timer->heapIndex != NOT_IN_HEAP)
+                removeFromHeap(timer);
+            //the request arrived since the previous tick, so this tick is the
+            //first one of the delay
+            uint32_t delay = timer->delay > 0 ? timer->delay : 1;
+            timer->deadline = tickCount - 1 + delay;
+            insert(timer);
+        }
+    }
+}
+
+// Clears the tick count and forgets every timer.
+void timerService_init() {
+    timerCount = 0;
+    heapCount = 0;
+    tickCount = 0;
+    requestPending = false;
+}
+
+// Adds a timer to the service, stopped.
+void timerService_register(timerService_timer_t *timer,
+                           timerService_callback_t callback) {
+    if (timerCount == TIMER_SERVICE_MAX_TIMER_COUNT) {
+        printf("timerService_register(): more than %d timers\n",
+               TIMER_SERVICE_MAX_TIMER_COUNT);
+        assert(false);
+        return;
+    }
+    timer->callback = callback;
+    timer->deadline = 0;
+    timer->delay = 0;
+    timer->period = 0;
+    timer->heapIndex = NOT_IN_HEAP;
+    timer->startRequested = false;
+    timer->cancelRequested = false;
+    timer->running = false;
+    timers[timerCount++] = timer;
+}
+
+// Arms the timer, see timerService.h.
+void timerService_start(timerService_timer_t *timer, uint32_t delay,
+                        uint32_t period) {
+    //the request is complete before the ISR is told about it; only the ISR
+    //writes running, when it applies the request
+    timer->delay = delay;
+    timer->period = period;
+    timer->cancelRequested = false;
+    timer->startRequested = true;
+    requestPending = true;
+}
+
+// Stops the timer without running its callback.
+void timerService_cancel(timerService_timer_t *timer) {
+    timer->startRequested = false;
+    timer->cancelRequested = true;
+    requestPending = true;
+}
+
+// Returns true while the timer is armed or a start is pending.
+bool timerService_running(const timerService_timer_t *timer) {
+    return timer->startRequested || (timer->running && !timer->cancelRequested);
+}
+
+// Returns the number of ISR ticks since timerService_init().
+uint32_t timerService_getTickCount() {
+    return tickCount;
+}
+
+// Applies the pending requests and runs the timers that expire on this tick.
+void timerService_tick() {
+    uint32_t now = ++tickCount;
+    if (requestPending)
+        applyRequests();
+    while (heapCount > 0 && !before(now, heap[0]->deadline)) {
+        timerService_timer_t *timer = heap[0];
+        if (timer->period > 0) {
+            timer->deadline += timer->period;
+            siftDown(0);
+        } else {
+            removeFromHeap(timer);
+            timer->running = false;
+        }
+        if (timer->callback != NULL)
+            timer->callback();
+    }
+}
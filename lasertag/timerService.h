@@ -0,0 +1,78 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef TIMERSERVICE_H_
+#define TIMERSERVICE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Software timers driven by the 100 kHz ISR tick. Armed timers are kept in a
+// min-heap keyed on their deadline (an ISR tick count), so timerService_tick()
+// only compares the tick count with the earliest deadline until a timer
+// expires; idle timers cost nothing.
+//
+// timerService_start() and timerService_cancel() may be called from the main
+// loop or from the ISR. They only post a request in the timer, and the ISR
+// applies it on its next tick, so the heap is never touched outside the ISR
+// and no interrupts need to be disabled. Only the ISR writes the running flag
+// of a timer, as it applies a request or the timer expires;
+// timerService_running() also counts the pending requests, so it is true as
+// soon as timerService_start() returns and false as soon as
+// timerService_cancel() returns.
+
+#define TIMER_SERVICE_MAX_TIMER_COUNT 8
+
+// Runs in the ISR when a timer expires.
+typedef void (*timerService_callback_t)(void);
+
+// Owned by the module that registers it; only touch it through the functions
+// below.
+typedef struct {
+  timerService_callback_t callback; // NULL if nothing needs to happen.
+  uint32_t deadline;                // ISR tick count of the next expiration.
+  volatile uint32_t delay;          // Ticks until the first expiration.
+  volatile uint32_t period;         // Ticks between expirations, 0 for once.
+  int16_t heapIndex;                // -1 if the timer is not armed.
+  volatile bool startRequested;
+  volatile bool cancelRequested;
+  volatile bool running;             // Written by the ISR only.
+} timerService_timer_t;
+
+// Clears the tick count and forgets every timer. Call this before the modules
+// register their timers, with the ISR not running.
+void timerService_init();
+
+// Adds a timer to the service, stopped. Call this from an init function, with
+// the ISR not running.
+void timerService_register(timerService_timer_t *timer,
+                           timerService_callback_t callback);
+
+// Arms the timer to expire on the delay-th ISR tick from now (a delay of 0
+// counts as 1) and then every period ticks (0 for a one-shot timer). Restarts
+// the timer if it is already running. Called from a callback, the delay
+// counts from the next tick.
+void timerService_start(timerService_timer_t *timer, uint32_t delay,
+                        uint32_t period);
+
+// Stops the timer without running its callback.
+void timerService_cancel(timerService_timer_t *timer);
+
+// Returns true from timerService_start() until a one-shot timer expires or the
+// timer is cancelled.
+bool timerService_running(const timerService_timer_t *timer);
+
+// Returns the number of ISR ticks since timerService_init().
+uint32_t timerService_getTickCount();
+
+// Call this once per ISR tick: applies the pending requests and runs the
+// callbacks of the timers that expire on this tick.
+void timerService_tick();
+
+#endif /* TIMERSERVICE_H_ */
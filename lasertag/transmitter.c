@@ -88,7 +88,7 @@ void transmitter_tick() {
             //If timer is up, set transmitter state to INIT
             if (timer == tickCountPeriod && !isCurrJedi) { transmitterState = INIT; }
             //If transmitter is at frequency tick count, switch to low state
-            else if (!(timer % (filter_frequencyTickTable[transmittingFrequency] / 2))) {
+            else if (!(timer % (frequencyPlan_getTickPeriod(transmittingFrequency) / 2))) {
                 transmitter_set_jf1_to_zero();
                 transmitterState = TRANSMITTING_LOW;
                 //Debug print
@@ -102,7 +102,7 @@ void transmitter_tick() {
             //If timer is up, set transmitter state to INIT
             if (timer == tickCountPeriod && !isCurrJedi) { transmitterState = INIT; }
             //If transmitter is at frequency tick count, switch to low state
-            else if (!(timer % (filter_frequencyTickTable[transmittingFrequency] / 2))) {
+            else if (!(timer % (frequencyPlan_getTickPeriod(transmittingFrequency) / 2))) {
                 transmitter_set_jf1_to_one();
                 transmitterState = TRANSMITTING_HIGH; 
                 //Debug print
@@ -205,7 +205,7 @@ void transmitter_runTest() {
 
     //Loop until button 3 is pressed
     while (!(buttons_read() & BUTTONS_BTN3_MASK)) {         // Run continuously until BTN3 is pressed.
-            uint16_t switchValue = switches_read() % FILTER_FREQUENCY_COUNT;  // Compute a safe number from the switches.
+            uint16_t switchValue = switches_read() % frequencyPlan_getChannelCount();  // Compute a safe number from the switches.
             transmitter_setFrequencyNumber(switchValue);          // set the frequency number based upon switch value.
             transmitter_run();                                    // Start the transmitter.
             while (transmitter_running()) {                       // Keep ticking until it is done.
@@ -240,7 +240,7 @@ void transmitter_runTestNoncontinuous() {
 
     //Loop until button 3 pressed
     while (!(buttons_read() & BUTTONS_BTN3_MASK)) { 
-        switchesValue = switches_read() % FILTER_FREQUENCY_COUNT; // Read the slide switches and use the numerical value of the switches as the frequency index. When all switches are in the down position (closest to the bottom of the board), you should generate the waveform for frequency 0. Sliding switch (SW0) upward would select frequency 1, and so forth.
+        switchesValue = switches_read() % frequencyPlan_getChannelCount(); // Read the slide switches and use the numerical value of the switches as the frequency index. When all switches are in the down position (closest to the bottom of the board), you should generate the waveform for frequency 0. Sliding switch (SW0) upward would select frequency 1, and so forth.
         transmitter_setFrequencyNumber(switchesValue); // Set the frequency using the transmitter_setFrequencyNumber() function.
         transmitter_run(); //Invoke transmitter_run() and then wait for transmitter_running() to return false.
         
@@ -276,7 +276,7 @@ void transmitter_runTestContinuous() {
 
     // Loop until Button 3 is pressed:
     while (!(buttons_read() & BUTTONS_BTN3_MASK)) {  
-        switchesValue = switches_read() % FILTER_FREQUENCY_COUNT;
+        switchesValue = switches_read() % frequencyPlan_getChannelCount();
         transmitter_setFrequencyNumber(switchesValue); //Set the frequency using the transmitter_setFrequencyNumber() function.
     }
 
@@ -160,6 +160,8 @@ void trigger_tick() {
                 transmitter_run();
                 singleShot = false;
                 if(!isCurrJedi) {shots_remaining--;}
+                //Out of shots, lock out the trigger until the gun reloads
+                if(!isCurrJedi && shots_remaining == 0) {autoReloadTimer_start();}
             }
             //If the held trigger time reaches 3 Seconds, reload the gun
             if(pressTimer == AUTO_RELOAD_TICKS && !isCurrJedi){
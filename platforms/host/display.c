@@ -0,0 +1,99 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Host stand-in for the TFT display. Nothing is drawn; the functions only
+// keep the few pieces of state that callers can read back.
+
+#include "display.h"
+
+static uint8_t rotation = DISPLAY_LANDSCAPE_MODE_ORIGIN_UPPER_LEFT;
+
+void display_init() {}
+void display_drawPixel(int16_t x0, int16_t y0, uint16_t color) {}
+void display_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                      uint16_t color) {}
+void display_drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {}
+void display_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {}
+void display_drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                      uint16_t color) {}
+void display_fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                      uint16_t color) {}
+void display_fillScreen(uint16_t color) {}
+void display_invertDisplay(bool i) {}
+void display_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {}
+void display_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {}
+void display_drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                          int16_t x2, int16_t y2, uint16_t color) {}
+void display_fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                          int16_t x2, int16_t y2, uint16_t color) {}
+void display_drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
+                           int16_t radius, uint16_t color) {}
+void display_fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
+                           int16_t radius, uint16_t color) {}
+void display_drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                        int16_t h, uint16_t color) {}
+void display_drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                      uint16_t bg, uint8_t size) {}
+void display_setCursor(int16_t x, int16_t y) {}
+void display_setTextColor(uint16_t c) {}
+void display_setTextColorBg(uint16_t c, uint16_t bg) {}
+void display_setTextSize(uint8_t s) {}
+void display_setTextWrap(bool w) {}
+void display_setRotation(uint8_t r) { rotation = r; }
+
+int16_t display_height() {
+  return (rotation & 1) ? DISPLAY_HEIGHT : DISPLAY_WIDTH;
+}
+
+int16_t display_width() {
+  return (rotation & 1) ? DISPLAY_WIDTH : DISPLAY_HEIGHT;
+}
+
+uint16_t display_color565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+size_t display_println(const char str[]) { return 0; }
+size_t display_printlnChar(char c) { return 0; }
+size_t display_printlnDecimalInt(int num) { return 0; }
+size_t display_print(const char str[]) { return 0; }
+size_t display_printChar(char c) { return 0; }
+size_t display_printDecimalInt(int num) { return 0; }
+
+unsigned long display_testLines(uint16_t color) { return 0; }
+unsigned long display_testFastLines(uint16_t color1, uint16_t color2) {
+  return 0;
+}
+unsigned long display_testRects(uint16_t color) { return 0; }
+unsigned long display_testFilledRects(uint16_t color1, uint16_t color2) {
+  return 0;
+}
+unsigned long display_testFilledCircles(uint8_t radius, uint16_t color) {
+  return 0;
+}
+unsigned long display_testCircles(uint8_t radius, uint16_t color) { return 0; }
+unsigned long display_testTriangles() { return 0; }
+unsigned long display_testFilledTriangles() { return 0; }
+unsigned long display_testRoundRects() { return 0; }
+unsigned long display_testFilledRoundRects() { return 0; }
+unsigned long display_testFillScreen() { return 0; }
+unsigned long display_testText() { return 0; }
+unsigned long display_test() { return 0; }
+
+bool display_isTouched(void) { return false; }
+
+void display_getTouchedPoint(int16_t *x, int16_t *y, uint8_t *z) {
+  *x = 0;
+  *y = 0;
+  *z = 0;
+}
+
+void display_clearOldTouchData() {}
@@ -0,0 +1,53 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Host stand-in for the LEDs, buttons and slide switches.
+
+#include "buttons.h"
+#include "host.h"
+#include "leds.h"
+#include "switches.h"
+
+static int32_t ledValue;
+static int32_t buttonsValue;
+static int32_t switchesValue;
+
+int32_t leds_init(__attribute__((unused)) bool printFailedStatusFlag) {
+  ledValue = 0;
+  return 0;
+}
+
+void leds_write(int32_t value) { ledValue = value; }
+
+void leds_writeLd4(__attribute__((unused)) int32_t value) {}
+
+int32_t leds_runTest() { return 0; }
+
+// Returns the last value written with leds_write().
+int32_t host_getLeds(void) { return ledValue; }
+
+int32_t buttons_init() { return BUTTONS_INIT_STATUS_OK; }
+
+int32_t buttons_read() { return buttonsValue; }
+
+void buttons_runTest() {}
+
+// Sets the value returned by buttons_read().
+void host_setButtons(int32_t value) { buttonsValue = value; }
+
+int32_t switches_init() { return SWITCHES_INIT_STATUS_OK; }
+
+int32_t switches_read() { return switchesValue; }
+
+void switches_runTest() {}
+
+// Sets the value returned by switches_read().
+void host_setSwitches(int32_t value) { switchesValue = value; }
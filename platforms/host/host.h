@@ -0,0 +1,63 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Controls for the host (x86-64 Linux) build. The files in platforms/host
+// implement mio.h, leds.h, display.h, interrupts.h, intervalTimer.h,
+// buttons.h, switches.h, utils.h and sound.h without any hardware so that the
+// lasertag code can be tested, profiled and benchmarked natively. Nothing is
+// drawn, played or blinked. These functions let host programs provide the
+// inputs that would normally come from the board.
+
+// Number of simulated timer interrupts per second.
+#define HOST_TIMER_TICKS_PER_SECOND 100000
+
+// Function that supplies the value returned by interrupts_getAdcData().
+typedef uint32_t (*host_adcSource_t)(void);
+
+// Installs the function that supplies ADC samples. Pass NULL to go back to
+// the default source, which always returns the mid-scale value.
+void host_setAdcSource(host_adcSource_t source);
+
+// Runs the timer ISR tickCount times, exactly as the private timer interrupt
+// does on the board: isr_function() is called and the invocation count and
+// the cumulative ISR interval timer are updated. Ticks are dropped while the
+// timer is stopped or the ARM interrupts are disabled.
+void host_runTimerTicks(uint32_t tickCount);
+
+// Sets the value returned by buttons_read().
+void host_setButtons(int32_t value);
+
+// Sets the value returned by switches_read().
+void host_setSwitches(int32_t value);
+
+// Sets the value returned by mio_readPin() for an input pin.
+void host_setMioPin(uint8_t mioPinNumber, uint8_t value);
+
+// Returns the last value written to a pin with mio_writePin().
+uint8_t host_getMioPin(uint8_t mioPinNumber);
+
+// Returns the last value written with leds_write().
+int32_t host_getLeds(void);
+
+// Returns the sound most recently selected with sound_setSound() or
+// sound_playSound(), or -1 if no sound has been selected yet.
+int32_t host_getLastSound(void);
+
+// Returns a monotonic time stamp in nanoseconds.
+uint64_t host_getTimeInNanoseconds(void);
+
+#endif /* HOST_H_ */
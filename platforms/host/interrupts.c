@@ -0,0 +1,118 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Host stand-in for the ARM interrupt controller, private timer and XADC.
+// The "timer interrupt" fires only when a host program calls
+// host_runTimerTicks().
+
+#include <stdio.h>
+#include <time.h>
+
+#include "host.h"
+#include "interrupts.h"
+#include "intervalTimer.h"
+
+// Mid-scale for the 12-bit ADC, i.e. no signal.
+#define HOST_ADC_DEFAULT_VALUE 2048
+// The private timer runs at half of the 650 MHz processor clock.
+#define HOST_PRIVATE_TIMER_CLOCK_HZ 325000000
+#define HOST_PRIVATE_TIMER_LOAD_VALUE                                          \
+  (HOST_PRIVATE_TIMER_CLOCK_HZ / HOST_TIMER_TICKS_PER_SECOND - 1)
+#define NANOSECONDS_PER_SECOND 1000000000ULL
+
+volatile int interrupts_isrFlagGlobal = 0;
+
+static bool armIntsEnabled = false;
+static bool timerRunning = false;
+static u32 isrInvocationCount = 0;
+static host_adcSource_t adcSource = NULL;
+static uint64_t lastInterruptNanoseconds = 0;
+
+// Returns a monotonic time stamp in nanoseconds.
+uint64_t host_getTimeInNanoseconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+int interrupts_initAll(__attribute__((unused)) bool printFailedStatusFlag) {
+  armIntsEnabled = false;
+  timerRunning = false;
+  isrInvocationCount = 0;
+  return 0;
+}
+
+void interrupts_setPrivateTimerLoadValue(__attribute__((unused)) u32 loadValue) {
+}
+
+u32 interrupts_getPrivateTimerTicksPerSecond() {
+  return HOST_TIMER_TICKS_PER_SECOND;
+}
+
+int interrupts_enableArmInts() {
+  armIntsEnabled = true;
+  return 0;
+}
+
+int interrupts_disableArmInts() {
+  armIntsEnabled = false;
+  return 0;
+}
+
+int interrupts_startArmPrivateTimer() {
+  timerRunning = true;
+  return 0;
+}
+
+int interrupts_stopArmPrivateTimer() {
+  timerRunning = false;
+  return 0;
+}
+
+u32 interrupts_isrInvocationCount() { return isrInvocationCount; }
+
+void interrupts_enableTimerGlobalInts() {}
+void interrupts_disableTimerGlobalInts() {}
+
+// Emulates the down-counter of the private timer from the monotonic clock so
+// that code timing itself against the timer period sees realistic values. The
+// counter reloads when host_runTimerTicks() raises each simulated interrupt,
+// and then every period of real time, as if the ISR had started on time.
+u32 interrupts_getPrivateTimerCounterValue(void) {
+  uint64_t timerTicks =
+      (host_getTimeInNanoseconds() - lastInterruptNanoseconds) *
+      (HOST_PRIVATE_TIMER_CLOCK_HZ / 1000000) / 1000;
+  return HOST_PRIVATE_TIMER_LOAD_VALUE -
+         (timerTicks % (HOST_PRIVATE_TIMER_LOAD_VALUE + 1));
+}
+
+bool interrupts_getAdcInputMode() { return INTERRUPTS_ADC_DEFAULT_INPUT_MODE; }
+
+uint32_t interrupts_getAdcData() {
+  return adcSource ? adcSource() : HOST_ADC_DEFAULT_VALUE;
+}
+
+// Installs the function that supplies ADC samples.
+void host_setAdcSource(host_adcSource_t source) { adcSource = source; }
+
+// Runs the timer ISR tickCount times, just like timerIsr() on the board.
+void host_runTimerTicks(uint32_t tickCount) {
+  for (uint32_t i = 0; i < tickCount; i++) {
+    if (!(armIntsEnabled && timerRunning))
+      return;
+    intervalTimer_start(INTERRUPT_CUMULATIVE_ISR_INTERVAL_TIMER_NUMBER);
+    lastInterruptNanoseconds = host_getTimeInNanoseconds();
+    isr_function();
+    isrInvocationCount++;
+    interrupts_isrFlagGlobal = 1;
+    intervalTimer_stop(INTERRUPT_CUMULATIVE_ISR_INTERVAL_TIMER_NUMBER);
+  }
+}
@@ -0,0 +1,86 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Host version of the interval timers, backed by the monotonic clock.
+
+#include <stdio.h>
+
+#include "host.h"
+#include "intervalTimer.h"
+
+#define INTERVAL_TIMER_COUNT 3
+#define NANOSECONDS_PER_SECOND 1.0E9
+
+typedef struct {
+  bool running;
+  uint64_t startTime;     // Time stamp of the last intervalTimer_start().
+  uint64_t totalDuration; // Accumulated running time in nanoseconds.
+} intervalTimer_t;
+
+static intervalTimer_t timers[INTERVAL_TIMER_COUNT];
+
+intervalTimer_status_t intervalTimer_init(uint32_t timerNumber) {
+  if (timerNumber >= INTERVAL_TIMER_COUNT)
+    return INTERVAL_TIMER_STATUS_FAIL;
+  intervalTimer_reset(timerNumber);
+  return INTERVAL_TIMER_STATUS_OK;
+}
+
+intervalTimer_status_t intervalTimer_initAll() {
+  for (uint32_t i = 0; i < INTERVAL_TIMER_COUNT; i++)
+    intervalTimer_init(i);
+  return INTERVAL_TIMER_STATUS_OK;
+}
+
+void intervalTimer_start(uint32_t timerNumber) {
+  if (timerNumber >= INTERVAL_TIMER_COUNT || timers[timerNumber].running)
+    return;
+  timers[timerNumber].running = true;
+  timers[timerNumber].startTime = host_getTimeInNanoseconds();
+}
+
+void intervalTimer_stop(uint32_t timerNumber) {
+  if (timerNumber >= INTERVAL_TIMER_COUNT || !timers[timerNumber].running)
+    return;
+  timers[timerNumber].running = false;
+  timers[timerNumber].totalDuration +=
+      host_getTimeInNanoseconds() - timers[timerNumber].startTime;
+}
+
+void intervalTimer_reset(uint32_t timerNumber) {
+  if (timerNumber >= INTERVAL_TIMER_COUNT)
+    return;
+  timers[timerNumber].running = false;
+  timers[timerNumber].totalDuration = 0;
+}
+
+void intervalTimer_resetAll() {
+  for (uint32_t i = 0; i < INTERVAL_TIMER_COUNT; i++)
+    intervalTimer_reset(i);
+}
+
+double intervalTimer_getTotalDurationInSeconds(uint32_t timerNumber) {
+  if (timerNumber >= INTERVAL_TIMER_COUNT)
+    return 0.0;
+  uint64_t duration = timers[timerNumber].totalDuration;
+  if (timers[timerNumber].running)
+    duration += host_getTimeInNanoseconds() - timers[timerNumber].startTime;
+  return duration / NANOSECONDS_PER_SECOND;
+}
+
+intervalTimer_status_t intervalTimer_test(uint32_t timerNumber) {
+  return timerNumber < INTERVAL_TIMER_COUNT ? INTERVAL_TIMER_STATUS_OK
+                                            : INTERVAL_TIMER_STATUS_FAIL;
+}
+
+intervalTimer_status_t intervalTimer_testAll() {
+  return INTERVAL_TIMER_STATUS_OK;
+}
@@ -0,0 +1,52 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Host stand-in for the MIO pins. Written values are remembered so that
+// host programs can observe outputs (transmitter, hit LED) and drive inputs
+// (gun trigger).
+
+#include "host.h"
+#include "mio.h"
+
+#define MIO_PIN_COUNT 54
+
+static u8 pins[MIO_PIN_COUNT];
+
+int32_t mio_init(__attribute__((unused)) bool printFailedStatusFlag) {
+  return 0;
+}
+
+u8 mio_readPin(u8 mioPinNumber) {
+  return mioPinNumber < MIO_PIN_COUNT ? pins[mioPinNumber] : 0;
+}
+
+void mio_writePin(u8 mioPinNumber, u8 value) {
+  if (mioPinNumber < MIO_PIN_COUNT)
+    pins[mioPinNumber] = value;
+}
+
+void mio_WriteBank0(__attribute__((unused)) u32 value) {}
+
+uint16_t mio_readBank0() { return 0; }
+
+void mio_setPinAsInput(__attribute__((unused)) u8 mioPinNo) {}
+
+void mio_setPinAsOutput(__attribute__((unused)) u8 mioPinNo) {}
+
+// Sets the value returned by mio_readPin() for an input pin.
+void host_setMioPin(uint8_t mioPinNumber, uint8_t value) {
+  mio_writePin(mioPinNumber, value);
+}
+
+// Returns the last value written to a pin with mio_writePin().
+uint8_t host_getMioPin(uint8_t mioPinNumber) {
+  return mio_readPin(mioPinNumber);
+}
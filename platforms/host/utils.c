@@ -0,0 +1,52 @@
+/*
+This software is provided for student assignment use in the Department of
+Electrical and Computer Engineering, Brigham Young University, Utah, USA.
+
+Users agree to not re-host, or redistribute the software, in source or binary
+form, to other persons or other institutions. Users may modify and use the
+source code for personal or educational use.
+
+For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
+*/
+
+// Host versions of utils.h and sound.h. Delays return immediately so that
+// tests which wait for the display do not slow down the host build, and
+// sounds "finish" as soon as they are started.
+
+#include <stdio.h>
+
+#include "host.h"
+#include "sound.h"
+#include "utils.h"
+
+static int32_t lastSound = -1;
+
+void utils_msDelay(__attribute__((unused)) long ms) {}
+
+void utils_sleep() {}
+
+sound_status_t sound_init() { return SOUND_STATUS_OK; }
+
+void sound_tick() {}
+
+void sound_playSound(sound_sounds_t sound) {
+  sound_setSound(sound);
+  sound_startSound();
+}
+
+bool sound_isBusy() { return false; }
+
+bool sound_isSoundComplete() { return true; }
+
+void sound_setSound(sound_sounds_t sound) { lastSound = sound; }
+
+void sound_setVolume(__attribute__((unused)) sound_volume_t volume) {}
+
+void sound_startSound() {}
+
+void sound_stopSound() {}
+
+void sound_runTest() {}
+
+// Returns the sound most recently started, or -1 if none.
+int32_t host_getLastSound(void) { return lastSound; }